@@ -0,0 +1,34 @@
+// small random ids (session ids, uuids, nonces). 'sync' and 'async' call
+// randomBytes for every id, 'batch' generates them with randomBytesBatch
+var common = require('../common.js');
+var crypto = require('crypto');
+
+var bench = common.createBenchmark(main, {
+  api: ['sync', 'async', 'batch'],
+  len: [16, 32, 1024],
+  n: [1e5]
+});
+
+function main(conf) {
+  var api = conf.api;
+  var len = +conf.len;
+  var n = +conf.n;
+
+  bench.start();
+  if (api === 'sync') {
+    for (var i = 0; i < n; i++)
+      crypto.randomBytes(len);
+    bench.end(n);
+  } else if (api === 'batch') {
+    for (var i = 0; i < n; i += 1000)
+      crypto.randomBytesBatch(1000, len);
+    bench.end(n);
+  } else {
+    var done = 0;
+    var onBytes = function(err, buf) {
+      if (++done === n) bench.end(n);
+    };
+    for (var i = 0; i < n; i++)
+      crypto.randomBytes(len, onBytes);
+  }
+}
@@ -7,16 +7,18 @@ var fs = require('fs');
 var filesize = 1000 * 1024 * 1024;
 var assert = require('assert');
 
-var type, encoding, size;
+var type, encoding, size, readAhead;
 
 var bench = common.createBenchmark(main, {
   type: ['buf', 'asc', 'utf'],
-  size: [1024, 4096, 65535, 1024*1024]
+  size: [1024, 4096, 65535, 1024*1024],
+  readahead: ['on', 'off']
 });
 
 function main(conf) {
   type = conf.type;
   size = +conf.size;
+  readAhead = conf.readahead === 'on';
 
   switch (type) {
     case 'buf':
@@ -39,9 +41,18 @@ function runTest() {
   assert(fs.statSync(filename).size === filesize);
   var rs = fs.createReadStream(filename, {
     bufferSize: size,
-    encoding: encoding
+    encoding: encoding,
+    readAhead: readAhead
   });
 
+  // the thread pool requests of the stream
+  var reads = 0;
+  var read = fs.read;
+  fs.read = function() {
+    reads++;
+    return read.apply(fs, arguments);
+  };
+
   rs.on('open', function() {
     bench.start();
   });
@@ -53,6 +64,9 @@ function runTest() {
 
   rs.on('end', function() {
     try { fs.unlinkSync(filename); } catch (e) {}
+    fs.read = read;
+    console.error('%d fs.read calls, %d KB per call', reads,
+                  Math.round(bytes / reads / 1024));
     // MB/sec
     bench.end(bytes / (1024 * 1024));
   });
@@ -0,0 +1,47 @@
+var common = require('../common.js');
+var PORT = common.PORT;
+
+// compares the plain http_simple server with the one wrapping every request
+// in a domain, the way the error handling middlewares do
+var bench = common.createBenchmark(main, {
+  domain: ['none', 'loaded', 'request'],
+  length: [1024],
+  c: [50, 500]
+});
+
+function main(conf) {
+  process.env.PORT = PORT;
+
+  if (conf.domain !== 'none') {
+    var domain = require('domain');
+    var http = require('http');
+
+    if (conf.domain === 'request') {
+      var createServer = http.createServer;
+      http.createServer = function(handler) {
+        return createServer.call(http, function(req, res) {
+          var d = domain.create();
+          d.add(req);
+          d.add(res);
+          d.on('error', function(err) {
+            res.writeHead(500);
+            res.end(err.message);
+          });
+          d.run(function() {
+            handler(req, res);
+          });
+        });
+      };
+    }
+  }
+
+  var server = require('../http_simple.js');
+  setTimeout(function() {
+    var path = '/bytes/' + conf.length;
+    var args = ['-r', 5000, '-t', 8, '-c', conf.c];
+
+    bench.http(path, args, function() {
+      server.close();
+    });
+  }, 2000);
+}
@@ -0,0 +1,70 @@
+// p99 latency (ms) of the requests that arrive in bursts. The server leaves
+// garbage behind for every request and the loop is idle between the bursts,
+// with a budget the engine collects there instead of in the next burst
+var common = require('../common.js');
+var http = require('http');
+
+var bench = common.createBenchmark(main, {
+  budget: [0, 5],
+  burst: [50],
+  bursts: [200],
+  gap: [50]
+});
+
+function main(conf) {
+  var size = +conf.burst;
+  var latencies = [];
+
+  process.idleGC(+conf.budget);
+  var agent = new http.Agent({ keepAlive: true, maxSockets: size });
+  var options = {
+    agent: agent,
+    host: '127.0.0.1',
+    port: common.PORT,
+    path: '/'
+  };
+
+  var server = http.createServer(function(req, res) {
+    var rows = [];
+    for (var i = 0; i < 2000; i++)
+      rows.push({ id: i, name: 'row ' + i });
+    res.end(JSON.stringify(rows).length + '\n');
+  });
+  server.listen(options.port, options.host, function() {
+    burst(+conf.bursts);
+  });
+
+  function burst(left) {
+    if (left === 0)
+      return done();
+
+    var pending = size;
+    for (var i = 0; i < size; i++) {
+      request(function() {
+        if (--pending === 0)
+          setTimeout(burst, +conf.gap, left - 1);
+      });
+    }
+  }
+
+  function request(cb) {
+    var start = process.hrtime();
+    http.get(options, function(res) {
+      res.on('end', function() {
+        var time = process.hrtime(start);
+        latencies.push(time[0] * 1e3 + time[1] / 1e6);
+        cb();
+      });
+      res.resume();
+    });
+  }
+
+  function done() {
+    latencies.sort(function(a, b) {
+      return a - b;
+    });
+    agent.destroy();
+    server.close();
+    bench.report(latencies[Math.floor(latencies.length * 0.99)]);
+  }
+}
@@ -0,0 +1,58 @@
+// Sequential requests over loopback. Every client sends its next request
+// once the previous response has ended, so without keepAlive each request
+// opens a new connection, with it the request takes the pooled socket.
+
+var common = require('../common.js');
+var http = require('http');
+
+var bench = common.createBenchmark(main, {
+  dur: [5],
+  keepAlive: ['true', 'false'],
+  clients: [1, 8]
+});
+
+function main(conf) {
+  var dur = +conf.dur;
+  var clients = +conf.clients;
+  var nreqs = 0;
+  var running = true;
+
+  var agent = new http.Agent({
+    keepAlive: conf.keepAlive === 'true',
+    maxSockets: clients
+  });
+  var options = {
+    agent: agent,
+    host: '127.0.0.1',
+    port: common.PORT,
+    path: '/'
+  };
+
+  var server = http.createServer(function(req, res) {
+    res.end('ok');
+  });
+  server.listen(options.port, options.host, function() {
+    setTimeout(done, dur * 1000);
+    bench.start();
+    for (var i = 0; i < clients; i++)
+      next();
+  });
+
+  function next() {
+    if (!running) return;
+    http.get(options, function(res) {
+      res.on('end', function() {
+        nreqs++;
+        next();
+      });
+      res.resume();
+    });
+  }
+
+  function done() {
+    running = false;
+    bench.end(nreqs);
+    agent.destroy();
+    server.close();
+  }
+}
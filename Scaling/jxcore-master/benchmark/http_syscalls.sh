@@ -0,0 +1,34 @@
+#!/bin/bash
+# counts the epoll / socket syscalls per request of a keep-alive http load
+# against loopback. linux only, needs strace and ab.
+#   NODE=./jx TYPE=bytes LENGTH=1024 REQUESTS=100000 benchmark/http_syscalls.sh
+cd "$(dirname "$(dirname $0)")"
+
+node=${NODE:-./node}
+requests=${REQUESTS:-100000}
+out=$(mktemp)
+
+strace -f -c -o $out \
+  -e trace=epoll_ctl,epoll_wait,read,write,writev,recvfrom,sendto \
+  $node benchmark/http_simple.js &
+spid=$!
+
+sleep 2
+
+ab -k -n $requests -c ${CONCURRENCY:-50} \
+  http://127.0.0.1:8000/${TYPE:-bytes}/${LENGTH:-1024} 2>&1 | grep "Requests per"
+
+# strace writes the summary once the traced process exits
+pkill -INT -P $spid
+wait $spid
+
+awk -v n=$requests '
+  $NF ~ /^(epoll_ctl|epoll_wait|read|write|writev|recvfrom|sendto)$/ {
+    calls = $4
+    printf "%-12s %10d calls %8.3f per request\n", $NF, calls, calls / n
+    total += calls
+  }
+  END { printf "%-12s %10d calls %8.3f per request\n", "total", total, total / n }
+' $out
+
+rm -f $out
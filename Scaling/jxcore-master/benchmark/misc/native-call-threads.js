@@ -0,0 +1,42 @@
+// native call overhead with 1 to 63 busy threads. every thread calls a cheap
+// native method (jxcore.store.exists) in a tight loop, the result is the
+// total number of calls per second. on SpiderMonkey builds every native
+// call looks up the commons instance of the current thread
+var common = require('../common.js');
+var bench = common.createBenchmark(main, {
+  threads: [1, 4, 16, 63],
+  n: [1e6]
+});
+
+function caller(n) {
+  var store = jxcore.store;
+  var start = process.hrtime();
+  for (var i = 0; i < n; i++)
+    store.exists('native-call');
+  var t = process.hrtime(start);
+  return t[0] * 1e3 + t[1] / 1e6;
+}
+
+function main(conf) {
+  var threads = +conf.threads;
+  var n = +conf.n;
+  var tasks = jxcore.tasks;
+  var done = 0;
+
+  tasks.setThreadCount(Math.max(threads, 2));
+
+  // warm up the threads so the thread creation isn't measured
+  tasks.runOnce(function() {}, null, true);
+
+  setTimeout(function() {
+    bench.start();
+    for (var i = 0; i < threads; i++) {
+      tasks.addTask(caller, n, function(err) {
+        if (++done === threads) {
+          bench.end(n * threads / 1e6);
+          process.exit(0);
+        }
+      });
+    }
+  }, 500);
+}
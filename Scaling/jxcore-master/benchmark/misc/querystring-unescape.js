@@ -0,0 +1,25 @@
+// querystring.unescape on plain, escaped and malformed (fallback) input
+var common = require('../common.js');
+var querystring = require('querystring');
+
+var bench = common.createBenchmark(main, {
+  type: ['plain', 'escaped', 'malformed'],
+  n: [1e6]
+});
+
+var inputs = {
+  plain: 'just+some+plain+text',
+  escaped: encodeURIComponent('some é/€ text with & and = inside'),
+  malformed: '100%+sure%2that%E2%82+it+works'
+};
+
+function main(conf) {
+  var input = inputs[conf.type];
+  var n = +conf.n;
+
+  bench.start();
+  for (var i = 0; i < n; i++) {
+    querystring.unescape(input, true);
+  }
+  bench.end(n);
+}
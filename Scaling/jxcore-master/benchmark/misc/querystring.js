@@ -0,0 +1,40 @@
+// querystring.parse on a short url query, a typical form and a large
+// urlencoded POST body (as a string and as a Buffer)
+var common = require('../common.js');
+var querystring = require('querystring');
+
+var bench = common.createBenchmark(main, {
+  type: ['query', 'form', 'post', 'post-buffer'],
+  n: [1e5]
+});
+
+function makeBody(fields) {
+  var parts = [];
+  for (var i = 0; i < fields; i++) {
+    parts.push('field' + i + '=' +
+               encodeURIComponent('value ' + i + ' é/€ & more text') +
+               '+with+spaces');
+  }
+  return parts.join('&');
+}
+
+var inputs = {
+  query: 'q=jxcore&page=2&sort=desc',
+  form: makeBody(12),
+  post: makeBody(800)
+};
+inputs['post-buffer'] = new Buffer(inputs.post);
+
+function main(conf) {
+  var input = inputs[conf.type];
+  var n = +conf.n;
+  // keep the large bodies in a sane time frame
+  if (conf.type.indexOf('post') === 0) n = n / 100;
+
+  var options = { maxKeys: 0 };
+  bench.start();
+  for (var i = 0; i < n; i++) {
+    querystring.parse(input, null, null, options);
+  }
+  bench.end(n);
+}
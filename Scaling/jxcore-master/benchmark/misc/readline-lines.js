@@ -0,0 +1,42 @@
+// readline 'line' events for short log lines and lines much longer than the
+// chunks they arrive in
+var common = require('../common.js');
+var readline = require('readline');
+var EventEmitter = require('events').EventEmitter;
+
+var bench = common.createBenchmark(main, {
+  line: [80, 64 * 1024],
+  ending: ['\n', '\r\n'],
+  chunk: [4096],
+  n: [64 * 1024 * 1024]
+});
+
+function main(conf) {
+  var lineLength = +conf.line;
+  var line = new Array(lineLength + 1).join('x') + conf.ending;
+  var text = new Array(Math.ceil(conf.chunk * 4 / line.length) + 1).join(line);
+  var buffer = new Buffer(text);
+
+  var chunks = [];
+  for (var pos = 0; pos < buffer.length; pos += +conf.chunk)
+    chunks.push(buffer.slice(pos, pos + +conf.chunk));
+
+  var input = new EventEmitter();
+  input.resume = input.pause = function() {};
+  var rl = readline.createInterface({ input: input, terminal: false });
+  var lines = 0;
+  rl.on('line', function() {
+    lines++;
+  });
+
+  // n is the number of bytes
+  var total = 0, i = 0;
+  bench.start();
+  while (total < +conf.n) {
+    var chunk = chunks[i++ % chunks.length];
+    input.emit('data', chunk);
+    total += chunk.length;
+  }
+  bench.end(total / (1024 * 1024));
+  rl.close();
+}
@@ -1,12 +1,21 @@
 var common = require('../common.js');
 var bench = common.createBenchmark(main, {
-  thousands: [1]
+  thousands: [1],
+  rss: [0, 1024]
 });
 
 var spawn = require('child_process').spawn;
+var ballast = [];
 function main(conf) {
   var len = +conf.thousands * 1000;
 
+  // rss MB of touched memory, fork() copied its page tables for every child
+  for (var mb = 0; mb < +conf.rss; mb++) {
+    var chunk = new Buffer(1024 * 1024);
+    chunk.fill(1);
+    ballast.push(chunk);
+  }
+
   bench.start();
   go(len, len);
 }
@@ -0,0 +1,45 @@
+// StringDecoder.write on ASCII and mixed-width text (1 to 4 byte characters)
+// split at random chunk boundaries
+var common = require('../common.js');
+var StringDecoder = require('string_decoder').StringDecoder;
+
+var bench = common.createBenchmark(main, {
+  encoding: ['utf8', 'ucs2', 'base64'],
+  text: ['ascii', 'mixed'],
+  chunk: [16, 1024, 65536],
+  n: [25e4]
+});
+
+function makeText(mixed) {
+  var words = mixed ? ['jxcore', 'çağrı', 'Привет', '€uro', '日本語', '😀🚀']
+                    : ['jxcore', 'stream', 'decoder', 'chunk', 'text', 'io'];
+  var parts = [];
+  for (var i = 0; i < 20000; i++) parts.push(words[i % words.length]);
+  return parts.join(' ');
+}
+
+// the same random boundaries for every run
+function split(buffer, chunk) {
+  var chunks = [], pos = 0, seed = 1;
+  while (pos < buffer.length) {
+    seed = (seed * 16807) % 2147483647;
+    var size = 1 + seed % (chunk * 2);
+    chunks.push(buffer.slice(pos, pos + size));
+    pos += size;
+  }
+  return chunks;
+}
+
+function main(conf) {
+  var chunks = split(new Buffer(makeText(conf.text === 'mixed'), conf.encoding),
+                     +conf.chunk);
+  var n = +conf.n;
+  var decoder = new StringDecoder(conf.encoding);
+
+  bench.start();
+  for (var i = 0; i < n; i++) {
+    decoder.write(chunks[i % chunks.length]);
+  }
+  decoder.end();
+  bench.end(n);
+}
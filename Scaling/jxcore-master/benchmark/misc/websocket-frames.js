@@ -0,0 +1,45 @@
+// The native WebSocket codec parsing the masked frames of a client, the
+// small messages are read from the chunks, the larger ones are split by
+// them and reassembled
+var common = require('../common.js');
+var crypto = require('crypto');
+var ws = process.binding('websocket_wrap');
+
+var bench = common.createBenchmark(main, {
+  message: [100, 64 * 1024],
+  chunk: [64 * 1024],
+  n: [256 * 1024 * 1024]
+});
+
+function main(conf) {
+  var client = new ws.FrameCodec(false);
+  var payload = crypto.randomBytes(+conf.message);
+  var frames = [];
+  var length = 0;
+  while (length < conf.chunk * 4) {
+    var frame = client.encode(ws.WS_OPCODE_BINARY, payload, true,
+                              crypto.randomBytes(4));
+    frames.push(frame);
+    length += frame.length;
+  }
+  var stream = Buffer.concat(frames);
+
+  var server = new ws.FrameCodec(true);
+  var messages = 0;
+
+  // n is the number of bytes, the stream is parsed from its first frame
+  var total = 0;
+  bench.start();
+  while (total < +conf.n) {
+    for (var pos = 0; pos < stream.length; pos += +conf.chunk) {
+      var end = Math.min(pos + +conf.chunk, stream.length);
+      // unmasking the chunk again masks it back
+      messages += server.execute(stream, pos, end).length / 3;
+    }
+    total += stream.length;
+  }
+  bench.end(total / (1024 * 1024));
+
+  if (messages !== frames.length * (total / stream.length))
+    throw new Error('lost messages');
+}
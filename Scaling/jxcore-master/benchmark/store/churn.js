@@ -0,0 +1,49 @@
+// long running set / overwrite / remove churn with random value sizes.
+// reports kilo operations per second. the allocator fragmentation at the
+// end of the run goes to stderr so the result line stays parseable
+var common = require('../common.js');
+var bench = common.createBenchmark(main, {
+  store: ['local', 'shared'],
+  maxSize: [64, 1024, 8192],
+  keys: [1e4],
+  rounds: [50]
+});
+
+function main(conf) {
+  var store = conf.store === 'shared' ? jxcore.store.shared : jxcore.store;
+  var n = +conf.keys;
+  var rounds = +conf.rounds;
+  var maxSize = +conf.maxSize;
+  var filler = new Array(maxSize + 1).join('v');
+
+  // pre-generate the values so the benchmark measures the store only
+  var values = new Array(256);
+  for (var i = 0; i < values.length; i++)
+    values[i] = filler.substr(0, 1 + Math.floor(Math.random() * maxSize));
+
+  var keys = new Array(n);
+  for (var i = 0; i < n; i++)
+    keys[i] = 'churn:' + i;
+
+  var ops = 0;
+  var v = 0;
+  bench.start();
+  for (var r = 0; r < rounds; r++) {
+    for (var i = 0; i < n; i++, ops++)
+      store.set(keys[i], values[v++ & 255]);
+    // every third key is removed, the rest is overwritten with a new size
+    for (var i = 0; i < n; i += 3, ops++)
+      store.remove(keys[i]);
+    for (var i = 1; i < n; i += 3, ops++)
+      store.set(keys[i], values[v++ & 255]);
+  }
+  bench.end(ops / 1e3);
+
+  var usage = jxcore.store.allocatorUsage();
+  console.error('fragmentation: %d%% reserved: %d reuses: %d',
+                Math.round(usage.fragmentation * 100), usage.reserved,
+                usage.reuses);
+
+  for (var i = 0; i < n; i++)
+    store.remove(keys[i]);
+}
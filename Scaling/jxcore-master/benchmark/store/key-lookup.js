@@ -0,0 +1,54 @@
+// jxcore.store / jxcore.store.shared set and read with the key sets the
+// stores usually hold. uuid keys differ from the first byte, session keys
+// share their namespace and the btree nodes tell them apart by the bytes
+// after it
+var common = require('../common.js');
+var bench = common.createBenchmark(main, {
+  store: ['local', 'shared'],
+  keys: ['uuid', 'session', 'nested'],
+  n: [1e5, 1e6]
+});
+
+function hex(length) {
+  var str = '';
+  while (str.length < length)
+    str += Math.floor(Math.random() * 0x100000000).toString(16);
+  return str.substr(0, length);
+}
+
+var generators = {
+  uuid: function() {
+    return hex(8) + '-' + hex(4) + '-4' + hex(3) + '-' + hex(4) + '-' +
+           hex(12);
+  },
+  session: function() {
+    return 'session:' + hex(24);
+  },
+  nested: function(i) {
+    return 'user:' + (i % 1000) + ':cart:' + hex(8);
+  }
+};
+
+function main(conf) {
+  var store = conf.store === 'shared' ? jxcore.store.shared : jxcore.store;
+  var n = +conf.n;
+  var generate = generators[conf.keys];
+  var keys = new Array(n);
+  var order = new Array(n);
+
+  for (var i = 0; i < n; i++) {
+    keys[i] = generate(i);
+    // reads don't follow the insertion order
+    order[i] = (i * 7919) % n;
+  }
+
+  bench.start();
+  for (var i = 0; i < n; i++)
+    store.set(keys[i], 'v');
+  for (var i = 0; i < n; i++)
+    store.read(keys[order[i]]);
+  bench.end(n * 2 / 1e3);
+
+  for (var i = 0; i < n; i++)
+    store.remove(keys[i]);
+}
@@ -0,0 +1,31 @@
+// measures jxcore.store / jxcore.store.shared throughput. run it with
+// sampling=0 against an older build to see the cost of the byte counters,
+// sampling=1/64 shows the cost of the key prefix histogram on top of it
+var common = require('../common.js');
+var bench = common.createBenchmark(main, {
+  store: ['local', 'shared'],
+  sampling: [0, 1, 64],
+  keys: [1e5]
+});
+
+function main(conf) {
+  var store = conf.store === 'shared' ? jxcore.store.shared : jxcore.store;
+  var n = +conf.keys;
+  var value = new Array(65).join('v');
+  var prefixes = ['session:', 'user:', 'cache/'];
+  var keys = new Array(n);
+
+  for (var i = 0; i < n; i++)
+    keys[i] = prefixes[i % prefixes.length] + i;
+
+  store.setKeySampling(+conf.sampling);
+
+  bench.start();
+  for (var i = 0; i < n; i++)
+    store.set(keys[i], value);
+  for (var i = 0; i < n; i++)
+    store.read(keys[i]);
+  for (var i = 0; i < n; i++)
+    store.remove(keys[i]);
+  bench.end(n * 3 / 1e3);
+}
@@ -0,0 +1,91 @@
+// fan-out from the main thread to N sub threads. 'burst' measures the
+// throughput (messages published per second until every listener got them
+// all), 'pingpong' waits for the replies of every listener before the next
+// message so the result is 1 / round trip latency.
+// compare publish (only the listening threads are woken up) with
+// sendToThreads (every thread gets a copy)
+var common = require('../common.js');
+var bench = common.createBenchmark(main, {
+  method: ['publish', 'sendToThreads'],
+  mode: ['burst', 'pingpong'],
+  threads: [4, 16],
+  listeners: [1, 4, 16],
+  n: [2e4]
+});
+
+function listener(conf) {
+  if (process.threadId >= conf.listeners) return;
+
+  var got = 0;
+  var onMessage = function(msg) {
+    if (!msg || msg.seq === undefined) return;
+    got++;
+    if (conf.mode === 'pingpong' || got === conf.n)
+      process.sendToMain({ threadId: process.threadId, got: got });
+  };
+
+  if (conf.method === 'publish') {
+    jxcore.tasks.subscribe('bench', onMessage);
+  } else {
+    jxcore.tasks.on('message', function(tid, msg) {
+      onMessage(msg);
+    });
+  }
+
+  process.sendToMain({ ready: true });
+  process.keepAlive();
+}
+
+function main(conf) {
+  var threads = +conf.threads;
+  var listeners = Math.min(+conf.listeners, threads);
+  var n = +conf.n;
+  var tasks = jxcore.tasks;
+
+  var params = {
+    method: conf.method,
+    mode: conf.mode,
+    listeners: listeners,
+    n: n
+  };
+
+  var send = conf.method === 'publish' ? function(msg) {
+    tasks.publish('bench', msg);
+  } : function(msg) {
+    process.sendToThreads(msg);
+  };
+
+  var ready = 0;
+  var replies = 0;
+  var seq = 0;
+
+  tasks.setThreadCount(threads);
+  tasks.on('message', function(tid, msg) {
+    if (msg.ready) {
+      if (++ready === listeners) start();
+      return;
+    }
+
+    replies++;
+    if (conf.mode === 'pingpong') {
+      if (replies % listeners !== 0) return;
+      if (seq < n) return send({ seq: seq++ });
+    } else if (replies !== listeners) {
+      return;
+    }
+
+    bench.end(n / 1e3);
+    process.exit(0);
+  });
+
+  tasks.runOnce(listener, params);
+
+  function start() {
+    bench.start();
+    if (conf.mode === 'pingpong')
+      return send({ seq: seq++ });
+
+    while (seq < n)
+      send({ seq: seq++ });
+  }
+}
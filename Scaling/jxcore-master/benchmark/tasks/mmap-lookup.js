@@ -0,0 +1,61 @@
+// random lookups into a large table file from N sub threads. 'read' loads a
+// copy of the file into every thread with fs.readFileSync, 'mmap' maps it
+// with fs.mmapSync (one mapping for the process). the time includes loading
+// the table, the result is lookups per second
+var common = require('../common.js');
+var fs = require('fs');
+var path = require('path');
+
+var bench = common.createBenchmark(main, {
+  api: ['read', 'mmap'],
+  size: [16, 128],  // MB
+  threads: [1, 4, 16],
+  n: [1e6]
+});
+
+function lookup(conf) {
+  var fs = require('fs');
+  var table = conf.api === 'mmap' ?
+      fs.mmapSync(conf.file, { advice: 'random' }) :
+      fs.readFileSync(conf.file);
+
+  var sum = 0;
+  var seed = process.threadId + 1;
+  var last = table.length - 8;
+  for (var i = 0; i < conf.n; i++) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    sum += table.readUInt32LE(seed % last);
+  }
+
+  process.sendToMain({ sum: sum });
+}
+
+function main(conf) {
+  var threads = +conf.threads;
+  var n = +conf.n;
+  var file = path.join(__dirname, '.mmap-lookup-' + conf.size + '.bin');
+
+  var chunk = new Buffer(1024 * 1024);
+  var fd = fs.openSync(file, 'w');
+  for (var i = 0; i < conf.size; i++) {
+    for (var j = 0; j < chunk.length; j++)
+      chunk[j] = (i + j * 31) & 0xff;
+    fs.writeSync(fd, chunk, 0, chunk.length, null);
+  }
+  fs.closeSync(fd);
+
+  var tasks = jxcore.tasks;
+  var done = 0;
+
+  tasks.setThreadCount(threads);
+  tasks.on('message', function(tid, msg) {
+    if (++done !== threads) return;
+
+    bench.end(n * threads);
+    fs.unlinkSync(file);
+    process.exit(0);
+  });
+
+  bench.start();
+  tasks.runOnce(lookup, { api: conf.api, file: file, n: n });
+}
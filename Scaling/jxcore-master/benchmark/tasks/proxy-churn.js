@@ -0,0 +1,82 @@
+// streaming proxies on N sub threads. every thread pipes a client through a
+// proxy to a sink, the chunks are large Buffers so the SlowBuffer memory is
+// allocated and released on every thread all the time (and the ones freed on
+// another thread go back to their owner). the result is the throughput of
+// all the threads in Gbits/sec
+var common = require('../common.js');
+var bench = common.createBenchmark(main, {
+  chunk: [64 * 1024, 256 * 1024],
+  threads: [1, 4, 16],
+  dur: [5]
+});
+
+function proxy(conf) {
+  var net = require('net');
+  var port = conf.port + process.threadId * 2;
+  var received = 0;
+
+  var sink = net.createServer(function(socket) {
+    socket.on('data', function(data) {
+      received += data.length;
+    });
+  });
+
+  var server = net.createServer(function(socket) {
+    var upstream = net.connect(port + 1);
+    socket.pipe(upstream);
+    upstream.pipe(socket);
+  });
+
+  sink.listen(port + 1, function() {
+    server.listen(port, function() {
+      var client = net.connect(port, function() {
+        process.sendToMain({ ready: true });
+      });
+      var running = true;
+
+      var write = function() {
+        // a new Buffer for every write, nothing is reused by the script
+        while (running && client.write(new Buffer(conf.chunk)));
+      };
+      client.on('drain', write);
+
+      jxcore.tasks.on('message', function(tid, msg) {
+        if (msg.start) return write();
+        if (!msg.stop) return;
+        running = false;
+        process.sendToMain({ bytes: received });
+      });
+    });
+  });
+
+  process.keepAlive();
+}
+
+function main(conf) {
+  var threads = +conf.threads;
+  var tasks = jxcore.tasks;
+  var ready = 0;
+  var done = 0;
+  var bytes = 0;
+
+  tasks.setThreadCount(threads);
+  tasks.on('message', function(tid, msg) {
+    if (msg.ready) {
+      if (++ready !== threads) return;
+      bench.start();
+      process.sendToThreads({ start: true });
+      setTimeout(function() {
+        process.sendToThreads({ stop: true });
+      }, conf.dur * 1000);
+      return;
+    }
+
+    bytes += msg.bytes;
+    if (++done !== threads) return;
+
+    bench.end(bytes * 8 / 1e9);
+    process.exit(0);
+  });
+
+  tasks.runOnce(proxy, { port: common.PORT, chunk: +conf.chunk });
+}
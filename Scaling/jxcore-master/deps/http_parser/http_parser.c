@@ -29,6 +29,15 @@
 #include <string.h>
 #include <limits.h>
 
+/* The range scans below use the widest of these the compiler targets */
+#if defined(__GNUC__) && \
+    (defined(__AVX2__) || defined(__SSE4_2__) || defined(__SSE2__))
+# define HTTP_PARSER_SIMD 1
+# include <immintrin.h>
+#else
+# define HTTP_PARSER_SIMD 0
+#endif
+
 #ifndef ULLONG_MAX
 # define ULLONG_MAX ((uint64_t) -1) /* 2^64-1 */
 #endif
@@ -406,6 +415,124 @@ do {                                                                 \
 #endif
 
 
+#if HTTP_PARSER_SIMD
+/* Range scans for the states that only wait for a delimiter (a header value,
+ * a header field without a special meaning and the path, query string and
+ * fragment of a URL).
+ *
+ * scan_ranges() returns the first byte in [p, end) that falls into one of
+ * the count ranges (inclusive lo, hi pairs), looking at 32 (AVX2) or 16
+ * (SSE4.2, SSE2) bytes at once. It stops at the last bytes that don't fill
+ * a stride, these and the byte it found are left to the state machine, hence
+ * the ranges may cover more than the delimiters of the state.
+ */
+static const char header_value_ranges[16] = {
+  '\r', '\r', '\n', '\n'
+};
+#define HEADER_VALUE_RANGES 2
+
+/* every byte that isn't a token char, see tokens[] */
+static const char header_field_ranges[16] = {
+  0x00, 0x20, '"', '"', '(', ')', ',', ',', '/', '/', ':', '@', '[', ']',
+  '{', (char) 0xff
+};
+#define HEADER_FIELD_RANGES 8
+
+/* the delimiters and the bytes that aren't URL chars in s_req_path,
+ * s_req_query_string and s_req_fragment, see normal_url_char */
+static const char url_ranges[16] = {
+#if HTTP_PARSER_STRICT
+  0x00, 0x20, '#', '#', '?', '?', 0x7f, (char) 0xff
+#else
+  0x00, 0x20, '#', '#', '?', '?', 0x7f, 0x7f
+#endif
+};
+#define URL_RANGES 4
+
+static const char *
+scan_ranges(const char *p, const char *end, const char *ranges, int count)
+{
+  int i;
+
+#if defined(__AVX2__)
+  for (; end - p >= 32; p += 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *) p);
+    __m256i hit = _mm256_setzero_si256();
+    unsigned int mask;
+
+    /* v - lo <= hi - lo, unsigned */
+    for (i = 0; i < count; i++) {
+      const __m256i d = _mm256_sub_epi8(v, _mm256_set1_epi8(ranges[2 * i]));
+      const __m256i w =
+        _mm256_set1_epi8((char) (ranges[2 * i + 1] - ranges[2 * i]));
+      hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(_mm256_min_epu8(d, w), d));
+    }
+
+    mask = (unsigned int) _mm256_movemask_epi8(hit);
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+  }
+#endif
+
+#if defined(__SSE4_2__)
+  {
+    const __m128i r = _mm_loadu_si128((const __m128i *) ranges);
+
+    for (; end - p >= 16; p += 16) {
+      i = _mm_cmpestri(r, 2 * count, _mm_loadu_si128((const __m128i *) p), 16,
+                       _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES |
+                       _SIDD_LEAST_SIGNIFICANT);
+      if (i != 16) {
+        return p + i;
+      }
+    }
+  }
+#else
+  for (; end - p >= 16; p += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i *) p);
+    __m128i hit = _mm_setzero_si128();
+    unsigned int mask;
+
+    for (i = 0; i < count; i++) {
+      const __m128i d = _mm_sub_epi8(v, _mm_set1_epi8(ranges[2 * i]));
+      const __m128i w =
+        _mm_set1_epi8((char) (ranges[2 * i + 1] - ranges[2 * i]));
+      hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(d, w), d));
+    }
+
+    mask = (unsigned int) _mm_movemask_epi8(hit);
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+  }
+#endif
+
+  return p;
+}
+
+/* Skips the bytes up to the next one in the ranges and resumes the state
+ * machine there. The scan doesn't go past the header size limit, the byte
+ * that exceeds it is still reported by the loop.
+ */
+# define SCAN_TO(ranges, count)                                      \
+do {                                                                 \
+  const char *scan_end = data + len;                                 \
+  const char *scan_p;                                                \
+  if ((size_t) (scan_end - (p + 1)) >                                \
+      (size_t) (HTTP_MAX_HEADER_SIZE - parser->nread)) {             \
+    scan_end = p + 1 + (HTTP_MAX_HEADER_SIZE - parser->nread);       \
+  }                                                                  \
+  scan_p = scan_ranges(p + 1, scan_end, (ranges), (count));          \
+  parser->nread += scan_p - (p + 1);                                 \
+  p = scan_p - 1;                                                    \
+} while (0)
+#else
+/* byte by byte */
+# define SCAN_TO(ranges, count)
+#endif
+
+
 /* Map errno values to strings for human-readable output */
 #define HTTP_STRERROR_GEN(n, s) { "HPE_" #n, s },
 static struct {
@@ -1069,6 +1196,12 @@ size_t http_parser_execute (http_parser *parser,
               SET_ERRNO(HPE_INVALID_URL);
               goto error;
             }
+
+            if (parser->state == s_req_path ||
+                parser->state == s_req_query_string ||
+                parser->state == s_req_fragment) {
+              SCAN_TO(url_ranges, URL_RANGES);
+            }
         }
         break;
       }
@@ -1252,6 +1385,7 @@ size_t http_parser_execute (http_parser *parser,
         if (c) {
           switch (parser->header_state) {
             case h_general:
+              SCAN_TO(header_field_ranges, HEADER_FIELD_RANGES);
               break;
 
             case h_C:
@@ -1461,6 +1595,7 @@ size_t http_parser_execute (http_parser *parser,
 
         switch (parser->header_state) {
           case h_general:
+            SCAN_TO(header_value_ranges, HEADER_VALUE_RANGES);
             break;
 
           case h_connection:
@@ -2141,6 +2276,14 @@ http_parser_parse_url(const char *buf, size_t buflen, int is_connect,
     /* Nothing's changed; soldier on */
     if (uf == old_uf) {
       u->field_data[uf].len++;
+#if HTTP_PARSER_SIMD
+      if (uf == UF_PATH || uf == UF_QUERY || uf == UF_FRAGMENT) {
+        const char *q =
+          scan_ranges(p + 1, buf + buflen, url_ranges, URL_RANGES);
+        u->field_data[uf].len += q - (p + 1);
+        p = q - 1;
+      }
+#endif
       continue;
     }
 
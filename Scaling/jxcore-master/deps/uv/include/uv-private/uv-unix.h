@@ -62,6 +62,7 @@
 struct uv__io_s;
 struct uv__async;
 struct uv_loop_s;
+struct uv_timer_s;
 
 typedef void (*uv__io_cb)(struct uv_loop_s* loop, struct uv__io_s* w,
                           unsigned int events);
@@ -77,6 +78,14 @@ struct uv__io_s {
   UV_IO_PRIVATE_FIELDS
 };
 
+/* a timer heap entry carries the key so the heap is ordered without
+ * touching the handles */
+struct uv__timer_node {
+  uint64_t timeout;
+  uint64_t start_id;
+  struct uv_timer_s* handle;
+};
+
 typedef void (*uv__async_cb)(struct uv_loop_s* loop, struct uv__async* w,
                              unsigned int nevents);
 
@@ -175,9 +184,11 @@ typedef struct {
   void* idle_handles[2];                \
   void* async_handles[2];               \
   struct uv__async async_watcher;       \
-  /* RB_HEAD(uv__timers, uv_timer_s) */ \
+  /* 4-ary min heap, see timer.c */     \
   struct uv__timers {                   \
-    struct uv_timer_s* rbh_root;        \
+    struct uv__timer_node* nodes;       \
+    unsigned int nelts;                 \
+    unsigned int nalloc;                \
   } timer_handles;                      \
   uint64_t time;                        \
   int signal_pipefd[2];                 \
@@ -260,13 +271,7 @@ typedef struct {
   int pending;
 
 #define UV_TIMER_PRIVATE_FIELDS          \
-  /* RB_ENTRY(uv_timer_s) tree_entry; */ \
-  struct {                               \
-    struct uv_timer_s* rbe_left;         \
-    struct uv_timer_s* rbe_right;        \
-    struct uv_timer_s* rbe_parent;       \
-    int rbe_color;                       \
-  } tree_entry;                          \
+  unsigned int heap_index;               \
   uv_timer_cb timer_cb;                  \
   uint64_t timeout;                      \
   uint64_t repeat;                       \
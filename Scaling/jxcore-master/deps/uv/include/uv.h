@@ -288,6 +288,16 @@ UV_EXTERN int uv_run_jx(uv_loop_t* loop, uv_run_mode mode,
 UV_EXTERN int threadHasMessage(const int tid);
 UV_EXTERN void setThreadMessage(const int tid, const int has_it);
 
+/*
+ * Idle notification of the embedder (the garbage collection of the engine).
+ * uv_run_jx calls cb before the loop blocks when nothing is pending and no
+ * timer is due within 2 * budget milliseconds. cb should return within
+ * budget milliseconds. A zero budget or NULL cb turns the notification off.
+ */
+typedef void (*uv_idle_notify_cb)(uv_loop_t* loop, unsigned int budget);
+UV_EXTERN void uv_loop_set_idle_notify(uv_loop_t* loop, uv_idle_notify_cb cb,
+                                       unsigned int budget);
+
 #ifdef JX_TEST_ENVIRONMENT
 #define JX_FREE(mark, x)                     \
   do {                                       \
@@ -1975,6 +1985,10 @@ struct uv_loop_s {
   int discardNext;
   int loopId;
   int fakeHandle;
+  uv_idle_notify_cb idle_notify_cb;
+  unsigned int idle_notify_budget;
+  /* watcher callbacks run by the polls, tells an idle poll from a busy one */
+  unsigned int poll_events;
   /* User data - use this for whatever. */
   void* data;
   /* The last error */
@@ -364,6 +364,35 @@ int uv_run(uv_loop_t* loop, uv_run_mode mode) {
   return uv_run_jx(loop, mode, NULL, -1);
 }
 
+void uv_loop_set_idle_notify(uv_loop_t* loop, uv_idle_notify_cb cb,
+                             unsigned int budget) {
+  loop->idle_notify_cb = cb;
+  loop->idle_notify_budget = budget;
+}
+
+/* The loop is about to block for *timeout ms (-1 until an event arrives)
+ * with nothing pending. The I/O that is ready goes first, the callback is
+ * only called when a poll that doesn't block finds nothing. Returns 1 when
+ * that poll has run some watchers, 0 otherwise with *timeout updated.
+ */
+static int uv__idle_notify(uv_loop_t* loop, int* timeout) {
+  unsigned int budget;
+  unsigned int events;
+
+  budget = loop->idle_notify_budget;
+  if (loop->idle_notify_cb == NULL || budget == 0) return 0;
+  if (*timeout != -1 && (unsigned int)*timeout < 2 * budget) return 0;
+
+  events = loop->poll_events;
+  uv__io_poll_jx(loop, 0, loop->loopId);
+  if (loop->poll_events != events) return 1;
+
+  loop->idle_notify_cb(loop, budget);
+  uv__update_time(loop);
+  *timeout = uv_backend_timeout(loop);
+  return 0;
+}
+
 int uv_run_jx(uv_loop_t* loop, uv_run_mode mode, void (*triggerSync)(const int),
               const int tid) {
   int timeout;
@@ -391,7 +420,8 @@ int uv_run_jx(uv_loop_t* loop, uv_run_mode mode, void (*triggerSync)(const int),
     if ((mode & UV_RUN_NOWAIT) == 0) timeout = uv_backend_timeout(loop);
 
     if (mode != UV_RUN_PAUSE) {
-      uv__io_poll_jx(loop, timeout, loop->loopId);
+      if (timeout == 0 || !uv__idle_notify(loop, &timeout))
+        uv__io_poll_jx(loop, timeout, loop->loopId);
     }
 
     uv__run_check(loop);
@@ -244,6 +244,7 @@ void uv__io_poll_jx(uv_loop_t* loop, int timeout, const int tid) {
 
     loop->watchers[loop->nwatchers] = NULL;
     loop->watchers[loop->nwatchers + 1] = NULL;
+    loop->poll_events += nevents;
 
     if (nevents != 0) {
       if (nfds == ARRAY_SIZE(events) && --count != 0) {
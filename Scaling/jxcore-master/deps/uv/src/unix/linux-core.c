@@ -154,6 +154,15 @@ void uv__io_poll_jx(uv_loop_t* loop, int timeout, const int tid) {
     assert(w->fd >= 0);
     assert(w->fd < (int)loop->nwatchers);
 
+    /* w->events is the mask the kernel has. If we only stopped watching
+     * some events, skip the syscall. The events we don't want anymore are
+     * squelched after epoll_wait() and dropped from the kernel mask the first
+     * time they actually wake us up (see below). Under keep-alive traffic
+     * this saves the MOD that removes EPOLLOUT after every response and the
+     * MOD that adds it back for the next one.
+     */
+    if (w->events != 0 && (w->pevents & ~w->events) == 0) continue;
+
     e.events = w->pevents;
     e.data = w->fd;
 
@@ -162,9 +171,6 @@ void uv__io_poll_jx(uv_loop_t* loop, int timeout, const int tid) {
     else
       op = UV__EPOLL_CTL_MOD;
 
-    /* XXX Future optimization: do EPOLL_CTL_MOD lazily if we stop watching
-     * events, skip the syscall and squelch the events after epoll_wait().
-     */
     if (uv__epoll_ctl(loop->backend_fd, op, w->fd, &e)) {
       if (errno != EEXIST) JXABORT("A1");
 
@@ -265,6 +271,17 @@ void uv__io_poll_jx(uv_loop_t* loop, int timeout, const int tid) {
         continue;
       }
 
+      /* A spurious wakeup for an event we've stopped watching lazily, remove
+       * it from the kernel mask now. Errors are ignored, the events are
+       * filtered below anyway and the MOD is retried on the next one.
+       */
+      if (pe->events & w->events & ~w->pevents & (UV__EPOLLIN | UV__EPOLLOUT)) {
+        e.events = w->pevents;
+        e.data = fd;
+        if (uv__epoll_ctl(loop->backend_fd, UV__EPOLL_CTL_MOD, fd, &e) == 0)
+          w->events = w->pevents;
+      }
+
       /* Give users only events they're interested in. Prevents spurious
        * callbacks when previous callback invocation in this loop has stopped
        * the current watcher. Also, filters out events that users has not
@@ -297,6 +314,7 @@ void uv__io_poll_jx(uv_loop_t* loop, int timeout, const int tid) {
     }
     loop->watchers[loop->nwatchers] = NULL;
     loop->watchers[loop->nwatchers + 1] = NULL;
+    loop->poll_events += nevents;
 
     if (nevents != 0) {
       if (nfds == ARRAY_SIZE(events) && --count != 0) {
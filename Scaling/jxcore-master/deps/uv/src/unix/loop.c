@@ -33,7 +33,9 @@ int uv__loop_init(uv_loop_t* loop, int default_loop) {
   uv__signal_global_once_init();
 
   memset(loop, 0, sizeof(*loop));
-  RB_INIT(&loop->timer_handles);
+  loop->timer_handles.nodes = NULL;
+  loop->timer_handles.nelts = 0;
+  loop->timer_handles.nalloc = 0;
   QUEUE_INIT(&loop->wq);
   QUEUE_INIT(&loop->active_reqs);
   QUEUE_INIT(&loop->idle_handles);
@@ -125,6 +127,13 @@ void uv__loop_delete(uv_loop_t* loop) {
   JX_FREE(loop, loop->watchers);
   loop->watchers = NULL;
   loop->nwatchers = 0;
+
+  if (loop->timer_handles.nodes != NULL) {
+    JX_FREE(loop, loop->timer_handles.nodes);
+    loop->timer_handles.nodes = NULL;
+  }
+  loop->timer_handles.nelts = 0;
+  loop->timer_handles.nalloc = 0;
 }
 
 int uv__loop_configure(uv_loop_t* loop, uv_loop_option option, va_list ap) {
@@ -44,6 +44,18 @@ extern char** environ;
 # include <grp.h>
 #endif
 
+/* uv__spawn_clone() makes the system calls of the child itself */
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+# define UV__SPAWN_CLONE 1
+# include <limits.h>
+# include <sched.h>
+# include <signal.h>
+# include <string.h>
+# include <sys/ioctl.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+#endif
+
 static QUEUE* uv__process_queue(uv_loop_t* loop, int pid) {
   assert(pid > 0);
   return loop->process_handles + pid % ARRAY_SIZE(loop->process_handles);
@@ -122,6 +134,10 @@ static void uv__chld(uv_signal_t* handle, int signum) {
       term_signal = 0;
       if (WIFSIGNALED(process->status)) term_signal = WTERMSIG(process->status);
 
+      /* the child has failed before execve() returned, see uv_spawn_jx */
+      if (process->errorno)
+        uv__set_sys_error(process->loop, process->errorno);
+
       process->exit_cb(process, exit_status, term_signal);
     }
   }
@@ -397,6 +413,297 @@ static void uv__process_child_init(const uv_process_options_t* options,
   _exit(127);
 }
 
+
+#ifdef UV__SPAWN_CLONE
+/* The child of clone(CLONE_VM | CLONE_VFORK) shares the memory of the
+ * parent until it calls execve(), the calling thread waits for that. The
+ * page tables aren't copied, the spawn doesn't get slower with the RSS of
+ * the process and the loop doesn't stall on the copy-on-write faults after
+ * fork(). The child runs on a stack of its own and does only the fd, cwd
+ * and exec calls, setuid() and setgid() (glibc signals every thread of the
+ * process for them) are left to fork().
+ *
+ * The child shares the thread local storage of the parent's thread as well,
+ * errno included. It doesn't call the C library for the system calls, they
+ * return -errno and the child reports that through the error pipe.
+ */
+#define UV__SPAWN_STACK_SIZE (64 * 1024)
+
+/* arguments of the /bin/sh fallback of uv__execve(), on the child's stack */
+#define UV__SPAWN_SH_ARGS 1024
+
+#ifndef MAP_STACK
+# define MAP_STACK 0
+#endif
+
+#define UV__SPAWN_SYSCALL(n, a, b, c, d)                                      \
+  uv__spawn_syscall((n), (long) (a), (long) (b), (long) (c), (long) (d))
+
+struct uv__spawn_args {
+  const uv_process_options_t* options;
+  int stdio_count;
+  int (*pipes)[2];
+  int error_fd;
+  sigset_t* sigmask;
+};
+
+
+static long uv__spawn_syscall(long n, long a, long b, long c, long d) {
+#if defined(__x86_64__)
+  register long r10 __asm__("r10") = d;
+  long r;
+
+  __asm__ __volatile__ ("syscall"
+                        : "=a" (r)
+                        : "a" (n), "D" (a), "S" (b), "d" (c), "r" (r10)
+                        : "rcx", "r11", "memory");
+  return r;
+#else
+  register long x8 __asm__("x8") = n;
+  register long x0 __asm__("x0") = a;
+  register long x1 __asm__("x1") = b;
+  register long x2 __asm__("x2") = c;
+  register long x3 __asm__("x3") = d;
+
+  __asm__ __volatile__ ("svc 0"
+                        : "+r" (x0)
+                        : "r" (x8), "r" (x1), "r" (x2), "r" (x3)
+                        : "memory");
+  return x0;
+#endif
+}
+
+
+/* err is -errno */
+static void uv__spawn_fail(int error_fd, long err) {
+  int val;
+  long n;
+
+  val = (int) -err;
+  do
+    n = UV__SPAWN_SYSCALL(SYS_write, error_fd, &val, sizeof(val), 0);
+  while (n == -EINTR);
+
+  /* a short write or EPIPE (the parent has quit) can't be reported */
+  for (;;)
+    UV__SPAWN_SYSCALL(SYS_exit_group, 127, 0, 0, 0);
+}
+
+
+/* execve() that runs the scripts without #! with /bin/sh as execvp() does.
+ * Returns -errno.
+ */
+static long uv__execve(const char* path, char* const argv[],
+                       char* const env[]) {
+  char* sh_argv[UV__SPAWN_SH_ARGS];
+  long r;
+  int argc;
+  int i;
+
+  r = UV__SPAWN_SYSCALL(SYS_execve, path, argv, env, 0);
+  if (r != -ENOEXEC) return r;
+
+  argc = 0;
+  while (argv[argc] != NULL)
+    argc++;
+
+  /* "/bin/sh", path, argv[1..] and NULL */
+  if (argc + 2 > UV__SPAWN_SH_ARGS) return -E2BIG;
+
+  sh_argv[0] = "/bin/sh";
+  sh_argv[1] = (char*) path;
+  for (i = 1; i < argc; i++)
+    sh_argv[i + 1] = argv[i];
+  sh_argv[argc > 1 ? argc + 1 : 2] = NULL;
+
+  return UV__SPAWN_SYSCALL(SYS_execve, "/bin/sh", sh_argv, env, 0);
+}
+
+
+/* execvp() with an explicit environment, PATH is taken from env. It doesn't
+ * allocate (the execvp() of the older C libraries does) and doesn't write
+ * to environ. Returns -errno.
+ */
+static long uv__execvpe(const char* file, char* const argv[],
+                        char* const env[]) {
+  char buf[PATH_MAX];
+  const char* path;
+  const char* dir;
+  const char* end;
+  size_t file_len;
+  size_t dir_len;
+  int seen_eacces;
+  long r;
+  int i;
+
+  if (*file == '\0') return -ENOENT;
+
+  if (strchr(file, '/') != NULL) return uv__execve(file, argv, env);
+
+  path = "/bin:/usr/bin";
+  for (i = 0; env[i] != NULL; i++) {
+    if (strncmp(env[i], "PATH=", 5) == 0) {
+      path = env[i] + 5;
+      break;
+    }
+  }
+
+  r = -ENOENT;
+  seen_eacces = 0;
+  file_len = strlen(file);
+  for (dir = path;; dir = end + 1) {
+    end = strchr(dir, ':');
+    if (end == NULL) end = dir + strlen(dir);
+
+    /* an empty entry is the working directory */
+    dir_len = end - dir;
+    if (dir_len + file_len + 2 <= sizeof(buf)) {
+      memcpy(buf, dir, dir_len);
+      if (dir_len > 0) buf[dir_len++] = '/';
+      memcpy(buf + dir_len, file, file_len + 1);
+
+      r = uv__execve(buf, argv, env);
+      switch (r) {
+        case -EACCES:
+          seen_eacces = 1;
+          break;
+        case -ENOENT:
+        case -ENOTDIR:
+        case -ENODEV:
+        case -ESTALE:
+        case -ETIMEDOUT:
+          break;
+        default:
+          return r;
+      }
+    }
+
+    if (*end == '\0') break;
+  }
+
+  return seen_eacces ? -EACCES : r;
+}
+
+
+/* uv__process_child_init() without the C library */
+static int uv__spawn_child(void* arg) {
+  const uv_process_options_t* options;
+  struct uv__spawn_args* args;
+  int (*pipes)[2];
+  long action[4];  /* struct sigaction of the kernel, the handler first */
+  int close_fd;
+  int use_fd;
+  int signum;
+  int zero;
+  int fd;
+  long r;
+
+  args = arg;
+  options = args->options;
+  pipes = args->pipes;
+
+  /* the handlers of the parent would run in its memory, all the signals are
+   * blocked until they are reset
+   */
+  for (signum = 1; signum < NSIG; signum++) {
+    if (UV__SPAWN_SYSCALL(SYS_rt_sigaction, signum, NULL, action, 8) != 0)
+      continue;
+    if (action[0] == (long) SIG_DFL || action[0] == (long) SIG_IGN) continue;
+
+    memset(action, 0, sizeof(action));
+    UV__SPAWN_SYSCALL(SYS_rt_sigaction, signum, action, NULL, 8);
+  }
+  UV__SPAWN_SYSCALL(SYS_rt_sigprocmask, SIG_SETMASK, args->sigmask, NULL, 8);
+
+  if (options->flags & UV_PROCESS_DETACHED)
+    UV__SPAWN_SYSCALL(SYS_setsid, 0, 0, 0, 0);
+
+  for (fd = 0; fd < args->stdio_count; fd++) {
+    close_fd = pipes[fd][0];
+    use_fd = pipes[fd][1];
+
+    if (use_fd < 0) {
+      if (fd >= 3)
+        continue;
+
+      /* stdin, stdout and stderr go to /dev/null even if UV_IGNORE is set */
+      r = UV__SPAWN_SYSCALL(SYS_openat, AT_FDCWD, "/dev/null",
+                            fd == 0 ? O_RDONLY : O_RDWR, 0);
+      if (r < 0) uv__spawn_fail(args->error_fd, r);
+
+      use_fd = (int) r;
+      close_fd = use_fd;
+    }
+
+    if (fd == use_fd)
+      UV__SPAWN_SYSCALL(SYS_fcntl, use_fd, F_SETFD, 0, 0);
+    else
+      UV__SPAWN_SYSCALL(SYS_dup3, use_fd, fd, 0, 0);
+
+    if (fd <= 2) {
+      zero = 0;
+      UV__SPAWN_SYSCALL(SYS_ioctl, fd, FIONBIO, &zero, 0);
+    }
+
+    if (close_fd >= args->stdio_count)
+      UV__SPAWN_SYSCALL(SYS_close, close_fd, 0, 0, 0);
+  }
+
+  for (fd = 0; fd < args->stdio_count; fd++) {
+    use_fd = pipes[fd][1];
+
+    if (use_fd >= 0 && fd != use_fd)
+      UV__SPAWN_SYSCALL(SYS_close, use_fd, 0, 0, 0);
+  }
+
+  if (options->cwd != NULL) {
+    r = UV__SPAWN_SYSCALL(SYS_chdir, options->cwd, 0, 0, 0);
+    if (r < 0) uv__spawn_fail(args->error_fd, r);
+  }
+
+  r = uv__execvpe(options->file, options->args,
+                  options->env ? options->env : environ);
+  uv__spawn_fail(args->error_fd, r);
+  return 127;
+}
+
+
+/* Returns the pid of the child or -1, fork() is used then */
+static pid_t uv__spawn_clone(const uv_process_options_t* options,
+                             int stdio_count, int (*pipes)[2],
+                             int error_fd) {
+  struct uv__spawn_args args;
+  sigset_t all;
+  sigset_t old;
+  char* stack;
+  pid_t pid;
+
+  if (options->flags & (UV_PROCESS_SETUID | UV_PROCESS_SETGID)) return -1;
+  if (options->args == NULL) return -1;
+
+  stack = mmap(NULL, UV__SPAWN_STACK_SIZE, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+  if (stack == MAP_FAILED) return -1;
+
+  args.options = options;
+  args.stdio_count = stdio_count;
+  args.pipes = pipes;
+  args.error_fd = error_fd;
+  args.sigmask = &old;
+
+  sigfillset(&all);
+  pthread_sigmask(SIG_SETMASK, &all, &old);
+
+  /* the stack grows down */
+  pid = clone(uv__spawn_child, stack + UV__SPAWN_STACK_SIZE,
+              CLONE_VM | CLONE_VFORK | SIGCHLD, &args);
+
+  pthread_sigmask(SIG_SETMASK, &old, NULL);
+  munmap(stack, UV__SPAWN_STACK_SIZE);
+  return pid;
+}
+#endif
+
 int uv_spawn_jx(uv_loop_t* loop, uv_process_t* process,
                 uv_process_options_t* options) {
   int signal_pipe[2] = {-1, -1};
@@ -457,6 +764,10 @@ int uv_spawn_jx(uv_loop_t* loop, uv_process_t* process,
   uv_signal_start(&loop->child_watcher, uv__chld, SIGCHLD);
 
   uv_rwlock_wrlock(&loop->cloexec_lock);
+#ifdef UV__SPAWN_CLONE
+  pid = uv__spawn_clone(options, stdio_count, pipes, signal_pipe[1]);
+  if (pid == -1)
+#endif
   pid = fork();
 
   if (pid == -1) {
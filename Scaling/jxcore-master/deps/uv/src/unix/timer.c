@@ -22,20 +22,113 @@
 #include "internal.h"
 #include <assert.h>
 #include <limits.h>
+#include <stdlib.h>
 
-static int uv__timer_cmp(const uv_timer_t* a, const uv_timer_t* b) {
-  if (a->timeout < b->timeout) return -1;
-  if (a->timeout > b->timeout) return 1;
+static int uv__timer_less(const struct uv__timer_node* a,
+                          const struct uv__timer_node* b) {
+  if (a->timeout != b->timeout) return a->timeout < b->timeout;
   /*
    *  compare start_id when both has the same timeout. start_id is
    *  allocated with loop->timer_counter in uv_timer_start().
    */
-  if (a->start_id < b->start_id) return -1;
-  if (a->start_id > b->start_id) return 1;
-  return 0;
+  return a->start_id < b->start_id;
+}
+
+/*
+ * The active timers are kept in a 4-ary min heap. The children of node i
+ * are 4i+1 .. 4i+4, so the siblings compared on the way down are adjacent
+ * and the tree is half as deep as a binary one. The nodes carry the keys,
+ * every timer keeps its own position (heap_index) for uv_timer_stop.
+ */
+#define UV__TIMER_HEAP_ARITY 4
+
+static void uv__timer_heap_set(struct uv__timers* heap, unsigned int index,
+                               const struct uv__timer_node* node) {
+  heap->nodes[index] = *node;
+  node->handle->heap_index = index;
+}
+
+static void uv__timer_heap_up(struct uv__timers* heap, unsigned int index) {
+  struct uv__timer_node node;
+  unsigned int parent;
+
+  node = heap->nodes[index];
+  while (index > 0) {
+    parent = (index - 1) / UV__TIMER_HEAP_ARITY;
+    if (!uv__timer_less(&node, heap->nodes + parent)) break;
+    uv__timer_heap_set(heap, index, heap->nodes + parent);
+    index = parent;
+  }
+  uv__timer_heap_set(heap, index, &node);
+}
+
+static void uv__timer_heap_down(struct uv__timers* heap, unsigned int index) {
+  struct uv__timer_node node;
+  unsigned int child;
+  unsigned int last;
+  unsigned int min;
+
+  node = heap->nodes[index];
+  for (;;) {
+    child = index * UV__TIMER_HEAP_ARITY + 1;
+    if (child >= heap->nelts) break;
+
+    last = child + UV__TIMER_HEAP_ARITY;
+    if (last > heap->nelts) last = heap->nelts;
+
+    for (min = child++; child < last; child++) {
+      if (uv__timer_less(heap->nodes + child, heap->nodes + min)) min = child;
+    }
+
+    if (!uv__timer_less(heap->nodes + min, &node)) break;
+    uv__timer_heap_set(heap, index, heap->nodes + min);
+    index = min;
+  }
+  uv__timer_heap_set(heap, index, &node);
+}
+
+static void uv__timer_heap_insert(struct uv__timers* heap,
+                                  uv_timer_t* handle) {
+  struct uv__timer_node* nodes;
+  struct uv__timer_node* node;
+  unsigned int nalloc;
+
+  if (heap->nelts == heap->nalloc) {
+    nalloc = heap->nalloc ? heap->nalloc * 2 : 16;
+    nodes = realloc(heap->nodes, nalloc * sizeof(heap->nodes[0]));
+    if (nodes == NULL) abort();
+    heap->nodes = nodes;
+    heap->nalloc = nalloc;
+  }
+
+  node = heap->nodes + heap->nelts;
+  node->timeout = handle->timeout;
+  node->start_id = handle->start_id;
+  node->handle = handle;
+  uv__timer_heap_up(heap, heap->nelts++);
+}
+
+static void uv__timer_heap_remove(struct uv__timers* heap,
+                                  uv_timer_t* handle) {
+  unsigned int index;
+  unsigned int parent;
+
+  index = handle->heap_index;
+  if (index == --heap->nelts) return;
+
+  /* the last node takes the free slot and moves up or down from there */
+  uv__timer_heap_set(heap, index, heap->nodes + heap->nelts);
+  parent = (index - 1) / UV__TIMER_HEAP_ARITY;
+  if (index > 0 && uv__timer_less(heap->nodes + index, heap->nodes + parent)) {
+    uv__timer_heap_up(heap, index);
+  } else {
+    uv__timer_heap_down(heap, index);
+  }
 }
 
-RB_GENERATE_STATIC(uv__timers, uv_timer_s, tree_entry, uv__timer_cmp)
+static uv_timer_t* uv__timer_heap_min(const struct uv__timers* heap) {
+  return heap->nelts > 0 ? heap->nodes[0].handle : NULL;
+}
 
 int uv_timer_init(uv_loop_t* loop, uv_timer_t* handle) {
   uv__handle_init(loop, (uv_handle_t*)handle, UV_TIMER);
@@ -57,10 +150,10 @@ int uv_timer_start(uv_timer_t* handle, uv_timer_cb cb, uint64_t timeout,
   handle->timer_cb = cb;
   handle->timeout = clamped_timeout;
   handle->repeat = repeat;
-  /* start_id is the second index to be compared in uv__timer_cmp() */
+  /* start_id is the second index to be compared in uv__timer_less() */
   handle->start_id = handle->loop->timer_counter++;
 
-  RB_INSERT(uv__timers, &handle->loop->timer_handles, handle);
+  uv__timer_heap_insert(&handle->loop->timer_handles, handle);
   uv__handle_start(handle);
 
   return 0;
@@ -69,7 +162,7 @@ int uv_timer_start(uv_timer_t* handle, uv_timer_cb cb, uint64_t timeout,
 int uv_timer_stop(uv_timer_t* handle) {
   if (!uv__is_active(handle)) return 0;
 
-  RB_REMOVE(uv__timers, &handle->loop->timer_handles, handle);
+  uv__timer_heap_remove(&handle->loop->timer_handles, handle);
   uv__handle_stop(handle);
 
   return 0;
@@ -99,8 +192,7 @@ int uv__next_timeout(const uv_loop_t* loop) {
   const uv_timer_t* handle;
   uint64_t diff;
 
-  /* RB_MIN expects a non-const tree root. That's okay, it doesn't modify it. */
-  handle = RB_MIN(uv__timers, (struct uv__timers*)&loop->timer_handles);
+  handle = uv__timer_heap_min(&loop->timer_handles);
 
   if (handle == NULL) return -1; /* block indefinitely */
 
@@ -115,7 +207,7 @@ int uv__next_timeout(const uv_loop_t* loop) {
 void uv__run_timers(uv_loop_t* loop) {
   uv_timer_t* handle;
 
-  while ((handle = RB_MIN(uv__timers, &loop->timer_handles))) {
+  while ((handle = uv__timer_heap_min(&loop->timer_handles))) {
     if (handle->timeout > loop->time) break;
 
     uv_timer_stop(handle);
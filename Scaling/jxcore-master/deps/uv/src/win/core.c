@@ -126,6 +126,9 @@ static void uv_loop_init(uv_loop_t* loop) {
   loop->timer_counter = 0;
   loop->stop_flag = 0;
 
+  loop->idle_notify_cb = NULL;
+  loop->idle_notify_budget = 0;
+
   loop->last_err = uv_ok_;
 }
 
@@ -337,9 +340,36 @@ int threadHasMessage(const int tid) {
 #define THREAD_ID_NOT_DEFINED -1
 #define THREAD_ID_ALREADY_DEFINED -2
 
+void uv_loop_set_idle_notify(uv_loop_t* loop, uv_idle_notify_cb cb,
+                             unsigned int budget) {
+  loop->idle_notify_cb = cb;
+  loop->idle_notify_budget = budget;
+}
+
+/* The loop is about to block with nothing pending. The completions that are
+ * ready go first, the callback is only called when a poll that doesn't block
+ * finds nothing. Returns 1 when that poll has queued some requests.
+ */
+static int uv__idle_notify(uv_loop_t* loop,
+                           void (*poll)(uv_loop_t* loop, int block)) {
+  DWORD timeout;
+
+  if (loop->idle_notify_cb == NULL || loop->idle_notify_budget == 0) return 0;
+
+  timeout = uv_get_poll_timeout(loop);
+  if (timeout != INFINITE && timeout < 2 * loop->idle_notify_budget) return 0;
+
+  (*poll)(loop, 0);
+  if (loop->pending_reqs_tail != NULL) return 1;
+
+  loop->idle_notify_cb(loop, loop->idle_notify_budget);
+  uv_update_time(loop);
+  return 0;
+}
+
 int uv_run_jx(uv_loop_t* loop, uv_run_mode mode, void (*triggerSync)(const int),
               const int tid) {
-  int r, force_close, success;
+  int r, force_close, success, block;
   uint64_t start_time, end_time;
   void (*poll)(uv_loop_t * loop, int block);
 
@@ -378,12 +408,13 @@ int uv_run_jx(uv_loop_t* loop, uv_run_mode mode, void (*triggerSync)(const int),
     }
 
     if (mode != UV_RUN_PAUSE) {
-      (*poll)(loop, loop->idle_handles == NULL && threadMessages[loop->loopId] == 0 &&
-                        loop->pending_reqs_tail == NULL &&
-                        loop->endgame_handles == NULL && !loop->stop_flag &&
-                        (loop->active_handles > loop->fakeHandle ||
-                         !QUEUE_EMPTY(&loop->active_reqs)) &&
-                        !(mode & UV_RUN_NOWAIT));
+      block = loop->idle_handles == NULL && threadMessages[loop->loopId] == 0 &&
+              loop->pending_reqs_tail == NULL &&
+              loop->endgame_handles == NULL && !loop->stop_flag &&
+              (loop->active_handles > loop->fakeHandle ||
+               !QUEUE_EMPTY(&loop->active_reqs)) &&
+              !(mode & UV_RUN_NOWAIT);
+      if (!block || !uv__idle_notify(loop, poll)) (*poll)(loop, block);
     }
 
     uv_check_invoke(loop);
@@ -75,3 +75,54 @@ BENCHMARK_IMPL(million_timers) {
   MAKE_VALGRIND_HAPPY();
   return 0;
 }
+
+
+#define NUM_LIVE_TIMERS (100 * 1000)
+#define NUM_RESTARTS (10 * 1000 * 1000)
+
+/* restarts random timers out of NUM_LIVE_TIMERS active ones */
+BENCHMARK_IMPL(timers_start_stop) {
+  uv_timer_t* timers;
+  uv_loop_t* loop;
+  uint64_t before;
+  uint64_t after;
+  unsigned int seed;
+  int i;
+
+  timers = malloc(NUM_LIVE_TIMERS * sizeof(timers[0]));
+  ASSERT(timers != NULL);
+
+  loop = uv_default_loop();
+  seed = 1;
+
+  for (i = 0; i < NUM_LIVE_TIMERS; i++) {
+    seed = seed * 1103515245 + 12345;
+    ASSERT(0 == uv_timer_init(loop, timers + i));
+    ASSERT(0 == uv_timer_start(timers + i, timer_cb, 1000 + seed % 10000, 0));
+  }
+
+  before = uv_hrtime();
+  for (i = 0; i < NUM_RESTARTS; i++) {
+    uv_timer_t* timer;
+    seed = seed * 1103515245 + 12345;
+    timer = timers + (seed >> 8) % NUM_LIVE_TIMERS;
+    ASSERT(0 == uv_timer_stop(timer));
+    ASSERT(0 == uv_timer_start(timer, timer_cb, 1000 + seed % 10000, 0));
+  }
+  after = uv_hrtime();
+
+  for (i = 0; i < NUM_LIVE_TIMERS; i++)
+    uv_close((uv_handle_t*) (timers + i), close_cb);
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+  ASSERT(timer_cb_called == 0);
+  ASSERT(close_cb_called == NUM_LIVE_TIMERS);
+  free(timers);
+
+  LOGF("%d timers: %.0f restarts/s\n",
+       NUM_LIVE_TIMERS,
+       NUM_RESTARTS / ((after - before) / 1e9));
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -0,0 +1,120 @@
+/* Copyright Joyent, Inc. and other Node contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "uv.h"
+#include "task.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+static uv_timer_t timer_handle;
+static int notify_called;
+static int timer_called;
+
+
+static void notify_cb(uv_loop_t* loop, unsigned int budget) {
+  ASSERT(loop == uv_default_loop());
+  ASSERT(budget == 5);
+  notify_called++;
+}
+
+
+static void timer_cb(uv_timer_t* handle, int status) {
+  ASSERT(handle == &timer_handle);
+  ASSERT(status == 0);
+  timer_called++;
+  if (timer_called == 20) uv_timer_stop(handle);
+}
+
+
+#ifndef _WIN32
+static uv_pipe_t pipe_handle;
+static char read_buf[16];
+static int read_called;
+
+
+static uv_buf_t alloc_cb(uv_handle_t* handle, size_t suggested_size) {
+  return uv_buf_init(read_buf, sizeof(read_buf));
+}
+
+
+static void read_cb(uv_stream_t* stream, ssize_t nread, uv_buf_t buf) {
+  ASSERT(nread == 1);
+  read_called++;
+  uv_close((uv_handle_t*)stream, NULL);
+}
+#endif
+
+
+TEST_IMPL(loop_idle_notify) {
+  uv_loop_t* loop;
+
+  loop = uv_default_loop();
+  uv_loop_set_idle_notify(loop, notify_cb, 5);
+  uv_timer_init(loop, &timer_handle);
+
+  /* the timers are due sooner than 2 * budget */
+  uv_timer_start(&timer_handle, timer_cb, 1, 1);
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+  ASSERT(timer_called == 20);
+  ASSERT(notify_called == 0);
+
+  /* an idle window before the timer */
+  uv_timer_start(&timer_handle, timer_cb, 50, 0);
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+  ASSERT(timer_called == 21);
+  ASSERT(notify_called == 1);
+
+  /* UV_RUN_NOWAIT doesn't block */
+  uv_timer_start(&timer_handle, timer_cb, 50, 0);
+  uv_run(loop, UV_RUN_NOWAIT);
+  ASSERT(notify_called == 1);
+
+  uv_loop_set_idle_notify(loop, NULL, 0);
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+  ASSERT(timer_called == 22);
+  ASSERT(notify_called == 1);
+
+#ifndef _WIN32
+  {
+    /* the I/O that is ready goes before the notification */
+    int fds[2];
+    ASSERT(0 == pipe(fds));
+    ASSERT(0 == uv_pipe_init(loop, &pipe_handle, 0));
+    ASSERT(0 == uv_pipe_open(&pipe_handle, fds[0]));
+    ASSERT(0 == uv_read_start((uv_stream_t*)&pipe_handle, alloc_cb, read_cb));
+    ASSERT(1 == write(fds[1], "x", 1));
+
+    uv_loop_set_idle_notify(loop, notify_cb, 5);
+    uv_run(loop, UV_RUN_ONCE);
+    ASSERT(read_called == 1);
+    ASSERT(notify_called == 1);
+
+    ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+    uv_loop_set_idle_notify(loop, NULL, 0);
+    close(fds[1]);
+  }
+#endif
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
@@ -21,6 +21,7 @@
 
 #include "uv.h"
 #include "task.h"
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -170,6 +171,44 @@ TEST_IMPL(spawn_fails) {
 }
 
 
+#ifndef _WIN32
+static void exit_cb_errorno(uv_process_t* process, int exit_status,
+    int term_signal) {
+  printf("exit_cb\n");
+  exit_cb_called++;
+  ASSERT(exit_status == 127);
+  ASSERT(term_signal == 0);
+  ASSERT(process->errorno == ENOENT);
+  ASSERT(uv_last_error(process->loop).code == UV_ENOENT);
+  uv_close((uv_handle_t*)process, close_cb);
+}
+
+
+/* the error of the child reaches the parent through the error pipe, both
+ * with the PATH search and with a path
+ */
+TEST_IMPL(spawn_fails_errorno) {
+  init_process_options("", exit_cb_errorno);
+  options.file = options.args[0] = "program-that-had-better-not-exist";
+  ASSERT(0 == uv_spawn(uv_default_loop(), &process, options));
+  ASSERT(process.errorno == ENOENT);
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+  ASSERT(exit_cb_called == 1);
+  ASSERT(close_cb_called == 1);
+
+  options.file = options.args[0] = "/program-that-had-better-not-exist";
+  ASSERT(0 == uv_spawn(uv_default_loop(), &process, options));
+  ASSERT(process.errorno == ENOENT);
+  ASSERT(0 == uv_run(uv_default_loop(), UV_RUN_DEFAULT));
+  ASSERT(exit_cb_called == 2);
+  ASSERT(close_cb_called == 2);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+#endif
+
+
 TEST_IMPL(spawn_exit_code) {
   int r;
 
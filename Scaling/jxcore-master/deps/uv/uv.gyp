@@ -368,6 +368,7 @@
         'test/test-list.h',
         'test/test-loop-handles.c',
         'test/test-loop-stop.c',
+        'test/test-loop-idle-notify.c',
         'test/test-loop-configure.c',
         'test/test-walk-handles.c',
         'test/test-watcher-cross-stop.c',
@@ -112,7 +112,10 @@
       'src/jx/job.cc',
       'src/jx/jx_instance.cc',
       'src/jx/job_store.cc',
+      'src/jx/channel_store.cc',
       'src/jx/memory_store.cc',
+      'src/jx/store_allocator.cc',
+      'src/jx/buffer_allocator.cc',
       'src/jx/jxp_compress.cc',
       'src/jx/error_definition.cc',
 
@@ -137,6 +140,11 @@
       'src/wrappers/pipe_wrap.cc',
       'src/wrappers/node_http_parser.cc',
       'src/wrappers/node_zlib.cc',
+      'src/wrappers/querystring_wrap.cc',
+      'src/wrappers/url_wrap.cc',
+      'src/wrappers/string_decoder_wrap.cc',
+      'src/wrappers/line_splitter_wrap.cc',
+      'src/wrappers/websocket_wrap.cc',
 
       'src/external/module_wrap.cc',
 
@@ -210,7 +218,10 @@
       ['node_use_openssl=="true"',
       {
         'defines': ['HAVE_OPENSSL=1'],
-        'sources': ['src/wrappers/node_crypto.cc'],
+        'sources': [
+          'src/wrappers/node_crypto.cc',
+          'src/wrappers/node_crypto_random.cc',
+        ],
         'conditions': [
           ['node_shared_openssl=="false"',
           {
@@ -449,13 +460,28 @@
       ['node_use_perfctr=="true" and node_engine_v8==1',
       {
         'defines': ['HAVE_PERFCTR=1'],
-        'dependencies': ['node_perfctr'],
         'sources': [
-          'src/platform/win/node_win32_perfctr_provider.h',
-          'src/platform/win/node_win32_perfctr_provider.cc',
           'src/node_counters.cc',
           'src/node_counters.h',
-          'tools/msvs/genfiles/node_perfctr_provider.rc',
+        ],
+        'conditions': [
+          ['OS=="win"',
+          {
+            'dependencies': ['node_perfctr'],
+            'sources': [
+              'src/platform/win/node_win32_perfctr_provider.h',
+              'src/platform/win/node_win32_perfctr_provider.cc',
+              'tools/msvs/genfiles/node_perfctr_provider.rc',
+            ]
+          },
+          {
+            'dependencies': ['jxcounters'],
+            'sources': [
+              'src/platform/linux/node_linux_perfctr_layout.h',
+              'src/platform/linux/node_linux_perfctr_provider.h',
+              'src/platform/linux/node_linux_perfctr_provider.cc',
+            ]
+          }]
         ]
       }],
       ['node_no_sqlite==0',
@@ -603,6 +629,19 @@
       }]
     ]
   },
+  {
+    # reads the counters of a running process (tools/jxcounters.c)
+    'target_name': 'jxcounters',
+    'type': 'none',
+    'conditions': [
+      ['node_use_perfctr=="true" and OS=="linux"',
+      {
+        'type': 'executable',
+        'include_dirs': ['src/platform/linux'],
+        'sources': ['tools/jxcounters.c'],
+      }]
+    ]
+  },
   {
     'target_name': 'node_js2c',
     'type': 'none',
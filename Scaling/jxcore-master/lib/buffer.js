@@ -8,6 +8,10 @@ exports.INSPECT_MAX_BYTES = 50;
 // This is an exception to the rule that __proto__ is not allowed in core.
 SlowBuffer.prototype.__proto__ = Buffer.prototype;
 
+SlowBuffer.allocatorUsage = function() {
+  return process.binding('memory_wrap').statsBuffers();
+};
+
 function clamp(index, len, defaultValue) {
   if (typeof index !== 'number') return defaultValue;
   index = ~~index; // Coerce to integer.
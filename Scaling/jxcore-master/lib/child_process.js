@@ -1,10 +1,10 @@
 // Copyright & License details are available under JXCORE_LICENSE file
 
-var StringDecoder = require('string_decoder').StringDecoder;
 var EventEmitter = require('events').EventEmitter;
 var net = require('net');
 var dgram = require('dgram');
 var Process = process.binding('process_wrap').Process;
+var LineSplitter = process.binding('line_splitter_wrap').LineSplitter;
 var assert = require('assert');
 var util = require('util');
 var constants;
@@ -307,19 +307,15 @@ function setupChannel(target, channel) {
   target._channel = channel;
   target._handleQueue = null;
 
-  var decoder = new StringDecoder('utf8');
-  var jsonBuffer = '';
+  // Linebreak is used as a message end sign
+  var splitter = new LineSplitter(false);
   channel.buffering = false;
   channel.onread = function(pool, offset, length, recvHandle) {
     if (pool) {
-      jsonBuffer += decoder.write(pool.slice(offset, offset + length));
+      var lines = splitter.write(pool.slice(offset, offset + length));
 
-      var i, start = 0;
-
-      // Linebreak is used as a message end sign
-      while ((i = jsonBuffer.indexOf('\n', start)) >= 0) {
-        var json = jsonBuffer.slice(start, i);
-        var message = JSON.parse(json);
+      for (var i = 0; i < lines.length; i++) {
+        var message = JSON.parse(lines[i]);
 
         // There will be at most one NODE_HANDLE message in every chunk we
         // read because SCM_RIGHTS messages don't get coalesced. Make sure
@@ -328,11 +324,8 @@ function setupChannel(target, channel) {
           handleMessage(target, message, recvHandle);
         else
           handleMessage(target, message, undefined);
-
-        start = i + 1;
       }
-      jsonBuffer = jsonBuffer.slice(start);
-      this.buffering = jsonBuffer.length !== 0;
+      this.buffering = splitter.pending() !== 0;
 
     } else {
       this.buffering = false;
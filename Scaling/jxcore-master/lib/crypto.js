@@ -5,8 +5,8 @@ exports.DEFAULT_ENCODING = 'buffer';
 try {
   var binding = process.binding('crypto');
   var SecureContext = binding.SecureContext;
-  var randomBytes = binding.randomBytes;
-  var pseudoRandomBytes = binding.pseudoRandomBytes;
+  var randomBytes = smallRandom(binding.randomBytes);
+  var pseudoRandomBytes = smallRandom(binding.pseudoRandomBytes);
   var getCiphers = binding.getCiphers;
   var getHashes = binding.getHashes;
   var crypto = true;
@@ -593,9 +593,48 @@ function pbkdf2(password, salt, iterations, keylen, callback) {
   }
 }
 
+// the small requests are served synchronously from the thread's random pool
+// (node_crypto_random.cc), a callback is still called on the next tick
+function smallRandom(generate) {
+  return function(size, callback) {
+    // the invalid sizes throw from the binding as before
+    if (typeof callback !== 'function' || (size >>> 0) !== size ||
+        size > binding.RANDOM_POOL_SMALL_MAX)
+      return generate(size, callback);
+
+    var buf, err = null;
+    try {
+      buf = generate(size);
+    } catch (e) {
+      err = e;
+    }
+    process.nextTick(function() {
+      callback(err, buf);
+    });
+  };
+}
+
 exports.randomBytes = randomBytes;
 exports.pseudoRandomBytes = pseudoRandomBytes;
 
+exports.randomBytesBatch = function(count, size, encoding) {
+  if (typeof count !== 'number' || count < 0 || count % 1 !== 0)
+    throw new TypeError('Argument #1 must be number >= 0');
+  if (typeof size !== 'number' || size <= 0 || size % 1 !== 0)
+    throw new TypeError('Argument #2 must be number > 0');
+
+  // a single fill for all of them
+  var all = binding.randomFill(new Buffer(count * size));
+  var ids = new Array(count);
+  for (var i = 0, offset = 0; i < count; i++, offset += size) {
+    if (encoding)
+      ids[i] = all.toString(encoding, offset, offset + size);
+    else
+      ids[i] = all.slice(offset, offset + size);
+  }
+  return ids;
+};
+
 exports.rng = randomBytes;
 exports.prng = pseudoRandomBytes;
 
@@ -13,9 +13,6 @@ var endMethods = ['end', 'abort', 'destroy', 'destroySoon'];
 // a few side effects.
 events.usingDomains = true;
 
-// let the process know we're using domains
-process._usingDomains();
-
 exports.Domain = Domain;
 
 exports.create = exports.createDomain = function(cb) {
@@ -59,6 +56,12 @@ Domain.prototype.exit = function() {
   process.domain = exports.active;
 };
 
+// let the process know we're using domains. MakeCallback enters and exits
+// the domains natively over the same stack unless enter / exit are
+// overridden
+process._usingDomains(stack, exports, Domain.prototype.enter,
+                      Domain.prototype.exit);
+
 // note: this works for timers as well.
 Domain.prototype.add = function(ee) {
   // disposed domains can't be used for new things.
@@ -15,6 +15,11 @@ var Writable = Stream.Writable;
 var isAndroid = process.platform === 'android' && process.isEmbedded;
 
 var kMinPoolSpace = 128;
+// largest block of a ReadStream with readAhead
+var kMaxReadAhead = 4 * 1024 * 1024;
+// advice of binding.fadvise (fadvise_advice in node_file.cc)
+var kFadviseSequential = 1;
+var kFadviseWillNeed = 2;
 
 var O_APPEND = constants.O_APPEND || 0;
 var O_CREAT = constants.O_CREAT || 0;
@@ -357,6 +362,45 @@ fs.readFileSync = function(path, options) {
   return buffer;
 };
 
+// index of the advice in node_file.cc (mmap_advice)
+var mmapAdvice = {
+  normal: 0,
+  random: 1,
+  sequential: 2,
+  willneed: 3
+};
+
+fs.mmapSync = function(path, options) {
+  if (!options) {
+    options = {};
+  } else if (typeof options !== 'object') {
+    throw new TypeError('Bad arguments');
+  }
+
+  var offset = options.offset === undefined ? 0 : options.offset;
+  var length = options.length === undefined ? -1 : options.length;
+  if (typeof offset !== 'number' || offset < 0 || offset % 1 !== 0)
+    throw new TypeError('offset must be an integer >= 0');
+  if (typeof length !== 'number' || (length < 0 && length !== -1) ||
+      length % 1 !== 0)
+    throw new TypeError('length must be an integer >= 0');
+
+  var advice = options.advice || 'normal';
+  if (!mmapAdvice.hasOwnProperty(advice))
+    throw new TypeError('Unknown advice: ' + advice);
+
+  var fd = fs.openSync(path, 'r');
+  var slow;
+  try {
+    slow = binding.mmap(fd, offset, length, mmapAdvice[advice]);
+  } finally {
+    fs.closeSync(fd);
+  }
+
+  if (!slow) return new Buffer(0);
+  return new Buffer(slow, slow.length, 0);
+};
+
 
 // Used by binding.open and friends
 function stringToFlags(flag) {
@@ -1708,8 +1752,17 @@ function ReadStream(path, options) {
   this.end = options.hasOwnProperty('end') ? options.end : undefined;
   this.autoClose = options.hasOwnProperty('autoClose') ?
       options.autoClose : true;
+  this.readAhead = options.hasOwnProperty('readAhead') ?
+      options.readAhead : false;
   this.pos = undefined;
 
+  // read-ahead state, see ReadStream.prototype._readAhead. the file position
+  // is unknown for a given fd without start
+  this._blockSize = this._readableState.highWaterMark;
+  this._ahead = null;
+  this._aheadPos = this.start || 0;
+  this._aheadKnown = typeof this.fd !== 'number' || this.start !== undefined;
+
   if (this.start !== undefined) {
     if ('number' !== typeof this.start) {
       throw new TypeError('start must be a Number');
@@ -1751,6 +1804,8 @@ ReadStream.prototype.open = function() {
     }
 
     self.fd = fd;
+    if (self.readAhead)
+      binding.fadvise(fd, self._aheadPos, 0, kFadviseSequential);
     self.emit('open', fd);
     // start the flow of data.
     self.read();
@@ -1766,6 +1821,9 @@ ReadStream.prototype._read = function(n) {
   if (this.destroyed)
     return;
 
+  if (this.readAhead)
+    return this._readAhead();
+
   if (!pool || pool.length - pool.used < kMinPoolSpace) {
     // discard the old pool.
     pool = null;
@@ -1813,6 +1871,88 @@ ReadStream.prototype._read = function(n) {
 };
 
 
+// Read-ahead: one read is kept in flight ahead of the consumer, the block
+// it read is pushed as soon as the stream asks for more. When the consumer
+// was already waiting for the block, it keeps up with the file and the
+// block size doubles (up to kMaxReadAhead), so the fast readers go to the
+// thread pool less often. The kernel is told that the file is read
+// sequentially and to start reading the block after the one in flight.
+ReadStream.prototype._readAhead = function() {
+  var req = this._ahead;
+  if (req === null)
+    req = this._startRead();
+
+  if (req.done)
+    this._pushAhead(req);
+  else
+    req.waiting = true;
+};
+
+ReadStream.prototype._startRead = function() {
+  var size = this._blockSize;
+  if (this.pos !== undefined)
+    size = Math.min(this.end - this.pos + 1, size);
+
+  var req = this._ahead = {
+    buffer: null,
+    bytesRead: 0,
+    error: null,
+    done: size <= 0,  // already read everything we were supposed to read
+    waiting: false
+  };
+  if (req.done)
+    return req;
+
+  var self = this;
+  req.buffer = new Buffer(size);
+  fs.read(this.fd, req.buffer, 0, size, this.pos, function(er, bytesRead) {
+    if (self.destroyed)
+      return;
+
+    req.done = true;
+    req.error = er;
+    req.bytesRead = bytesRead;
+    if (req.waiting)
+      self._pushAhead(req);
+  });
+
+  if (this.pos !== undefined)
+    this.pos += size;
+  this._aheadPos += size;
+
+  // the following block, read by the kernel meanwhile
+  if (this._aheadKnown)
+    binding.fadvise(this.fd, this._aheadPos, this._blockSize,
+                    kFadviseWillNeed);
+  return req;
+};
+
+ReadStream.prototype._pushAhead = function(req) {
+  this._ahead = null;
+
+  if (req.error) {
+    if (this.autoClose) {
+      this.destroy();
+    }
+    this.emit('error', req.error);
+    return;
+  }
+
+  if (!req.bytesRead)
+    return this.push(null);
+
+  if (req.waiting && this._blockSize < kMaxReadAhead)
+    this._blockSize = Math.min(this._blockSize * 2, kMaxReadAhead);
+
+  var chunk = req.bytesRead < req.buffer.length ?
+      req.buffer.slice(0, req.bytesRead) : req.buffer;
+
+  // the next block is read while this one is consumed
+  this._startRead();
+  this.push(chunk);
+};
+
+
 ReadStream.prototype.destroy = function() {
   if (this.destroyed)
     return;
@@ -845,6 +845,12 @@ ServerResponse.prototype.writeHeader = function() {
 // ClientRequest.onSocket(). The Agent is now *strictly*
 // concerned with managing a connection pool.
 
+// With the keepAlive option, the sockets that have no pending request are
+// parked in freeSockets until the next request to the same host:port takes
+// them. The last parked socket is taken first, the others can reach their
+// idle timeout and get closed. Every jxcore thread has its own agents, so
+// the threads never share (or lock) a pool.
+
 function Agent(options) {
   EventEmitter.call(this);
 
@@ -852,7 +858,14 @@ function Agent(options) {
   self.options = options || {};
   self.requests = {};
   self.sockets = {};
+  self.freeSockets = {};
   self.maxSockets = self.options.maxSockets || Agent.defaultMaxSockets;
+  self.keepAlive = self.options.keepAlive || false;
+  self.keepAliveMsecs = self.options.keepAliveMsecs || 1000;
+  self.maxFreeSockets = self.options.maxFreeSockets ||
+                        Agent.defaultMaxFreeSockets;
+  self.freeSocketTimeout = self.options.freeSocketTimeout ||
+                           Agent.defaultFreeSocketTimeout;
   self.on('free', function(socket, host, port, localAddress) {
     var name = host + ':' + port;
     if (localAddress) {
@@ -866,7 +879,7 @@ function Agent(options) {
         // don't leak
         delete self.requests[name];
       }
-    } else {
+    } else if (!self.keepAlive || !self.parkSocket(socket, name)) {
       // If there are no pending requests just destroy the
       // socket and it will get removed from the pool. This
       // gets us out of timeout issues and allows us to
@@ -880,6 +893,91 @@ util.inherits(Agent, EventEmitter);
 exports.Agent = Agent;
 
 Agent.defaultMaxSockets = 5;
+Agent.defaultMaxFreeSockets = 256;
+Agent.defaultFreeSocketTimeout = 15000;
+
+// a parked socket has no request to report its errors to
+function freeSocketErrorListener(err) {
+  debug('AGENT free socket error: ' + err.message);
+  this.destroy();
+}
+
+function freeSocketTimeoutListener() {
+  debug('AGENT free socket idle timeout');
+  this.destroy();
+}
+
+// the idle time the server allows with 'Keep-Alive: timeout=<seconds>'
+function serverKeepAliveTimeout(req) {
+  var res = req && req.res;
+  var header = res && res.headers && res.headers['keep-alive'];
+  var match = header && /timeout=(\d+)/i.exec(header);
+  // leave a second for the server to close it first
+  return match ? (match[1] - 1) * 1000 : -1;
+}
+
+Agent.prototype.parkSocket = function(socket, name) {
+  if (socket.destroyed) return false;
+
+  var timeout = this.freeSocketTimeout;
+  var serverTimeout = serverKeepAliveTimeout(socket._httpMessage);
+  if (serverTimeout !== -1 && serverTimeout < timeout) timeout = serverTimeout;
+  if (timeout <= 0) return false;
+
+  var freeSockets = this.freeSockets[name];
+  if (!freeSockets) {
+    freeSockets = this.freeSockets[name] = [];
+  }
+  if (freeSockets.length >= this.maxFreeSockets) return false;
+
+  // parked sockets don't count against maxSockets
+  var sockets = this.sockets[name];
+  var index = sockets ? sockets.indexOf(socket) : -1;
+  if (index !== -1) {
+    sockets.splice(index, 1);
+    if (sockets.length === 0) {
+      delete this.sockets[name];
+    }
+  }
+
+  socket._httpMessage = null;
+  socket.setKeepAlive(true, this.keepAliveMsecs);
+  socket.setTimeout(timeout, freeSocketTimeoutListener);
+  socket.on('error', freeSocketErrorListener);
+  // an idle pool doesn't keep the process alive
+  socket.unref();
+  freeSockets.push(socket);
+  return true;
+};
+
+Agent.prototype.takeFreeSocket = function(name) {
+  var freeSockets = this.freeSockets[name];
+  if (!freeSockets) return null;
+
+  var socket = freeSockets.pop();
+  if (freeSockets.length === 0) {
+    // don't leak
+    delete this.freeSockets[name];
+  }
+
+  socket.setTimeout(0, freeSocketTimeoutListener);
+  socket.removeListener('error', freeSocketErrorListener);
+  socket.ref();
+  this.sockets[name].push(socket);
+  return socket;
+};
+
+Agent.prototype.destroy = function() {
+  var self = this;
+  [self.freeSockets, self.sockets].forEach(function(pool) {
+    Object.keys(pool).forEach(function(name) {
+      // destroy() removes the socket from the pool
+      pool[name].slice().forEach(function(socket) {
+        socket.destroy();
+      });
+    });
+  });
+};
 
 Agent.prototype.defaultPort = 80;
 Agent.prototype.addRequest = function(req, host, port, localAddress) {
@@ -890,7 +988,11 @@ Agent.prototype.addRequest = function(req, host, port, localAddress) {
   if (!this.sockets[name]) {
     this.sockets[name] = [];
   }
-  if (this.sockets[name].length < this.maxSockets) {
+  var socket = this.takeFreeSocket(name);
+  if (socket) {
+    debug('AGENT reusing a free socket');
+    req.onSocket(socket);
+  } else if (this.sockets[name].length < this.maxSockets) {
     // If we are under maxSockets create a new one.
     req.onSocket(this.createSocket(name, host, port, localAddress, req));
   } else {
@@ -948,16 +1050,19 @@ Agent.prototype.createSocket = function(name, host, port, localAddress, req) {
 };
 Agent.prototype.removeSocket = function(s, name, host, port,
     localAddress) {// pin("Agent.prototype.removeSocket");
-  if (this.sockets[name]) {
-    var index = this.sockets[name].indexOf(s);
-    if (index !== -1) {
-      this.sockets[name].splice(index, 1);
-      if (this.sockets[name].length === 0) {
-        // don't leak
-        delete this.sockets[name];
+  var self = this;
+  [self.sockets, self.freeSockets].forEach(function(pool) {
+    if (pool[name]) {
+      var index = pool[name].indexOf(s);
+      if (index !== -1) {
+        pool[name].splice(index, 1);
+        if (pool[name].length === 0) {
+          // don't leak
+          delete pool[name];
+        }
       }
     }
-  }
+  });
   if (this.requests[name] && this.requests[name].length) {
     var req = this.requests[name][0];
     // If we have pending requests and a socket gets closed a new one
@@ -65,6 +65,26 @@ _store.remove = function(key) {
   $uw.removeMap(process.threadId, key + '');
 };
 
+_store.memoryUsage = function() {
+  return $uw.statsMap(process.threadId);
+};
+
+_store.allocatorUsage = function() {
+  return $uw.statsAllocator();
+};
+
+var checkSamplingRate = function(rate) {
+  var n = parseInt(rate);
+  if (isNaN(n) || n < 0) {
+    throw new TypeError('sampling rate has to be a non-negative integer');
+  }
+  return n;
+};
+
+_store.setKeySampling = function(rate) {
+  $uw.samplingMap(process.threadId, checkSamplingRate(rate));
+};
+
 _store.shared = {};
 
 _store.shared.exists = function(key) {
@@ -178,6 +198,14 @@ _store.shared.remove = function(key) {
   $uw.removeSource('#' + key);
 };
 
+_store.shared.memoryUsage = function() {
+  return $uw.statsSource();
+};
+
+_store.shared.setKeySampling = function(rate) {
+  $uw.samplingSource(checkSamplingRate(rate));
+};
+
 var $jxt = process.binding('jxtimers_wrap');
 _store.shared.expires = function(key, timer) {
   if (!key && key !== 0 && key !== false) {
@@ -262,7 +262,13 @@ var runner = function(param) {
       throw "did you 'return' from 'define' method? you should not!";
     }
 
-    var x = thread.call(param[1], w);
+    // callback id of the running task, see tasks.isCancelled / sendProgress
+    process.__taskMarker = param[1];
+    try {
+      var x = thread.call(param[1], w);
+    } finally {
+      process.__taskMarker = -1;
+    }
     delete w;
     delete param[1];
     delete param[2];
@@ -156,6 +156,11 @@ var emitMessage = function(obj) {
   exports.emit('message', t, d);
 };
 
+// callback ids of the scheduled tasks with a progress listener / a cancel
+// request
+var progressListeners = Object.create(null);
+var cancelled = Object.create(null);
+
 var gcc = function(arr) {
   if (exiting) {
     return;
@@ -166,6 +171,12 @@ var gcc = function(arr) {
 
     var obj = JSON.parse(arr[o]);
 
+    if (obj && obj.progress) {// partial result, the task is still running
+      var listener = progressListeners[obj._id];
+      if (listener) listener(obj.data);
+      continue;
+    }
+
     if (!obj || obj._id == -2)// runOnce
     {
       cbb++;
@@ -214,18 +225,34 @@ var gcc = function(arr) {
 
     var cb = (obj._id || obj._id === 0) ? markers[obj._id] : 0;
     cbb++;
+
+    delete progressListeners[obj._id];
+    if (cancelled[obj._id]) {
+      delete cancelled[obj._id];
+      uw.releaseTask(obj._id);
+      // a task that has returned a result has completed, the result wins
+      if (obj.dummy) obj.cancelled = true;
+    }
     if (!cb && obj.dummy) {
       delete obj;
       continue;
     }
 
     if (cb) {
-      if (obj.dummy) {
+      delete markers[obj._id];
+      if (obj.expired) {
+        var err = new Error('Task deadline has passed before it started');
+        err.code = 'ETASKEXPIRED';
+        cb(err);
+      } else if (obj.cancelled) {
+        var err = new Error('Task was cancelled');
+        err.code = 'ECANCELED';
+        cb(err);
+      } else if (obj.dummy) {
         cb(null);
       } else {
         cb(null, obj.o);
       }
-      delete markers[obj._id];
     }
     delete obj;
   }
@@ -262,6 +289,87 @@ exports.emit = function(event, p1, p2, p3) {
   }
 };
 
+// publish / subscribe channels. a published message is serialized once and
+// queued natively for the subscribed threads only
+var channels = Object.create(null);
+var channelListening = false;
+var channelDrainScheduled = false;
+
+var checkTopic = function(topic) {
+  if (!topic || !topic.substr) {
+    throw new TypeError('expects topic as a non-empty string');
+  }
+};
+
+var drainChannels = function() {
+  channelDrainScheduled = false;
+
+  // [topic, threadId, data, topic, ...]
+  var arr = uw.pullChannel();
+  for (var i = 0, ln = arr.length; i < ln; i += 3) {
+    var list = channels[arr[i]];
+    if (!list) continue;
+
+    var data = JSON.parse(arr[i + 2]);
+    list = list.slice(0);
+    for (var o = 0; o < list.length; o++) {
+      list[o](data, arr[i + 1], arr[i]);
+    }
+  }
+};
+
+exports.subscribe = function(topic, cb) {
+  checkTopic(topic);
+  if (typeof cb !== 'function') {
+    throw new TypeError('expects callback as a function');
+  }
+
+  if (!channelListening) {
+    channelListening = true;
+    process.on('channelMessage', drainChannels);
+  }
+
+  if (!channels[topic]) {
+    channels[topic] = [];
+    uw.subscribe(topic);
+  }
+  channels[topic].push(cb);
+};
+
+exports.unsubscribe = function(topic, cb) {
+  checkTopic(topic);
+
+  var list = channels[topic];
+  if (!list) return;
+
+  if (cb) {
+    var index = list.indexOf(cb);
+    if (index >= 0) list.splice(index, 1);
+  } else {
+    list.length = 0;
+  }
+
+  if (!list.length) {
+    delete channels[topic];
+    uw.unsubscribe(topic);
+  }
+};
+
+exports.publish = function(topic, obj) {
+  checkTopic(topic);
+
+  var data = JSON.stringify(obj);
+  var count = uw.publish(topic, data === undefined ? 'null' : data);
+
+  // the publishing thread isn't pinged for its own messages
+  if (channels[topic] && !channelDrainScheduled) {
+    channelDrainScheduled = true;
+    process.nextTick(drainChannels);
+  }
+
+  return count;
+};
+
 var taskId = 1;
 
 var isFunction = function(method) {
@@ -325,8 +433,6 @@ exports.addTask = function(method, param, cb) {
 };
 
 exports._addTask = function(method, param, cb) {
-  var cbId = trackerId, tId;
-
   if (process.subThread) {
     throw new Error(
         'You can not add a task under a subthread.');
@@ -368,6 +474,20 @@ exports._addTask = function(method, param, cb) {
     };
   }
 
+  pushTask(method, param, cb, priorities.normal, 0);
+};
+
+var priorities = {
+  'high': 0,
+  'normal': 1,
+  'low': 2
+};
+
+var priorityNames = ['high', 'normal', 'low'];
+
+var pushTask = function(method, param, cb, priority, timeout) {
+  var cbId = trackerId, tId;
+
   exports.begin();
 
   if (method._taskId) {
@@ -386,7 +506,8 @@ exports._addTask = function(method, param, cb) {
     cbId = -1;
   }
 
-  var err = uw.addTask(tId, method, param, cbId, false);
+  var err = uw.addTask(tId, method, param, cbId, false, false, priority,
+                       timeout);
 
   if (err > 0) {
     throw new Error('Thread creation error. id:' + err);
@@ -398,6 +519,92 @@ exports._addTask = function(method, param, cb) {
     gcc_alive = true;
     runCinter();
   }
+
+  return cbId;
+};
+
+// returned by tasks.scheduleTask
+function Task(id) {
+  this._id = id;
+}
+
+Task.prototype.cancel = function() {
+  if (!markers[this._id] || cancelled[this._id]) return false;
+
+  cancelled[this._id] = true;
+  uw.cancelTask(this._id);
+  return true;
+};
+
+exports.scheduleTask = function(options, method, param, cb) {
+  if (process.subThread) {
+    throw new Error(
+        'You can not add a task under a subthread.');
+  }
+
+  options = options || {};
+
+  var priority = priorities.normal;
+  if (options.priority !== undefined) {
+    priority = typeof options.priority === 'string' ?
+        priorities[options.priority] : options.priority;
+    if (priority !== 0 && priority !== 1 && priority !== 2) {
+      throw new RangeError(
+          'priority expects \'high\', \'normal\', \'low\' or 0 to 2');
+    }
+  }
+
+  var timeout = 0;
+  if (options.deadline !== undefined) {
+    timeout = parseInt(options.deadline);
+    if (isNaN(timeout) || timeout <= 0) {
+      throw new RangeError('deadline expects a positive number (ms)');
+    }
+  }
+
+  if (options.onProgress !== undefined &&
+      typeof options.onProgress !== 'function') {
+    throw new TypeError('onProgress expects a function');
+  }
+
+  if (param === undefined)
+    param = 'null';
+  else
+    param = JSON.stringify(param);
+
+  // the handle needs a callback id even if the caller isn't interested in
+  // the result
+  var id = pushTask(method, param, cb || function(err, result) {}, priority,
+                    timeout);
+  if (options.onProgress) progressListeners[id] = options.onProgress;
+
+  return new Task(id);
+};
+
+exports.isCancelled = function() {
+  var id = process.__taskMarker;
+  if (!process.subThread || id === undefined || id < 0) return false;
+
+  return uw.isTaskCancelled(id);
+};
+
+exports.sendProgress = function(data) {
+  var id = process.__taskMarker;
+  if (!process.subThread || id === undefined || id < 0) {
+    throw new Error('sendProgress can only be called from a running task');
+  }
+
+  uw.sendToAll(-1, JSON.stringify({ _id: id, progress: true, data: data }),
+               process.threadId);
+};
+
+exports.getQueueStats = function() {
+  var arr = uw.queueStats();
+  var stats = {};
+  for (var i = 0; i < arr.length; i++) {
+    stats[priorityNames[i]] = arr[i];
+  }
+  return stats;
 };
 
 exports.runOnce = function(method, param, doNotRemember, skip_thread_creation) {
@@ -3,6 +3,7 @@
 // Query String Utilities
 
 var QueryString = exports;
+var qsw = process.binding('querystring_wrap');
 
 // If obj.hasOwnProperty has been overridden, then calling
 // obj.hasOwnProperty(prop) will break.
@@ -81,7 +82,11 @@ QueryString.unescapeBuffer = function(s, decodeSpaces) {
   return out.slice(0, outIndex - 1);
 };
 
-QueryString.unescape = function(s, decodeSpaces) {
+// decodeURIComponent or unescapeBuffer when decodeURIComponent throws
+// see src/wrappers/querystring_wrap.cc
+var defaultUnescape = QueryString.unescape = function(s, decodeSpaces) {
+  if (typeof s === 'string') return qsw.unescape(s, decodeSpaces);
+
   try {
     return decodeURIComponent(s);
   } catch (e) {
@@ -138,6 +143,29 @@ QueryString.stringify = QueryString.encode = function(obj, sep, eq, name) {
 QueryString.parse = QueryString.decode = function(qs, sep, eq, options) {
   sep = sep || '&';
   eq = eq || '=';
+
+  var maxKeys = 1000;
+  if (options && typeof options.maxKeys === 'number') {
+    maxKeys = options.maxKeys;
+  }
+
+  var decode = QueryString.unescape;
+  if (options && typeof options.decodeURIComponent === 'function') {
+    decode = options.decodeURIComponent;
+  }
+
+  // the native parser does the splitting and the unescaping in one pass.
+  // custom decoders and the separators that would be affected by the '+' to
+  // '%20' replacement below go through the JS implementation
+  if (decode === defaultUnescape &&
+      (typeof qs === 'string' || Buffer.isBuffer(qs)) &&
+      typeof sep === 'string' && typeof eq === 'string' &&
+      !/[+%20]/.test(eq)) {
+    if (!(maxKeys > 0 && maxKeys < 0x7fffffff))
+      maxKeys = 0;
+    return qsw.parse(qs, sep, eq, Math.ceil(maxKeys));
+  }
+
   var obj = {};
 
   if (typeof qs !== 'string' || qs.length === 0) { return obj; }
@@ -145,11 +173,6 @@ QueryString.parse = QueryString.decode = function(qs, sep, eq, options) {
   var regexp = /\+/g;
   qs = qs.split(sep);
 
-  var maxKeys = 1000;
-  if (options && typeof options.maxKeys === 'number') {
-    maxKeys = options.maxKeys;
-  }
-
   var len = qs.length;
   // maxKeys <= 0 means that we should not limit keys count
   if (maxKeys > 0 && len > maxKeys) {
@@ -167,8 +190,8 @@ QueryString.parse = QueryString.decode = function(qs, sep, eq, options) {
       vstr = '';
     }
 
-    k = QueryString.unescape(kstr, true);
-    v = QueryString.unescape(vstr, true);
+    k = decode(kstr, true);
+    v = decode(vstr, true);
 
     if (!hasOwnProperty(obj, k)) {
       obj[k] = v;
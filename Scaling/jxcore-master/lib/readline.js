@@ -12,6 +12,7 @@ var kBufSize = 10 * 1024;
 var util = require('util');
 var inherits = require('util').inherits;
 var EventEmitter = require('events').EventEmitter;
+var LineSplitter = process.binding('line_splitter_wrap').LineSplitter;
 
 exports.createInterface = function(input, output, completer, terminal) {
   var rl;
@@ -91,8 +92,8 @@ function Interface(input, output, completer, terminal) {
       input.removeListener('data', ondata);
       input.removeListener('end', onend);
     });
-    var StringDecoder = require('string_decoder').StringDecoder; // lazy load
-    this._decoder = new StringDecoder('utf8');
+    // \r\n, \n, or \r followed by something other than \n
+    this._splitter = new LineSplitter(true);
 
   } else {
 
@@ -265,34 +266,14 @@ Interface.prototype.write = function(d, key) {
   this.terminal ? this._ttyWrite(d, key) : this._normalWrite(d);
 };
 
-// \r\n, \n, or \r followed by something other than \n
-var lineEnding = /\r?\n|\r(?!\n)/;
 Interface.prototype._normalWrite = function(b) {
   if (b === undefined) { return; }
-  var string = this._decoder.write(b);
-  if (this._sawReturn) {
-    string = string.replace(/^\n/, '');
-    this._sawReturn = false;
-  }
+  if (typeof b === 'string') b = new Buffer(b);
 
-  if (this._line_buffer) {
-    string = this._line_buffer + string;
-    this._line_buffer = null;
-  }
-  if (lineEnding.test(string)) {
-    this._sawReturn = /\r$/.test(string);
-
-    // got one or more newlines; process into "line" events
-    var lines = string.split(lineEnding);
-    // either '' or (concievably) the unfinished portion of the next line
-    string = lines.pop();
-    this._line_buffer = string;
-    lines.forEach(function(line) {
-      this._onLine(line);
-    }, this);
-  } else if (string) {
-    // no newlines this time, save what we have for next time
-    this._line_buffer = string;
+  // the unfinished line stays in the splitter
+  var lines = this._splitter.write(b);
+  for (var i = 0; i < lines.length; i++) {
+    this._onLine(lines[i]);
   }
 };
 
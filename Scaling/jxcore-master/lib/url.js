@@ -73,7 +73,137 @@ var protocolPattern = /^([a-z0-9.+-]+:)/i,
       'gopher:': true,
       'file:': true
     },
-    querystring = require('querystring');
+    querystring = require('querystring'),
+    urlBinding = process.binding('url_wrap');
+
+// offsets of the parts in the array from urlBinding.tokenize
+// (see src/wrappers/url_wrap.h). Each part is a [start, end) pair
+var T_PROTOCOL = 0,
+    T_SLASHES = 2,
+    T_AUTH = 3,
+    T_HOSTNAME = 5,
+    T_PORT = 7,
+    T_PATHNAME = 9,
+    T_SEARCH = 11,
+    T_HASH = 13;
+
+function tokenSlice(state, index) {
+  var start = state.tokens[index];
+  if (start === -1) return null;
+  return state.url.slice(start, state.tokens[index + 1]);
+}
+
+// the parts of a tokenized url. Each one is created the first time it is
+// read and gives the same value Url.prototype.parse would have set
+var lazyParts = {
+  protocol: function(url, state) {
+    var protocol = tokenSlice(state, T_PROTOCOL);
+    return protocol && protocol.toLowerCase();
+  },
+  slashes: function(url, state) {
+    return state.tokens[T_SLASHES] ? true : null;
+  },
+  auth: function(url, state) {
+    return tokenSlice(state, T_AUTH);
+  },
+  host: function(url, state) {
+    var hostname = url.hostname;
+    if (hostname === null) return null;
+    var port = url.port;
+    return port ? hostname + ':' + port : hostname;
+  },
+  port: function(url, state) {
+    return tokenSlice(state, T_PORT);
+  },
+  hostname: function(url, state) {
+    var hostname = tokenSlice(state, T_HOSTNAME);
+    return hostname && hostname.toLowerCase();
+  },
+  hash: function(url, state) {
+    return tokenSlice(state, T_HASH);
+  },
+  search: function(url, state) {
+    var search = tokenSlice(state, T_SEARCH);
+    if (search === null && state.parseQueryString) return '';
+    return search;
+  },
+  query: function(url, state) {
+    var search = tokenSlice(state, T_SEARCH);
+    if (search === null) return state.parseQueryString ? {} : null;
+    if (state.parseQueryString) return querystring.parse(search.substr(1));
+    return search.substr(1);
+  },
+  pathname: function(url, state) {
+    var pathname = tokenSlice(state, T_PATHNAME);
+    if (pathname) return pathname;
+    if (slashedProtocol[url.protocol] && url.hostname) return '/';
+    return null;
+  },
+  path: function(url, state) {
+    var pathname = url.pathname, search = url.search;
+    if (!pathname && !search) return null;
+    return (pathname || '') + (search || '');
+  },
+  href: function(url, state) {
+    return url.format();
+  }
+};
+
+// creates the parts which weren't read yet, so the values (href) don't
+// depend on the later changes
+function materialize(url) {
+  if (!url._lazy) return;
+
+  // all of them are read through the getters before any is replaced
+  var values = {};
+  for (var name in lazyParts) {
+    values[name] = url[name];
+  }
+  for (var name in lazyParts) {
+    Object.defineProperty(url, name, {
+      value: values[name],
+      enumerable: true,
+      writable: true,
+      configurable: true
+    });
+  }
+  delete url._lazy;
+  delete url.inspect;
+}
+
+// the part stays an accessor after it's read, a write to any of them still
+// materializes the rest first
+function lazyDescriptor(name) {
+  var part = lazyParts[name];
+  return {
+    enumerable: true,
+    configurable: true,
+    get: function() {
+      var values = this._lazy.values;
+      if (!values.hasOwnProperty(name)) values[name] = part(this, this._lazy);
+      return values[name];
+    },
+    set: function(value) {
+      materialize(this);
+      this[name] = value;
+    }
+  };
+}
+
+var lazyDescriptors = {};
+Object.keys(lazyParts).forEach(function(name) {
+  lazyDescriptors[name] = lazyDescriptor(name);
+});
+
+// util.inspect would show the parts as [Getter/Setter]
+lazyDescriptors.inspect = {
+  configurable: true,
+  writable: true,
+  value: function(recurseTimes) {
+    materialize(this);
+    return require('util').inspect(this, { depth: recurseTimes });
+  }
+};
 
 function urlParse(url, parseQueryString, slashesDenoteHost) {
   if (url && typeof(url) === 'object' && url instanceof Url) return url;
@@ -88,6 +218,24 @@ Url.prototype.parse = function(url, parseQueryString, slashesDenoteHost) {
     throw new TypeError("Parameter 'url' must be a string, not " + typeof url);
   }
 
+  // the plain urls are only tokenized here (one native pass), the parts are
+  // sliced out of the string when they are read
+  var tokens = urlBinding.tokenize(url, !!slashesDenoteHost);
+  if (tokens) {
+    Object.defineProperty(this, '_lazy', {
+      value: {
+        url: url,
+        tokens: tokens,
+        parseQueryString: !!parseQueryString,
+        values: {}
+      },
+      writable: true,
+      configurable: true
+    });
+    Object.defineProperties(this, lazyDescriptors);
+    return this;
+  }
+
   // Copy chrome, IE, opera backslash-handling behavior.
   // See: https://code.google.com/p/chromium/issues/detail?id=25916
   var hashSplit = url.split('#');
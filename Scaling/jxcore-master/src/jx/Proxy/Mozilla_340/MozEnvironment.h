@@ -32,6 +32,10 @@ typedef bool (*JS_NATIVE_METHOD)(JSContext *ctx, unsigned argc, JS::Value *val);
     for (int i = -1; i < x; i++) JS_SetRTGC(__contextORisolate, true); \
   } while (0)
 
+// JS_MaybeGC collects when the heap grew enough since the last GC, it has no
+// time budget or incremental steps
+#define JS_IDLE_NOTIFICATION(ms) (JS_MaybeGC(__contextORisolate), true)
+
 #define JS_TERMINATE_EXECUTION(mcom)                                      \
   do {                                                                    \
     node::commons* __mcom__ = node::commons::getInstanceByThreadId(mcom); \
@@ -41,6 +41,10 @@ typedef void (*JS_FINALIZER_METHOD)(JS_HANDLE_VALUE_REF val, void *data);
 
 #define JS_FORCE_GC() v8::V8::LowMemoryNotification()
 
+// true when there is nothing left for the idle time. hint is the amount of
+// work (1 to 1000, at least 20 is done), not a time limit
+#define JS_IDLE_NOTIFICATION(hint) v8::V8::IdleNotification(hint)
+
 #define JS_TERMINATE_EXECUTION(mcom)                                      \
   do {                                                                    \
     node::commons *__mcom__ = node::commons::getInstanceByThreadId(mcom); \
@@ -42,6 +42,9 @@ typedef void (*JS_FINALIZER_METHOD)(JS_HANDLE_VALUE_REF val, void *data);
 
 #define JS_FORCE_GC() __contextORisolate->LowMemoryNotification()
 
+// true when there is nothing left for the idle time
+#define JS_IDLE_NOTIFICATION(ms) __contextORisolate->IdleNotification(ms)
+
 #define JS_TERMINATE_EXECUTION(mcom)                                      \
   do {                                                                    \
     node::commons *__mcom__ = node::commons::getInstanceByThreadId(mcom); \
@@ -103,6 +103,7 @@
 #include <assert.h>
 #include <stddef.h>
 #include <string.h>
+#include <stdint.h>
 #include <sys/types.h>
 #include <algorithm>
 #include <functional>
@@ -244,6 +245,76 @@ struct btree_key_compare_to_adapter<std::greater<std::string> >
   }
 };
 
+// The first 16 bytes of a string key as big-endian integers (zero padded)
+// and the key length. Comparing two prefixes orders the keys the way
+// std::string::compare does, unless both keys are longer than the prefix and
+// the prefixes are equal. 16 bytes reach past the namespaces ("session:")
+// the store keys usually start with.
+struct btree_key_prefix {
+  enum {
+    kPrefixWords = 2,
+    kPrefixBytes = kPrefixWords * 8,
+    // compare() result when only the full keys can tell
+    kPrefixTie = 2,
+  };
+
+  btree_key_prefix() : length(0) {
+    for (int w = 0; w < kPrefixWords; ++w) {
+      words[w] = 0;
+    }
+  }
+  explicit btree_key_prefix(const std::string &k) {
+    const size_t n = std::min<size_t>(k.size(), kPrefixBytes);
+    for (int w = 0; w < kPrefixWords; ++w) {
+      words[w] = 0;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      words[i / 8] |=
+        uint64_t(static_cast<unsigned char>(k[i])) << (56 - 8 * (i % 8));
+    }
+    // only the lengths up to kPrefixBytes are compared
+    const size_t max_length = std::numeric_limits<uint32_t>::max();
+    length = static_cast<uint32_t>(std::min<size_t>(k.size(), max_length));
+  }
+
+  // Returns -1, 0 or 1 like the comparison of the keys, or kPrefixTie.
+  int compare(const btree_key_prefix &x) const {
+    for (int w = 0; w < kPrefixWords; ++w) {
+      if (words[w] != x.words[w]) {
+        return words[w] < x.words[w] ? -1 : 1;
+      }
+    }
+    if (length > kPrefixBytes && x.length > kPrefixBytes) {
+      return kPrefixTie;
+    }
+    // the shorter key is a prefix of the other one
+    return length < x.length ? -1 : (length > x.length ? 1 : 0);
+  }
+
+  uint64_t words[kPrefixWords];
+  uint32_t length;
+};
+
+// A helper class that indicates if the keys are ordered byte by byte. The
+// nodes of such btrees keep a btree_key_prefix beside every value and search
+// the prefixes before the keys.
+template <typename Key, typename Compare>
+struct btree_key_prefixer {
+  enum { kEnabled = 0 };
+  static btree_key_prefix make(const Key&) {
+    return btree_key_prefix();
+  }
+};
+
+template <>
+struct btree_key_prefixer<
+  std::string, btree_key_compare_to_adapter<std::less<std::string> > > {
+  enum { kEnabled = 1 };
+  static btree_key_prefix make(const std::string &k) {
+    return btree_key_prefix(k);
+  }
+};
+
 // A helper class that allows a compare-to functor to behave like a plain
 // compare functor. This specialization is used when we do not have a
 // compare-to functor.
@@ -447,6 +518,20 @@ struct btree_binary_search_compare_to {
   }
 };
 
+// Dispatch helper class for using binary search over the key prefixes.
+template <typename K, typename N, typename CompareTo>
+struct btree_binary_search_prefixed {
+  static int lower_bound(const K &k, const N &n, CompareTo comp)  {
+    return n.binary_search_prefixed(
+             k, btree_key_prefixer<K, CompareTo>::make(k), 0, n.count(), comp);
+  }
+  static int upper_bound(const K &k, const N &n, CompareTo comp)  {
+    typedef btree_upper_bound_adapter<K,
+            btree_key_comparer<K, CompareTo, true> > upper_compare;
+    return n.linear_search_plain_compare(k, 0, n.count(), upper_compare(comp));
+  }
+};
+
 // A node in the btree holding. The same node type is used for both internal
 // and leaf nodes in the btree, though the nodes are allocated in such a way
 // that the children array is only valid in internal nodes.
@@ -475,6 +560,9 @@ public:
   key_type, self_type, key_compare> binary_search_plain_compare_type;
   typedef btree_binary_search_compare_to<
   key_type, self_type, key_compare> binary_search_compare_to_type;
+  typedef btree_binary_search_prefixed<
+  key_type, self_type, key_compare> binary_search_prefixed_type;
+  typedef btree_key_prefixer<key_type, key_compare> key_prefixer;
   // If we have a valid key-compare-to type, use linear_search_compare_to,
   // otherwise use linear_search_plain_compare.
   typedef typename if_<
@@ -493,7 +581,12 @@ public:
   typedef typename if_<
   is_integral<key_type>::value ||
   is_floating_point<key_type>::value,
-                    linear_search_type, binary_search_type>::type search_type;
+                    linear_search_type,
+                    binary_search_type>::type key_search_type;
+  // Keys ordered byte by byte are searched by their prefixes.
+  typedef typename if_<
+  key_prefixer::kEnabled,
+               binary_search_prefixed_type, key_search_type>::type search_type;
 
   struct base_fields {
     typedef typename Params::node_count_type field_type;
@@ -514,18 +607,30 @@ public:
     kValueSize = params_type::kValueSize,
     kTargetNodeSize = params_type::kTargetNodeSize,
 
+    // The prefixes take space beside the values, if the keys have any.
+    kPrefixSize = key_prefixer::kEnabled ? sizeof(btree_key_prefix) : 0,
+
     // Compute how many values we can fit onto a leaf node.
-    kNodeTargetValues = (kTargetNodeSize - sizeof(base_fields)) / kValueSize,
+    kNodeTargetValues =
+      (kTargetNodeSize - sizeof(base_fields)) / (kValueSize + kPrefixSize),
     // We need a minimum of 3 values per internal node in order to perform
     // splitting (1 value for the two nodes involved in the split and 1 value
     // propagated to the parent as the delimiter for the split).
     kNodeValues = kNodeTargetValues >= 3 ? kNodeTargetValues : 3,
+    kNodePrefixes = key_prefixer::kEnabled ? kNodeValues : 1,
 
     kExactMatch = 1 << 30,
     kMatchMask = kExactMatch - 1,
   };
 
-  struct leaf_fields : public base_fields {
+  struct prefix_fields : public base_fields {
+    // The prefixes of the keys of the values. Unused (a single entry) when
+    // the keys have no prefix. A leaf root smaller than the full node size
+    // still has them all.
+    btree_key_prefix prefixes[kNodePrefixes];
+  };
+
+  struct leaf_fields : public prefix_fields {
     // The array of values. Only the first count of these values have been
     // constructed and are valid.
     mutable_value_type values[kNodeValues];
@@ -617,6 +722,9 @@ public:
   // Swap value i in this node with value j in node x.
   void value_swap(int i, btree_node *x, int j) {
     params_type::swap(mutable_value(i), x->mutable_value(j));
+    if (key_prefixer::kEnabled) {
+      btree_swap_helper(fields_.prefixes[i], x->fields_.prefixes[j]);
+    }
   }
 
   // Getters/setter for the child at position i in the node.
@@ -714,6 +822,31 @@ public:
     return s;
   }
 
+  // Returns the position of the first value whose key is not less than k
+  // using binary search over the key prefixes. p is the prefix of k, the
+  // keys themselves are only compared on prefix ties.
+  template <typename CompareTo>
+  int binary_search_prefixed(const key_type &k, const btree_key_prefix &p,
+                             int s, int e, const CompareTo &comp) const {
+    while (s != e) {
+      int mid = (s + e) / 2;
+      int c = fields_.prefixes[mid].compare(p);
+      if (c == btree_key_prefix::kPrefixTie) {
+        c = comp(key(mid), k);
+      }
+      if (c < 0) {
+        s = mid + 1;
+      } else if (c > 0) {
+        e = mid;
+      } else {
+        // See binary_search_compare_to.
+        s = binary_search_prefixed(k, p, s, mid, comp);
+        return s | kExactMatch;
+      }
+    }
+    return s;
+  }
+
   // Inserts the value x at position i, shifting all existing values and
   // children at positions >= i to the right by 1.
   void insert_value(int i, const value_type &x);
@@ -773,9 +906,15 @@ public:
 private:
   void value_init(int i) {
     new (&fields_.values[i]) mutable_value_type;
+    if (key_prefixer::kEnabled) {
+      fields_.prefixes[i] = btree_key_prefix();
+    }
   }
   void value_init(int i, const value_type &x) {
     new (&fields_.values[i]) mutable_value_type(x);
+    if (key_prefixer::kEnabled) {
+      fields_.prefixes[i] = key_prefixer::make(params_type::key(x));
+    }
   }
   void value_destroy(int i) {
     fields_.values[i].~mutable_value_type();
@@ -911,6 +1050,7 @@ class btree : public Params::key_compare {
   typedef btree<Params> self_type;
   typedef btree_node<Params> node_type;
   typedef typename node_type::base_fields base_fields;
+  typedef typename node_type::prefix_fields prefix_fields;
   typedef typename node_type::leaf_fields leaf_fields;
   typedef typename node_type::internal_fields internal_fields;
   typedef typename node_type::root_fields root_fields;
@@ -1234,7 +1374,7 @@ public:
     node_stats stats = internal_stats(root());
     if (stats.leaf_nodes == 1 && stats.internal_nodes == 0) {
       return sizeof(*this) +
-             sizeof(base_fields) + root()->max_count() * sizeof(value_type);
+             sizeof(prefix_fields) + root()->max_count() * sizeof(value_type);
     } else {
       return sizeof(*this) +
              sizeof(root_fields) - sizeof(internal_fields) +
@@ -1331,7 +1471,7 @@ private:
   node_type* new_leaf_root_node(int max_count) {
     leaf_fields *p = reinterpret_cast<leaf_fields*>(
                        mutable_internal_allocator()->allocate(
-                         sizeof(base_fields) + max_count * sizeof(value_type)));
+                         sizeof(prefix_fields) + max_count * sizeof(value_type)));
     return node_type::init_leaf(p, reinterpret_cast<node_type*>(p), max_count);
   }
   void delete_internal_node(node_type *node) {
@@ -1349,7 +1489,7 @@ private:
     node->destroy();
     mutable_internal_allocator()->deallocate(
       reinterpret_cast<char*>(node),
-      sizeof(base_fields) + node->max_count() * sizeof(value_type));
+      sizeof(prefix_fields) + node->max_count() * sizeof(value_type));
   }
 
   // Rebalances or splits the node iter points to.
@@ -0,0 +1,187 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "buffer_allocator.h"
+#include "commons.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct FreeBuffer {
+  FreeBuffer *next_;
+};
+
+struct BufferCache {
+  // only used by the owner thread
+  FreeBuffer *head_[BUFFER_SIZE_CLASSES];
+  int count_[BUFFER_SIZE_CLASSES];
+  int64_t external_;  // not reported to the engine yet
+  BufferAllocatorStats stats_;
+
+  // the other threads push the blocks they free here, the owner takes the
+  // whole list once it needs a block of that class
+  uv_mutex_t return_lock_;
+  FreeBuffer *returned_[BUFFER_SIZE_CLASSES];
+  int returned_count_[BUFFER_SIZE_CLASSES];
+};
+
+static BufferCache caches[MAX_JX_THREADS];
+static uv_once_t caches_once = UV_ONCE_INIT;
+
+#define CLASS_SIZE(n) ((size_t)1 << ((n) + BUFFER_MIN_CLASS_SHIFT))
+#define CLASS_LIMIT(n)                                               \
+  (CLASS_SIZE(n) * BUFFER_CACHE_MIN > BUFFER_CACHE_BYTES             \
+       ? BUFFER_CACHE_MIN                                            \
+       : (int)(BUFFER_CACHE_BYTES / CLASS_SIZE(n)))
+
+static void InitCaches() {
+  memset(caches, 0, sizeof(caches));
+  for (int i = 0; i < MAX_JX_THREADS; i++) {
+    uv_mutex_init(&caches[i].return_lock_);
+  }
+}
+
+// the buffers bigger than half of the first class keep using malloc, the
+// pool chunks are exactly 8KB
+static inline int GetSizeClass(const size_t size) {
+  if (size <= CLASS_SIZE(0) / 2) return -1;
+  for (int i = 0; i < BUFFER_SIZE_CLASSES; i++) {
+    if (size <= CLASS_SIZE(i)) return i;
+  }
+  return -1;
+}
+
+static inline bool HasCache(const int tid) {
+  return tid >= 0 && tid < MAX_JX_THREADS;
+}
+
+// moves the returned blocks of the class to the free list, the ones above
+// the class limit are freed
+static void TakeReturned(BufferCache *cache, const int cls) {
+  uv_mutex_lock(&cache->return_lock_);
+  FreeBuffer *block = cache->returned_[cls];
+  cache->returned_[cls] = NULL;
+  cache->returned_count_[cls] = 0;
+  uv_mutex_unlock(&cache->return_lock_);
+
+  while (block != NULL) {
+    FreeBuffer *next = block->next_;
+    if (cache->count_[cls] < CLASS_LIMIT(cls)) {
+      block->next_ = cache->head_[cls];
+      cache->head_[cls] = block;
+      cache->count_[cls]++;
+    } else {
+      free(block);
+    }
+    block = next;
+  }
+}
+
+char *BufferAllocator::New(const int tid, const size_t length) {
+  const int cls = GetSizeClass(length);
+  if (cls < 0 || !HasCache(tid)) return (char *)malloc(length);
+  // the free lists belong to the owner thread
+  if (node::commons::threadIdFromThreadPrivate() != tid)
+    return (char *)malloc(CLASS_SIZE(cls));
+
+  uv_once(&caches_once, InitCaches);
+  BufferCache *cache = &caches[tid];
+  cache->stats_.allocs_++;
+
+  // read without the lock, a block returned meanwhile waits for the next
+  // allocation
+  if (cache->head_[cls] == NULL && cache->returned_[cls] != NULL)
+    TakeReturned(cache, cls);
+
+  FreeBuffer *block = cache->head_[cls];
+  if (block == NULL) return (char *)malloc(CLASS_SIZE(cls));
+
+  cache->head_[cls] = block->next_;
+  cache->count_[cls]--;
+  cache->stats_.reuses_++;
+  return (char *)block;
+}
+
+void BufferAllocator::Delete(const int tid, char *data, const size_t length) {
+  if (data == NULL) return;
+
+  const int cls = GetSizeClass(length);
+  if (cls < 0 || !HasCache(tid)) {
+    free(data);
+    return;
+  }
+
+  uv_once(&caches_once, InitCaches);
+  BufferCache *cache = &caches[tid];
+  FreeBuffer *block = (FreeBuffer *)data;
+
+  if (node::commons::threadIdFromThreadPrivate() != tid) {
+    uv_mutex_lock(&cache->return_lock_);
+    block->next_ = cache->returned_[cls];
+    cache->returned_[cls] = block;
+    cache->returned_count_[cls]++;
+    uv_mutex_unlock(&cache->return_lock_);
+    return;
+  }
+
+  cache->stats_.frees_++;
+  if (cache->count_[cls] >= CLASS_LIMIT(cls)) {
+    free(data);
+    return;
+  }
+
+  block->next_ = cache->head_[cls];
+  cache->head_[cls] = block;
+  cache->count_[cls]++;
+}
+
+int64_t BufferAllocator::AdjustExternal(const int tid, const int64_t change) {
+  if (!HasCache(tid)) return change;
+
+  BufferCache *cache = &caches[tid];
+  cache->external_ += change;
+  if (cache->external_ < BUFFER_EXTERNAL_BATCH &&
+      cache->external_ > -BUFFER_EXTERNAL_BATCH)
+    return 0;
+
+  const int64_t report = cache->external_;
+  cache->external_ = 0;
+  return report;
+}
+
+void BufferAllocator::Trim(const int tid) {
+  if (!HasCache(tid)) return;
+
+  uv_once(&caches_once, InitCaches);
+  BufferCache *cache = &caches[tid];
+
+  for (int i = 0; i < BUFFER_SIZE_CLASSES; i++) {
+    TakeReturned(cache, i);
+    while (cache->head_[i] != NULL) {
+      FreeBuffer *block = cache->head_[i];
+      cache->head_[i] = block->next_;
+      free(block);
+    }
+    cache->count_[i] = 0;
+  }
+
+  // the engine that counted the balance is gone with the thread
+  cache->external_ = 0;
+}
+
+void BufferAllocator::GetStats(const int tid, BufferAllocatorStats *stats) {
+  memset(stats, 0, sizeof(BufferAllocatorStats));
+  if (!HasCache(tid)) return;
+
+  uv_once(&caches_once, InitCaches);
+  const BufferCache *cache = &caches[tid];
+  *stats = cache->stats_;
+  for (int i = 0; i < BUFFER_SIZE_CLASSES; i++) {
+    stats->cached_ += cache->count_[i] * CLASS_SIZE(i);
+    stats->limit_ += CLASS_LIMIT(i) * CLASS_SIZE(i);
+  }
+
+  uv_mutex_lock(&caches[tid].return_lock_);
+  for (int i = 0; i < BUFFER_SIZE_CLASSES; i++) {
+    stats->returned_ += cache->returned_count_[i] * CLASS_SIZE(i);
+  }
+  uv_mutex_unlock(&caches[tid].return_lock_);
+}
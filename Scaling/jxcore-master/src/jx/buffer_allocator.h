@@ -0,0 +1,50 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_JX_BUFFER_ALLOCATOR_H_
+#define SRC_JX_BUFFER_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Size classed allocator for the SlowBuffer memory (node_buffer.cc).
+// Every thread (commons::threadId) keeps the blocks of its freed buffers on
+// per class free lists, the 8KB pool chunks of lib/buffer.js and the large
+// stream buffers are reused without going to the global allocator. A block
+// freed by another thread goes back to its owner through the owner's return
+// list. Buffers smaller than the first class or bigger than the last one use
+// malloc.
+#define BUFFER_MIN_CLASS_SHIFT 13  // 8KB
+#define BUFFER_SIZE_CLASSES 6      // 8KB .. 256KB
+#define BUFFER_CACHE_BYTES (512 * 1024)  // per thread, per class
+#define BUFFER_CACHE_MIN 2                // blocks per class at least
+// external memory changes are reported to the engine in batches
+#define BUFFER_EXTERNAL_BATCH (256 * 1024)
+
+struct BufferAllocatorStats {
+  int64_t cached_;    // bytes on the free lists
+  int64_t limit_;     // bytes the free lists may hold
+  int64_t returned_;  // bytes freed by the other threads, not taken yet
+  int64_t allocs_;
+  int64_t reuses_;  // allocs served from the free lists
+  int64_t frees_;
+};
+
+class BufferAllocator {
+ public:
+  // tid is the jxcore thread id of the buffer's commons. blocks of the other
+  // threads (or without a valid tid) aren't cached by the caller
+  static char *New(const int tid, const size_t length);
+  static void Delete(const int tid, char *data, const size_t length);
+
+  // adds change to the thread's external memory balance. returns the amount
+  // to report to the engine now, 0 until the balance reaches the batch size
+  static int64_t AdjustExternal(const int tid, const int64_t change);
+
+  // frees the cached and returned blocks of the thread (thread exit)
+  static void Trim(const int tid);
+
+  // the stats of the thread, memory_wrap statsBuffers
+  static void GetStats(const int tid, BufferAllocatorStats *stats);
+};
+
+#endif  // SRC_JX_BUFFER_ALLOCATOR_H_
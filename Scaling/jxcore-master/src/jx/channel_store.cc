@@ -0,0 +1,189 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "channel_store.h"
+#include "commons.h"
+#include "extend.h"
+#include <bitset>
+#include <map>
+#include <queue>
+
+namespace jxcore {
+
+typedef std::bitset<MAX_JX_THREADS + 1> ChannelSubscribers;  // +1 for main
+typedef std::map<std::string, ChannelSubscribers> ChannelMap;
+
+// lock order: channel_lock -> threadLock(tid)
+static uv_mutex_t channel_lock;
+static ChannelMap channels;
+static std::queue<ChannelMessage *> inbox[MAX_JX_THREADS + 1];
+// set when a publish queues a message for the thread (threadLock(tid))
+static bool channel_ping[MAX_JX_THREADS + 1];
+static bool channels_init = false;
+
+void InitChannels() {
+  if (channels_init) return;
+  channels_init = true;
+
+  uv_mutex_init(&channel_lock);
+}
+
+bool SubscribeChannel(const std::string &topic, const int tid) {
+  assert(tid >= 0 && tid <= MAX_JX_THREADS);
+
+  uv_mutex_lock(&channel_lock);
+  ChannelSubscribers &subs = channels[topic];
+  const bool changed = !subs.test(tid);
+  subs.set(tid);
+  uv_mutex_unlock(&channel_lock);
+
+  return changed;
+}
+
+bool UnsubscribeChannel(const std::string &topic, const int tid) {
+  assert(tid >= 0 && tid <= MAX_JX_THREADS);
+  bool changed = false;
+
+  uv_mutex_lock(&channel_lock);
+  ChannelMap::iterator it = channels.find(topic);
+  if (it != channels.end()) {
+    changed = it->second.test(tid);
+    it->second.reset(tid);
+    if (it->second.none()) channels.erase(it);
+  }
+  uv_mutex_unlock(&channel_lock);
+
+  return changed;
+}
+
+// expects channel_lock
+static inline void DerefMessage(ChannelMessage *msg) {
+  if (--msg->refs_ > 0) return;
+
+  free(msg->data_);
+  delete msg;
+}
+
+void RemoveChannelThread(const int tid) {
+  if (!channels_init) return;
+  assert(tid >= 0 && tid <= MAX_JX_THREADS);
+
+  uv_mutex_lock(&channel_lock);
+  ChannelMap::iterator it = channels.begin();
+  while (it != channels.end()) {
+    it->second.reset(tid);
+    if (it->second.none()) {
+      channels.erase(it++);
+    } else {
+      it++;
+    }
+  }
+
+  threadLock(tid);
+  while (!inbox[tid].empty()) {
+    DerefMessage(inbox[tid].front());
+    inbox[tid].pop();
+  }
+  channel_ping[tid] = false;
+  threadUnlock(tid);
+  uv_mutex_unlock(&channel_lock);
+}
+
+int PublishChannel(const std::string &topic, const char *data,
+                   const int length, const int sender) {
+  bool ping[MAX_JX_THREADS + 1];
+  int count = 0;
+
+  uv_mutex_lock(&channel_lock);
+  ChannelMap::const_iterator it = channels.find(topic);
+  if (it == channels.end()) {
+    uv_mutex_unlock(&channel_lock);
+    return 0;
+  }
+
+  const ChannelSubscribers &subs = it->second;
+
+  ChannelMessage *msg = new ChannelMessage;
+  msg->topic_ = topic;
+  msg->data_ = cpystr(data, length);
+  msg->length_ = length;
+  msg->sender_ = sender;
+  msg->refs_ = subs.count();
+
+  for (int tid = 0; tid <= MAX_JX_THREADS; tid++) {
+    ping[tid] = false;
+    if (!subs.test(tid)) continue;
+
+    count++;
+    threadLock(tid);
+    inbox[tid].push(msg);
+    if (tid != sender) channel_ping[tid] = true;
+    // the sender drains its own queue, keep the ping flag of the other
+    // messages untouched
+    if (tid != sender && !threadHasMessage(tid)) {
+      setThreadMessage(tid, 1);
+      ping[tid] = true;
+    }
+    threadUnlock(tid);
+  }
+  uv_mutex_unlock(&channel_lock);
+
+  // wake up only the threads that are listening this topic
+  for (int tid = 0; tid <= MAX_JX_THREADS; tid++) {
+    if (!ping[tid]) continue;
+
+    node::commons *com = node::commons::getInstanceByThreadId(tid);
+    if (com == NULL || com->instance_status_ != node::JXCORE_INSTANCE_ALIVE ||
+        com->expects_reset || com->threadPing == NULL)
+      continue;
+
+    com->PingThread();
+  }
+
+  return count;
+}
+
+bool HasChannelMessages(const int tid) {
+  assert(tid >= 0 && tid <= MAX_JX_THREADS);
+
+  threadLock(tid);
+  const bool has = !inbox[tid].empty();
+  threadUnlock(tid);
+
+  return has;
+}
+
+bool TakeChannelPing(const int tid) {
+  assert(tid >= 0 && tid <= MAX_JX_THREADS);
+
+  threadLock(tid);
+  const bool pinged = channel_ping[tid];
+  channel_ping[tid] = false;
+  threadUnlock(tid);
+
+  return pinged;
+}
+
+void PullChannelMessages(const int tid, std::vector<ChannelMessage *> *msgs) {
+  assert(tid >= 0 && tid <= MAX_JX_THREADS);
+
+  threadLock(tid);
+  while (!inbox[tid].empty()) {
+    msgs->push_back(inbox[tid].front());
+    inbox[tid].pop();
+  }
+  threadUnlock(tid);
+}
+
+void ReleaseChannelMessages(std::vector<ChannelMessage *> *msgs) {
+  if (msgs->empty()) return;
+
+  uv_mutex_lock(&channel_lock);
+  for (size_t i = 0; i < msgs->size(); i++) {
+    DerefMessage((*msgs)[i]);
+  }
+  uv_mutex_unlock(&channel_lock);
+
+  msgs->clear();
+}
+
+}  // namespace jxcore
@@ -0,0 +1,49 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_JX_CHANNEL_STORE_H_
+#define SRC_JX_CHANNEL_STORE_H_
+
+#include <string>
+#include <vector>
+
+namespace jxcore {
+
+// A published message. The payload is copied once and shared by all the
+// subscribers of the topic, the last reader frees it.
+struct ChannelMessage {
+  std::string topic_;
+  char *data_;
+  int length_;
+  int sender_;
+  int refs_;
+};
+
+void InitChannels();
+
+// tid is commons::threadId of the subscriber (0 is the main thread)
+// both return false if nothing has changed
+bool SubscribeChannel(const std::string &topic, const int tid);
+bool UnsubscribeChannel(const std::string &topic, const int tid);
+
+// drops the subscriptions and the pending messages of a thread
+void RemoveChannelThread(const int tid);
+
+// queues the message for every subscriber of the topic and pings the
+// subscribed threads (except the sender). returns the number of subscribers
+int PublishChannel(const std::string &topic, const char *data,
+                   const int length, const int sender);
+
+bool HasChannelMessages(const int tid);
+
+// true if a publish queued a message for tid since the last call. the ping
+// may arrive after an earlier drain already took its message
+bool TakeChannelPing(const int tid);
+
+// moves the pending messages of tid to msgs. the caller has to call
+// ReleaseChannelMessages once they are consumed
+void PullChannelMessages(const int tid, std::vector<ChannelMessage *> *msgs);
+void ReleaseChannelMessages(std::vector<ChannelMessage *> *msgs);
+
+}  // namespace jxcore
+
+#endif  // SRC_JX_CHANNEL_STORE_H_
@@ -1,6 +1,7 @@
 // Copyright & License details are available under JXCORE_LICENSE file
 
 #include "commons.h"
+#include "buffer_allocator.h"
 #if defined(_MSC_VER)
 #include <windows.h>
 #else
@@ -44,37 +45,50 @@ static int threadIdCounter = 0;
 static bool jxcore_multithreaded = false;
 static bool main_thread_created_ = false;
 
+// threadId + 1 of the current thread, 0 if the thread wasn't registered.
+// InitThreadId sets it once per thread, so the hot lookups below don't need
+// a lock or a search. isolates[] is the registration table, it's only
+// updated under comLock when an instance is created or removed
 #if defined(_MSC_VER)
-static std::map<DWORD, int> coms;
+static __declspec(thread) int thread_slot = 0;
+#elif !defined(__IOS__)
+static __thread int thread_slot = 0;
 #else
-static std::map<pthread_t, int> coms;  // pthread_t.__sig
+// no __thread on the older iOS toolchains
+static pthread_key_t thread_slot_key;
+static pthread_once_t thread_slot_once = PTHREAD_ONCE_INIT;
+
+static void CreateThreadSlot() { pthread_key_create(&thread_slot_key, NULL); }
 #endif
 
 static commons *isolates[MAX_JX_THREADS] = {NULL};
 static uv_mutex_t comLock;
 
-inline commons *getCommonsISO(JS_ENGINE_MARKER isolate) {
-  int *id = (int *)JS_CURRENT_ENGINE_DATA(isolate);
-  return isolates[*id];
+inline int getThreadSlot() {
+#if !defined(__IOS__) || defined(_MSC_VER)
+  return thread_slot;
+#else
+  pthread_once(&thread_slot_once, CreateThreadSlot);
+  return (int)(intptr_t)pthread_getspecific(thread_slot_key);
+#endif
 }
 
-inline int l_threadIdFromThreadPrivate() {
-#if defined(_MSC_VER)
-  DWORD th = GetCurrentThreadId();
-  std::map<DWORD, int>::iterator it;
+inline void setThreadSlot(const int value) {
+#if !defined(__IOS__) || defined(_MSC_VER)
+  thread_slot = value;
 #else
-  pthread_t th = pthread_self();
-  std::map<pthread_t, int>::iterator it;
+  pthread_once(&thread_slot_once, CreateThreadSlot);
+  pthread_setspecific(thread_slot_key, (void *)(intptr_t)value);
 #endif
-  it = coms.find(th);
-
-  if (it != coms.end()) {
-    return it->second;
-  }
+}
 
-  return -1;
+inline commons *getCommonsISO(JS_ENGINE_MARKER isolate) {
+  int *id = (int *)JS_CURRENT_ENGINE_DATA(isolate);
+  return isolates[*id];
 }
 
+inline int l_threadIdFromThreadPrivate() { return getThreadSlot() - 1; }
+
 int commons::threadIdFromThreadPrivate() {
   return l_threadIdFromThreadPrivate();
 }
@@ -108,24 +122,13 @@ inline commons *getCommons() {
 #endif
 }
 
-void InitThreadId(const int threadId, bool lock_mutex = true) {
-#if defined(_MSC_VER)
-  DWORD th = GetCurrentThreadId();
-#else
-  pthread_t th = pthread_self();
-#endif
-
-  if (lock_mutex) uv_mutex_lock(&comLock);
-
-  coms[th] = threadId;
-
-  if (lock_mutex) uv_mutex_unlock(&comLock);
-}
+// the slot belongs to the calling thread, no lock is needed
+inline void InitThreadId(const int threadId) { setThreadSlot(threadId + 1); }
 
 int CreateNewThreadId() {
   uv_mutex_lock(&comLock);
   int threadId = threadIdCounter++;
-  InitThreadId(threadId, false);
+  InitThreadId(threadId);
   uv_mutex_unlock(&comLock);
 
   return threadId;
@@ -137,7 +140,7 @@ commons *setCommons(commons *iso) {
          "the previous one");
 
   uv_mutex_lock(&comLock);
-  InitThreadId(iso->threadId, false);
+  InitThreadId(iso->threadId);
   isolates[iso->threadId] = iso;
   JS_SET_ENGINE_DATA(iso->node_isolate, &iso->threadId);
   uv_mutex_unlock(&comLock);
@@ -146,29 +149,21 @@ commons *setCommons(commons *iso) {
 }
 
 void removeCommons() {
-#if defined(_MSC_VER)
-  DWORD th = GetCurrentThreadId();
-  std::map<DWORD, int>::iterator it;
-#else
-  pthread_t th = pthread_self();
-  std::map<pthread_t, int>::iterator it;
-#endif
+  const int threadId = l_threadIdFromThreadPrivate();
+  if (threadId < 0) return;
 
   uv_mutex_lock(&comLock);
 
-  it = coms.find(th);
-  if (it != coms.end()) {
-    commons *com = isolates[it->second];
-    if (com != NULL) {
-      if (com->threadId == it->second) {
-        isolates[it->second] = NULL;
-      }
-      delete com;
+  commons *com = isolates[threadId];
+  if (com != NULL) {
+    if (com->threadId == threadId) {
+      isolates[threadId] = NULL;
     }
-
-    coms.erase(it);
+    delete com;
   }
 
+  setThreadSlot(0);
+
   uv_mutex_unlock(&comLock);
 }
 
@@ -254,6 +249,19 @@ void commons::Dispose() {
   JS_CLEAR_PERSISTENT(ws_constructor_template);
   JS_CLEAR_PERSISTENT(process_tickCallback);
   JS_CLEAR_PERSISTENT(process_tickFromSpinner);
+  JS_CLEAR_PERSISTENT(domain_stack);
+  JS_CLEAR_PERSISTENT(domain_module);
+  JS_CLEAR_PERSISTENT(domain_enter);
+  JS_CLEAR_PERSISTENT(domain_exit);
+  if (tick_queue != NULL) {
+    for (uint32_t i = 0; i < tick_queue_size; i++) {
+      JS_CLEAR_PERSISTENT(tick_queue[i]);
+    }
+    delete[] tick_queue;
+    tick_queue = NULL;
+    tick_queue_size = 0;
+    tick_queue_head = 0;
+  }
   JS_CLEAR_PERSISTENT(binding_cache);
   JS_CLEAR_PERSISTENT(module_load_list);
 
@@ -275,6 +283,8 @@ void commons::Dispose() {
   JS_CLEAR_PERSISTENT(process_);
 
   stringOPS(false);
+
+  BufferAllocator::Trim(threadId);
 }
 
 #define MAKE_STR_IN(a) #a
@@ -358,10 +368,15 @@ void commons::stringOPS(bool construct) {
   NEW_PERSISTENT_STRING(versionMinor);
   NEW_PERSISTENT_STRING(versionMajor);
   NEW_PERSISTENT_STRING(_immediateCallback);
+  NEW_PERSISTENT_STRING(_disposed);
+  NEW_PERSISTENT_STRING(active);
+  NEW_PERSISTENT_STRING(enter);
+  NEW_PERSISTENT_STRING(exit);
 #endif
 
   NEW_PERSISTENT_STRING(onmessage);
   NEW_PERSISTENT_STRING(threadMessage);
+  NEW_PERSISTENT_STRING(channelMessage);
   NEW_PERSISTENT_STRING(emit);
   NEW_PERSISTENT_STRING(close);
   NEW_PERSISTENT_STRING(ontimeout);
@@ -422,6 +437,13 @@ commons::commons(const int tid) {
 #endif
   handle_has_symbol_ = false;
   counter_gc_start_time = 0;
+  idle_gc_budget = IDLE_GC_DEFAULT_BUDGET;
+  idle_gc_done = false;
+  idle_gc_heap_used = 0;
+  idle_gc_notifications = 0;
+  idle_gc_completed = 0;
+  idle_gc_time = 0;
+  idle_gc_hint = IDLE_GC_MIN_HINT;
   counter_gc_end_time = 0;
   udp_slab_allocator = NULL;
   s_slab_allocator = NULL;
@@ -468,6 +490,10 @@ commons::commons(const int tid) {
 #else
   tick_infobox = NULL;
 #endif
+  tick_queue = NULL;
+  tick_queue_size = 0;
+  tick_queue_head = 0;
+  tick_in_progress = false;
 
   at_exit_functions_ = NULL;
   pa_current_buffer_len = 0;
@@ -34,8 +34,17 @@
 #include "btree_map.h"
 #define MAP_HOST btree::btree_map
 #define HAS_BTREE_MAP
+// the store nodes keep a 24 bytes key prefix beside every value (btree.h).
+// The prefixes of a 2KB node fit in 11 cache lines, a lookup touches 5 of
+// them before it compares any key
+#define STRING_MAP_NODE_SIZE 2048
+#define STRING_MAP_HOST(T)                                           \
+  btree::btree_map<std::string, T, std::less<std::string>,           \
+                   std::allocator<std::pair<const std::string, T> >, \
+                   STRING_MAP_NODE_SIZE>
 #else
 #define MAP_HOST std::map
+#define STRING_MAP_HOST(T) std::map<std::string, T>
 #endif
 
 #if defined(JXCORE_EMBEDDED) || defined(__MIPSEL__)
@@ -46,6 +55,13 @@
 #define SLAB_SIZE (8 * 1024 * 1024)
 #endif
 
+// ms the engine may spend on GC when the loop is about to block (0 disables)
+#define IDLE_GC_DEFAULT_BUDGET 5
+// V8 3.14 takes a work hint instead of the time, IdleNotify adjusts it to
+// the budget. V8 does the same work below the minimum and a full GC at 1000
+#define IDLE_GC_MIN_HINT 20
+#define IDLE_GC_MAX_HINT 999
+
 namespace node {
 
 #define MAX_JX_THREADS 64
@@ -86,7 +102,7 @@ struct MAP_HOST_DATA {
   char *data_;
 };
 
-typedef MAP_HOST<std::string, MAP_HOST_DATA> BTStore;
+typedef STRING_MAP_HOST(MAP_HOST_DATA) BTStore;
 #define DEFINE_PERSISTENT_STRING(str) JS_PERSISTENT_STRING pstr_##str
 
 #ifdef _WIN32
@@ -165,7 +181,23 @@ class commons {
   uint64_t counter_gc_start_time;
   uint64_t counter_gc_end_time;
 
+  // idle-time GC of the loop (node.cc IdleNotify)
+  unsigned int idle_gc_budget;
+  bool idle_gc_done;  // the engine has nothing left until the heap changes
+  size_t idle_gc_heap_used;
+  uint64_t idle_gc_notifications;
+  uint64_t idle_gc_completed;
+  uint64_t idle_gc_time;  // ns
+  int idle_gc_hint;       // V8 3.14
+
   __tickbox *tick_infobox;
+  // native nextTick queue (see node.cc). a ring of tick_queue_size
+  // (power of 2) slots, tick_infobox->length of them are in use starting from
+  // tick_queue_head
+  JS_PERSISTENT_FUNCTION *tick_queue;
+  uint32_t tick_queue_size;
+  uint32_t tick_queue_head;
+  bool tick_in_progress;
   AtExitCallback *at_exit_functions_;
 
   uv_timer_t *ares_timer;
@@ -264,11 +296,16 @@ class commons {
   DEFINE_PERSISTENT_STRING(parser);
   DEFINE_PERSISTENT_STRING(__ptype);
   DEFINE_PERSISTENT_STRING(_immediateCallback);
+  DEFINE_PERSISTENT_STRING(_disposed);
+  DEFINE_PERSISTENT_STRING(active);
+  DEFINE_PERSISTENT_STRING(enter);
+  DEFINE_PERSISTENT_STRING(exit);
 #endif
 
   DEFINE_PERSISTENT_STRING(ontimeout);
   DEFINE_PERSISTENT_STRING(close);
   DEFINE_PERSISTENT_STRING(threadMessage);
+  DEFINE_PERSISTENT_STRING(channelMessage);
   DEFINE_PERSISTENT_STRING(emit);
   DEFINE_PERSISTENT_STRING(oncomplete);
   DEFINE_PERSISTENT_STRING(onchange);
@@ -287,6 +324,12 @@ class commons {
 
   JS_PERSISTENT_FUNCTION process_tickFromSpinner;
   JS_PERSISTENT_FUNCTION process_tickCallback;
+  // the domain stack and the module exports of lib/domain.js together with
+  // the original Domain.prototype.enter / exit (see UsingDomains)
+  JS_PERSISTENT_ARRAY domain_stack;
+  JS_PERSISTENT_OBJECT domain_module;
+  JS_PERSISTENT_FUNCTION domain_enter;
+  JS_PERSISTENT_FUNCTION domain_exit;
   JS_PERSISTENT_FUNCTION cloneObjectMethod;
 
   JS_PERSISTENT_FUNCTION JSONstringify;
@@ -1,6 +1,7 @@
 // Copyright & License details are available under JXCORE_LICENSE file
 
 #include "extend.h"
+#include "channel_store.h"
 
 using node::commons;
 
@@ -151,6 +152,8 @@ void jx_init_locks() {
 
   for (int i = 0; i < MAX_JX_THREADS + 1; i++) uv_mutex_init(&threadLocks[i]);
 
+  jxcore::InitChannels();
+
   if (!XSpace::StoreInit()) {
     XSpace::INITSTORE();
   }
@@ -1,16 +1,54 @@
 // Copyright & License details are available under JXCORE_LICENSE file
 
 #include "node.h"
+#include "node_counters.h"
 #include "job_store.h"
 #include "extend.h"
 #include <stdint.h>
+#include <string.h>
+#include <set>
+#include <vector>
 
 namespace jxcore {
 
 static long jobs = 0;
 class Job;
-std::queue<Job*> jobs_queue[2];
+
+// the order of a job, copied so the head of a queue can be compared without
+// holding the lock of that queue
+struct JobKey {
+  int priority;
+  uint64_t deadline;
+  uint64_t seq;
+};
+
+static inline JobKey keyOf(const Job* j) {
+  JobKey key = {j->priority, j->deadline, j->seq};
+  return key;
+}
+
+// true if a should run after b
+static inline bool runsAfter(const JobKey& a, const JobKey& b) {
+  if (a.priority != b.priority) return a.priority > b.priority;
+  if (a.deadline != b.deadline) {
+    if (a.deadline == 0) return true;
+    if (b.deadline == 0) return false;
+    return a.deadline > b.deadline;
+  }
+  return a.seq > b.seq;
+}
+
+struct JobOrder {
+  bool operator()(const Job* a, const Job* b) const {
+    return runsAfter(keyOf(a), keyOf(b));
+  }
+};
+
+std::priority_queue<Job*, std::vector<Job*>, JobOrder> jobs_queue[2];
 static long ops[2] = {0};
+static uint64_t job_seq = 0;  // jobs are added by the main thread only
+static JobQueueStats queue_stats[2][JOB_PRIORITY_COUNT];
+static std::set<int> cancelled_jobs;
 std::map<int, Job*> taskDefinitions;
 std::map<int, std::queue<int> > threadTaskList;
 
@@ -30,21 +68,107 @@ long decreaseJobCount() {
 
 void addNewJob(const int m, Job* j) {
   auto_lock locker_(CSLOCK_JOBS + (m));
+  j->seq = job_seq++;
+  j->queued_at = uv_hrtime();
   jobs_queue[m].push(j);
+  queue_stats[m][j->priority].queued++;
   ops[m]++;
+  NODE_COUNT_TASK_QUEUED();
+}
+
+// reads the order of the head of queue m. false if the queue is empty
+static bool peekJob(const int m, JobKey* key) {
+  auto_lock locker_(CSLOCK_JOBS + (m));
+  if (ops[m] == 0) return false;
+
+  *key = keyOf(jobs_queue[m].top());
+  return true;
+}
+
+// expects CSLOCK_JOBS + q and a non-empty queue
+static Job* popJob(const int q) {
+  ops[q]--;
+
+  Job* j = jobs_queue[q].top();
+  jobs_queue[q].pop();
+  NODE_COUNT_TASK_DEQUEUED();
+
+  const uint64_t now = uv_hrtime();
+  const uint64_t wait = now - j->queued_at;
+  JobQueueStats* stats = &queue_stats[q][j->priority];
+  stats->queued--;
+  stats->wait_total += wait;
+  if (wait > stats->wait_max) stats->wait_max = wait;
+
+  if (j->deadline != 0 && now > j->deadline) {
+    j->expired = true;
+    stats->expired++;
+  } else {
+    stats->dispatched++;
+  }
+
+  return j;
 }
 
+// n is the preferred queue. the head of the other queue is checked as well,
+// so a high priority job doesn't wait behind the jobs of the preferred one.
+// only the queue a job is taken from is locked at a time
 Job* getJob(const int n) {
-  auto_lock locker_(CSLOCK_JOBS + n);
-  if (ops[n] == 0) {
-    return NULL;
+  const int o = n == 0 ? 1 : 0;
+  JobKey other;
+  const bool has_other = peekJob(o, &other);
+
+  {
+    auto_lock locker_(CSLOCK_JOBS + (n));
+    if (ops[n] > 0 &&
+        (!has_other || !runsAfter(keyOf(jobs_queue[n].top()), other))) {
+      return popJob(n);
+    }
   }
-  ops[n]--;
 
-  Job* j = jobs_queue[n].front();
-  jobs_queue[n].pop();
+  if (!has_other) return NULL;
 
-  return j;
+  {
+    auto_lock locker_(CSLOCK_JOBS + (o));
+    if (ops[o] > 0) return popJob(o);
+  }
+
+  // another thread took the head of the other queue meanwhile
+  auto_lock locker_(CSLOCK_JOBS + (n));
+  if (ops[n] > 0) return popJob(n);
+
+  return NULL;
+}
+
+void getJobQueueStats(JobQueueStats* stats) {
+  memset(stats, 0, sizeof(JobQueueStats) * JOB_PRIORITY_COUNT);
+
+  for (int n = 0; n < 2; n++) {
+    auto_lock locker_(CSLOCK_JOBS + n);
+    for (int i = 0; i < JOB_PRIORITY_COUNT; i++) {
+      const JobQueueStats* qs = &queue_stats[n][i];
+      stats[i].queued += qs->queued;
+      stats[i].dispatched += qs->dispatched;
+      stats[i].expired += qs->expired;
+      stats[i].wait_total += qs->wait_total;
+      if (qs->wait_max > stats[i].wait_max) stats[i].wait_max = qs->wait_max;
+    }
+  }
+}
+
+void cancelJob(const int cbId) {
+  auto_lock locker_(CSLOCK_JBEND);
+  cancelled_jobs.insert(cbId);
+}
+
+bool isJobCancelled(const int cbId) {
+  auto_lock locker_(CSLOCK_JBEND);
+  return cancelled_jobs.find(cbId) != cancelled_jobs.end();
+}
+
+void releaseCancelledJob(const int cbId) {
+  auto_lock locker_(CSLOCK_JBEND);
+  cancelled_jobs.erase(cbId);
 }
 
 Job* getTaskDefinition(const int n) { return taskDefinitions[n]; }
@@ -130,11 +254,15 @@ void Job::removeTaskers() {
 
   for (int i = 0; i < 2; i++) {
     while (!jobs_queue[i].empty()) {
-      Job* jb = jobs_queue[i].front();
+      Job* jb = jobs_queue[i].top();
       delete jb;
       jobs_queue[i].pop();
+      NODE_COUNT_TASK_DEQUEUED();
     }
   }
+  job_seq = 0;
+  memset(queue_stats, 0, sizeof(queue_stats));
+  cancelled_jobs.clear();
 }
 
 Job::Job(const char* scr, const int scrlen, const char* pr, const int paramlen,
@@ -152,6 +280,12 @@ Job::Job(const char* scr, const int scrlen, const char* pr, const int paramlen,
 
   disposed = false;
 
+  priority = JOB_PRIORITY_NORMAL;
+  deadline = 0;
+  queued_at = 0;
+  seq = 0;
+  expired = false;
+
   if (hasScript) {
     assert(scr != NULL);
 
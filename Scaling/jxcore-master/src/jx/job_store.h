@@ -4,10 +4,26 @@
 #define SRC_JX_JOB_STORE_H_
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <queue>
 
+// jobs are dispatched by priority first, then by the earliest deadline
+// (jobs without a deadline go last) and then in the order they were added
+#define JOB_PRIORITY_HIGH 0
+#define JOB_PRIORITY_NORMAL 1
+#define JOB_PRIORITY_LOW 2
+#define JOB_PRIORITY_COUNT 3
+
 namespace jxcore {
 
+struct JobQueueStats {
+  int64_t queued;
+  int64_t dispatched;
+  int64_t expired;
+  uint64_t wait_total;  // nanoseconds, dispatched and expired jobs
+  uint64_t wait_max;
+};
+
 class Job {
  public:
   static void getTasks(std::queue<int> *tasks, int threadId);
@@ -31,12 +47,28 @@ class Job {
   int cbId;
   bool disposed;
 
+  int priority;
+  uint64_t deadline;  // uv_hrtime based, 0 for none
+  uint64_t queued_at;
+  uint64_t seq;
+  bool expired;  // deadline has passed before the job was dequeued
+
   void Dispose();
 };
 
 Job *getJob(const int n);
 void addNewJob(const int m, Job *j);
 
+// fills JOB_PRIORITY_COUNT items
+void getJobQueueStats(JobQueueStats *stats);
+
+// cancellation tokens, keyed by the callback id (cbId) of the job.
+// a cancelled job is dropped when it is dequeued, a running job may check
+// the token and stop. the submitter releases the token once the job is done
+void cancelJob(const int cbId);
+bool isJobCancelled(const int cbId);
+void releaseCancelledJob(const int cbId);
+
 long getJobCount();
 long increaseJobCount();
 long decreaseJobCount();
@@ -4,6 +4,7 @@
 #include "job_store.h"
 #include "extend.h"
 #include "job.h"
+#include "channel_store.h"
 #include "../wrappers/thread_wrap.h"
 #include "../jxcore.h"
 
@@ -143,6 +144,7 @@ void JXInstance::runScript(void *x) {
   JS_DestroyRuntime(rt);
 #endif
 
+  RemoveChannelThread(threadId + 1);
   reduceThreadCount();
   Job::removeTasker(threadId);
 
@@ -192,6 +194,15 @@ static void handleJob(node::commons *com, Job *j,
   }
 }
 
+// the job is dropped without running. reason is either 'expired' (the
+// deadline has passed while it was waiting on the queue) or 'cancelled'
+static void rejectJob(Job *j, const char *reason) {
+  char mess[64];
+  int ln = snprintf(mess, sizeof(mess), "{\"_id\":%d, \"%s\":true}", j->cbId,
+                    reason);
+  SendMessage(0, mess, ln, false);
+}
+
 static void handleTasks(node::commons *com, const JS_HANDLE_FUNCTION &func,
                         const JS_HANDLE_FUNCTION &runner, const int threadId) {
   JS_ENTER_SCOPE_WITH(com->node_isolate);
@@ -267,7 +278,13 @@ start:
     succ++;
 
     handleTasks(com, func, runner, threadId);
-    handleJob(com, j, runner);
+    if (j->expired) {
+      rejectJob(j, "expired");
+    } else if (j->cbId >= 0 && isJobCancelled(j->cbId)) {
+      rejectJob(j, "cancelled");
+    } else {
+      handleJob(com, j, runner);
+    }
 
     decreaseJobCount();
 
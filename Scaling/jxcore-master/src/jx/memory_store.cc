@@ -2,6 +2,7 @@
 
 #include "extend.h"
 #include "memory_store.h"
+#include "store_allocator.h"
 
 static uv_mutex_t orstoreLocks, ortimerLocks;
 static _StringStore *StringStore;
@@ -9,6 +10,92 @@ static _TimerStore *TimerStore;
 static bool store_init = false;
 static bool exiting = false;
 static bool hasKey = false;
+static StoreStats sharedStats;
+static StoreStats threadStats[MAX_JX_THREADS + 1];
+
+// longest key prefix recorded by the sampled histogram
+#define STORE_PREFIX_MAX 24
+
+StoreStats::StoreStats()
+    : keys_(0),
+      key_bytes_(0),
+      value_bytes_(0),
+      sample_rate_(0),
+      sample_counter_(0),
+      prefixes_(NULL) {}
+
+StoreStats::~StoreStats() {
+  if (prefixes_ != NULL) delete prefixes_;
+}
+
+// "#session:1234" -> "#session:", "cache/a/b" -> "cache/"
+static std::string GetKeyPrefix(const std::string &key) {
+  const size_t ln = key.length();
+  for (size_t i = 1; i < ln && i < STORE_PREFIX_MAX; i++) {
+    const char ch = key[i];
+    if (ch == ':' || ch == '/' || ch == '.' || ch == '|') {
+      return key.substr(0, i + 1);
+    }
+  }
+
+  return ln <= STORE_PREFIX_MAX ? key : key.substr(0, STORE_PREFIX_MAX);
+}
+
+void StoreStats::Add(const std::string &key, const size_t value_length) {
+  keys_++;
+  key_bytes_ += key.length();
+  value_bytes_ += value_length + 1;  // values are kept null terminated
+
+  if (sample_rate_ <= 0) return;
+  if (++sample_counter_ < (unsigned)sample_rate_) return;
+  sample_counter_ = 0;
+
+  StorePrefixStats &pre = (*prefixes_)[GetKeyPrefix(key)];
+  pre.samples_++;
+  pre.key_bytes_ += key.length();
+  pre.value_bytes_ += value_length + 1;
+}
+
+void StoreStats::Remove(const std::string &key, const size_t value_length) {
+  if (keys_ == 0) return;
+
+  keys_--;
+  key_bytes_ -= key.length();
+  value_bytes_ -= value_length + 1;
+}
+
+void StoreStats::Clear() {
+  keys_ = 0;
+  key_bytes_ = 0;
+  value_bytes_ = 0;
+  sample_counter_ = 0;
+  if (prefixes_ != NULL) prefixes_->clear();
+}
+
+void StoreStats::SetSampling(const int rate) {
+  sample_rate_ = rate > 0 ? rate : 0;
+  sample_counter_ = 0;
+
+  if (sample_rate_ == 0) {
+    if (prefixes_ != NULL) {
+      delete prefixes_;
+      prefixes_ = NULL;
+    }
+  } else if (prefixes_ == NULL) {
+    prefixes_ = new _PrefixStore;
+  }
+}
+
+size_t StoreStats::NodeBytes(const _StringStore *store) {
+  if (store == NULL) return 0;
+#ifdef HAS_BTREE_MAP
+  return store->bytes_used();
+#else
+  // red-black tree node; 3 pointers + color on top of the pair
+  return store->size() *
+         (sizeof(_StringStore::value_type) + 4 * sizeof(void *));
+#endif
+}
 
 bool XSpace::StoreInit() {
   if (!store_init) {
@@ -21,6 +108,7 @@ bool XSpace::StoreInit() {
 void XSpace::INITSTORE() {
   if (exiting) return;
   uv_mutex_init(&orstoreLocks);
+  StoreAllocator::Init();
   StringStore = new _StringStore;
   TimerStore = new _TimerStore;
   uv_mutex_init(&ortimerLocks);
@@ -58,6 +146,7 @@ void XSpace::ClearStore() {
 
   StringStore->clear();
   TimerStore->clear();
+  sharedStats.Clear();
   delete StringStore;
   delete TimerStore;
   StringStore = NULL;
@@ -70,6 +159,10 @@ _StringStore *XSpace::Store() { return StringStore; }
 
 _TimerStore *XSpace::Timers() { return TimerStore; }
 
+StoreStats *XSpace::Stats() { return &sharedStats; }
+
+StoreStats *XSpace::MapStats(const int tid) { return &threadStats[tid]; }
+
 void XSpace::SetHasKey(bool hasIt) { hasKey = hasIt; }
 
 bool XSpace::GetHasKey() { return hasKey; }
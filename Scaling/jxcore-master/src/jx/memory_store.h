@@ -10,6 +10,8 @@
 #else
 #define strcasecmp _stricmp
 #endif
+#include <map>
+#include <string>
 
 #ifndef __IOS__
 #include "btree_map.h"
@@ -28,8 +30,41 @@ struct ttlTimer {
 #define EXTERNAL_DATA_STRING 1
 #define EXTERNAL_DATA_TIMER 2
 
-typedef MAP_HOST<std::string, node::MAP_HOST_DATA> _StringStore;
-typedef MAP_HOST<std::string, ttlTimer> _TimerStore;
+typedef STRING_MAP_HOST(node::MAP_HOST_DATA) _StringStore;
+typedef STRING_MAP_HOST(ttlTimer) _TimerStore;
+
+struct StorePrefixStats {
+  uint64_t samples_;
+  uint64_t key_bytes_;
+  uint64_t value_bytes_;
+};
+
+typedef std::map<std::string, StorePrefixStats> _PrefixStore;
+
+// byte counters for a single store (the shared store or a per-thread
+// BTStore). the owner of the store is responsible for the locking; the shared
+// store updates these under LOCKSTORE, per-thread stores from their own thread
+class StoreStats {
+ public:
+  StoreStats();
+  ~StoreStats();
+
+  void Add(const std::string &key, const size_t value_length);
+  void Remove(const std::string &key, const size_t value_length);
+  void Clear();
+
+  // 0 disables the key prefix histogram, otherwise every rate'th Add is
+  // sampled
+  void SetSampling(const int rate);
+  static size_t NodeBytes(const _StringStore *store);
+
+  size_t keys_;
+  size_t key_bytes_;
+  size_t value_bytes_;
+  int sample_rate_;
+  unsigned sample_counter_;
+  _PrefixStore *prefixes_;
+};
 
 class XSpace {
  public:
@@ -43,6 +78,8 @@ class XSpace {
   static void ClearStore();
   static _StringStore* Store();
   static _TimerStore* Timers();
+  static StoreStats* Stats();
+  static StoreStats* MapStats(const int tid);
   static void ExpirationKick(const char* key);
   static void ExpirationRemove(const char* key);
   static void SetHasKey(bool hasIt);
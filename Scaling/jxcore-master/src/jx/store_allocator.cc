@@ -0,0 +1,251 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "store_allocator.h"
+#include "commons.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct FreeBlock {
+  FreeBlock *next_;
+};
+
+struct SizeClass {
+  uv_mutex_t lock_;
+  FreeBlock *head_;
+  int64_t free_count_;
+  int64_t slabs_;
+};
+
+struct ThreadCache {
+  FreeBlock *head_[STORE_SIZE_CLASSES];
+  int count_[STORE_SIZE_CLASSES];
+  StoreAllocatorStats stats_;  // only updated by the owner thread
+};
+
+static SizeClass classes[STORE_SIZE_CLASSES];
+static ThreadCache caches[MAX_JX_THREADS];
+static StoreAllocatorStats uncached_stats;
+static uv_mutex_t uncached_lock;
+static bool allocator_init = false;
+
+#define CLASS_SIZE(n) ((size_t)1 << ((n) + STORE_MIN_CLASS_SHIFT))
+
+static inline int GetSizeClass(const size_t size) {
+  for (int i = 0; i < STORE_SIZE_CLASSES; i++) {
+    if (size <= CLASS_SIZE(i)) return i;
+  }
+  return -1;
+}
+
+static inline bool HasCache(const int tid) {
+  return tid >= 0 && tid < MAX_JX_THREADS;
+}
+
+// expects sc->lock_
+static void AddSlab(SizeClass *sc, const size_t block_size) {
+  char *slab = (char *)malloc(STORE_SLAB_SIZE);
+  if (slab == NULL) return;
+
+  sc->slabs_++;
+  for (size_t pos = 0; pos + block_size <= STORE_SLAB_SIZE; pos += block_size) {
+    FreeBlock *block = (FreeBlock *)(slab + pos);
+    block->next_ = sc->head_;
+    sc->head_ = block;
+    sc->free_count_++;
+  }
+}
+
+// expects sc->lock_
+static inline FreeBlock *PopBlock(SizeClass *sc, const int cls) {
+  if (sc->head_ == NULL) AddSlab(sc, CLASS_SIZE(cls));
+  if (sc->head_ == NULL) return NULL;
+
+  FreeBlock *block = sc->head_;
+  sc->head_ = block->next_;
+  sc->free_count_--;
+  return block;
+}
+
+static char *AllocBlock(const int tid, const int cls) {
+  SizeClass *sc = &classes[cls];
+
+  if (!HasCache(tid)) {
+    uv_mutex_lock(&sc->lock_);
+    FreeBlock *block = PopBlock(sc, cls);
+    uv_mutex_unlock(&sc->lock_);
+    return (char *)block;
+  }
+
+  ThreadCache *cache = &caches[tid];
+  if (cache->head_[cls] == NULL) {
+    uv_mutex_lock(&sc->lock_);
+    for (int i = 0; i < STORE_CACHE_LIMIT / 2; i++) {
+      FreeBlock *block = PopBlock(sc, cls);
+      if (block == NULL) break;
+      block->next_ = cache->head_[cls];
+      cache->head_[cls] = block;
+      cache->count_[cls]++;
+    }
+    uv_mutex_unlock(&sc->lock_);
+
+    if (cache->head_[cls] == NULL) return NULL;
+  }
+
+  FreeBlock *block = cache->head_[cls];
+  cache->head_[cls] = block->next_;
+  cache->count_[cls]--;
+  return (char *)block;
+}
+
+static void FreeBlockTo(const int tid, const int cls, char *ptr) {
+  SizeClass *sc = &classes[cls];
+  FreeBlock *block = (FreeBlock *)ptr;
+
+  if (!HasCache(tid)) {
+    uv_mutex_lock(&sc->lock_);
+    block->next_ = sc->head_;
+    sc->head_ = block;
+    sc->free_count_++;
+    uv_mutex_unlock(&sc->lock_);
+    return;
+  }
+
+  ThreadCache *cache = &caches[tid];
+  block->next_ = cache->head_[cls];
+  cache->head_[cls] = block;
+  cache->count_[cls]++;
+
+  if (cache->count_[cls] <= STORE_CACHE_LIMIT) return;
+
+  // give the half of the cache back so the other threads can use it
+  uv_mutex_lock(&sc->lock_);
+  for (int i = 0; i < STORE_CACHE_LIMIT / 2; i++) {
+    block = cache->head_[cls];
+    cache->head_[cls] = block->next_;
+    cache->count_[cls]--;
+
+    block->next_ = sc->head_;
+    sc->head_ = block;
+    sc->free_count_++;
+  }
+  uv_mutex_unlock(&sc->lock_);
+}
+
+static inline void Count(const int tid, const int64_t used,
+                         const int64_t requested, const int allocs,
+                         const int frees, const int reuses) {
+  StoreAllocatorStats *stats;
+  if (HasCache(tid)) {
+    stats = &caches[tid].stats_;
+  } else {
+    uv_mutex_lock(&uncached_lock);
+    stats = &uncached_stats;
+  }
+
+  stats->used_ += used;
+  stats->requested_ += requested;
+  stats->allocs_ += allocs;
+  stats->frees_ += frees;
+  stats->reuses_ += reuses;
+
+  if (!HasCache(tid)) uv_mutex_unlock(&uncached_lock);
+}
+
+void StoreAllocator::Init() {
+  if (allocator_init) return;
+  allocator_init = true;
+
+  for (int i = 0; i < STORE_SIZE_CLASSES; i++) {
+    uv_mutex_init(&classes[i].lock_);
+    classes[i].head_ = NULL;
+    classes[i].free_count_ = 0;
+    classes[i].slabs_ = 0;
+  }
+  memset(caches, 0, sizeof(caches));
+  memset(&uncached_stats, 0, sizeof(uncached_stats));
+  uv_mutex_init(&uncached_lock);
+}
+
+char *StoreAllocator::New(const int tid, const char *data,
+                          const size_t length) {
+  const size_t size = length + 1;
+  const int cls = GetSizeClass(size);
+
+  char *block;
+  size_t block_size;
+  if (cls >= 0) {
+    block = AllocBlock(tid, cls);
+    block_size = CLASS_SIZE(cls);
+  } else {
+    block = (char *)malloc(size);
+    block_size = size;
+  }
+
+  if (block == NULL) return NULL;
+
+  memcpy(block, data, length);
+  block[length] = char(0);
+
+  Count(tid, block_size, size, 1, 0, 0);
+  return block;
+}
+
+void StoreAllocator::Delete(const int tid, char *block, const size_t length) {
+  if (block == NULL) return;
+
+  const size_t size = length + 1;
+  const int cls = GetSizeClass(size);
+
+  if (cls >= 0) {
+    FreeBlockTo(tid, cls, block);
+    Count(tid, -(int64_t)CLASS_SIZE(cls), -(int64_t)size, 0, 1, 0);
+  } else {
+    free(block);
+    Count(tid, -(int64_t)size, -(int64_t)size, 0, 1, 0);
+  }
+}
+
+bool StoreAllocator::Overwrite(const int tid, char *block,
+                               const size_t old_length, const char *data,
+                               const size_t length) {
+  const int cls = GetSizeClass(length + 1);
+  if (cls < 0 || cls != GetSizeClass(old_length + 1)) return false;
+
+  memmove(block, data, length);
+  block[length] = char(0);
+
+  Count(tid, 0, (int64_t)length - (int64_t)old_length, 0, 0, 1);
+  return true;
+}
+
+void StoreAllocator::GetStats(StoreAllocatorStats *stats) {
+  memset(stats, 0, sizeof(StoreAllocatorStats));
+
+  for (int i = 0; i < STORE_SIZE_CLASSES; i++) {
+    uv_mutex_lock(&classes[i].lock_);
+    stats->reserved_ += classes[i].slabs_ * STORE_SLAB_SIZE;
+    stats->free_ += classes[i].free_count_ * CLASS_SIZE(i);
+    uv_mutex_unlock(&classes[i].lock_);
+  }
+
+  // the thread caches are read without a lock, the numbers are approximate
+  for (int t = 0; t < MAX_JX_THREADS; t++) {
+    const ThreadCache *cache = &caches[t];
+    for (int i = 0; i < STORE_SIZE_CLASSES; i++) {
+      stats->free_ += cache->count_[i] * CLASS_SIZE(i);
+    }
+    stats->used_ += cache->stats_.used_;
+    stats->requested_ += cache->stats_.requested_;
+    stats->allocs_ += cache->stats_.allocs_;
+    stats->frees_ += cache->stats_.frees_;
+    stats->reuses_ += cache->stats_.reuses_;
+  }
+
+  uv_mutex_lock(&uncached_lock);
+  stats->used_ += uncached_stats.used_;
+  stats->requested_ += uncached_stats.requested_;
+  stats->allocs_ += uncached_stats.allocs_;
+  stats->frees_ += uncached_stats.frees_;
+  stats->reuses_ += uncached_stats.reuses_;
+  uv_mutex_unlock(&uncached_lock);
+}
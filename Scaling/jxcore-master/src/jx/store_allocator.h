@@ -0,0 +1,47 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_JX_STORE_ALLOCATOR_H_
+#define SRC_JX_STORE_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Size classed slab allocator for the memory store values.
+// Blocks are carved from STORE_SLAB_SIZE slabs and never go back to the
+// system. Every thread keeps a small cache of free blocks per class, so most
+// of the New / Delete calls (made under the store lock) don't wait for the
+// global allocator. Values bigger than the largest class use malloc.
+#define STORE_SLAB_SIZE (64 * 1024)
+#define STORE_MIN_CLASS_SHIFT 4  // 16 bytes
+#define STORE_SIZE_CLASSES 9     // 16 .. 4096 bytes
+#define STORE_CACHE_LIMIT 64     // per thread, per class
+
+struct StoreAllocatorStats {
+  int64_t reserved_;   // bytes held by the slabs
+  int64_t free_;       // slab bytes waiting on the free lists / caches
+  int64_t used_;       // block bytes handed out (including large blocks)
+  int64_t requested_;  // value bytes actually stored in those blocks
+  int64_t allocs_;
+  int64_t frees_;
+  int64_t reuses_;  // in place overwrites
+};
+
+class StoreAllocator {
+ public:
+  static void Init();
+
+  // tid is the jxcore thread id of the caller (commons::threadId) or -1 for
+  // the threads without a cache, i.e. the expiration watcher
+  // returns a null terminated copy of data
+  static char *New(const int tid, const char *data, const size_t length);
+  static void Delete(const int tid, char *block, const size_t length);
+
+  // copies data into the existing block if it belongs to the same size class
+  // returns false if the caller has to allocate a new block instead
+  static bool Overwrite(const int tid, char *block, const size_t old_length,
+                        const char *data, const size_t length);
+
+  static void GetStats(StoreAllocatorStats *stats);
+};
+
+#endif  // SRC_JX_STORE_ALLOCATOR_H_
@@ -85,6 +85,130 @@ char* app_sandbox_folder = NULL;
 
 int WRITE_UTF8_FLAGS = JS_ENGINE_WRITE_UTF8_FLAGS;
 
+static void Spin(uv_idle_t* handle, int status);
+
+static void StartTickSpinner(node::commons* com) {
+  if (com->need_tick_cb) return;
+
+  com->need_tick_cb = true;
+  uv_idle_t* t = com->tick_spinner;
+  t->threadId = com->threadId;
+  uv_idle_start(t, Spin);
+}
+
+// nextTick callbacks are kept on a native ring (com->tick_queue) unless the
+// domains are in use. MakeCallback drains it right away instead of calling
+// into process._tickCallback. While the native queue is active,
+// tick_infobox->length is the number of the queued callbacks and
+// tick_infobox->index stays 0
+#define TICK_QUEUE_INITIAL_SIZE 64
+
+static void GrowTickQueue(node::commons* com) {
+  JS_DEFINE_STATE_MARKER(com);
+  const uint32_t old_size = com->tick_queue_size;
+  const uint32_t size =
+      old_size == 0 ? TICK_QUEUE_INITIAL_SIZE : old_size * 2;
+  JS_PERSISTENT_FUNCTION* queue = new JS_PERSISTENT_FUNCTION[size];
+
+  // persistent handles can not be moved around (MozJS roots the slot
+  // address) so re-create them on the new ring
+  const uint32_t count = com->tick_infobox->length;
+  for (uint32_t i = 0; i < count; i++) {
+    JS_PERSISTENT_FUNCTION& slot =
+        com->tick_queue[(com->tick_queue_head + i) & (old_size - 1)];
+    JS_LOCAL_FUNCTION fn = JS_TYPE_TO_LOCAL_FUNCTION(slot);
+    JS_NEW_PERSISTENT_FUNCTION(queue[i], fn);
+    JS_CLEAR_PERSISTENT(slot);
+  }
+
+  delete[] com->tick_queue;
+  com->tick_queue = queue;
+  com->tick_queue_size = size;
+  com->tick_queue_head = 0;
+}
+
+// expects a local scope
+static inline JS_LOCAL_FUNCTION ShiftTick(node::commons* com) {
+  JS_DEFINE_STATE_MARKER(com);
+  JS_PERSISTENT_FUNCTION& slot = com->tick_queue[com->tick_queue_head];
+  JS_LOCAL_FUNCTION fn = JS_TYPE_TO_LOCAL_FUNCTION(slot);
+  JS_CLEAR_PERSISTENT(slot);
+
+  com->tick_queue_head =
+      (com->tick_queue_head + 1) & (com->tick_queue_size - 1);
+  com->tick_infobox->length--;
+  return fn;
+}
+
+static void TickDone(node::commons* com, const uint32_t depth) {
+  __tickbox* box = com->tick_infobox;
+  com->tick_in_progress = false;
+  box->index = 0;
+  box->depth = depth;
+
+  if (box->length != 0)
+    StartTickSpinner(com);
+  else
+    com->tick_queue_head = 0;
+}
+
+// runs the queued nextTick callbacks (see processNextTick in node.js)
+// returns false when a callback throws. The exception is left on try_catch
+// and the rest of the queue waits for the tick spinner
+static bool RunTickQueue(node::commons* com, JS_TRY_CATCH_TYPE& try_catch) {
+  JS_ENTER_SCOPE_WITH(com->node_isolate);
+  JS_DEFINE_STATE_MARKER(com);
+  __tickbox* box = com->tick_infobox;
+
+  if (com->using_domains) {
+    if (box->length == 0) return true;
+
+    JS_LOCAL_FUNCTION ptc =
+        JS_TYPE_TO_LOCAL_FUNCTION(com->process_tickCallback);
+    JS_METHOD_CALL_NO_PARAM(ptc, com->getProcess());
+    return !try_catch.HasCaught();
+  }
+
+  if (com->tick_in_progress) return true;
+
+  if (box->length == 0) {
+    box->index = 0;
+    box->depth = 0;
+    return true;
+  }
+
+  JS_LOCAL_VALUE max_v =
+      JS_GET_NAME(com->getProcess(), JS_STRING_ID("maxTickDepth"));
+  const double max_depth = JS_IS_NUMBER(max_v) ? NUMBER_TO_STD(max_v) : 1000;
+  JS_LOCAL_OBJECT global = JS_GET_GLOBAL();
+
+  com->tick_in_progress = true;
+  while (box->depth++ < max_depth) {
+    // callbacks scheduled by this round run on the next one
+    uint32_t count = box->length;
+    if (count == 0) break;
+
+    while (count-- > 0) {
+      JS_LOCAL_FUNCTION callback = ShiftTick(com);
+      JS_METHOD_CALL_NO_PARAM(callback, global);
+
+      if (try_catch.HasCaught()) {
+        TickDone(com, box->depth);
+        return false;
+      }
+
+      // the domain module took the rest of the queue (see UsingDomains)
+      if (com->using_domains) {
+        com->tick_in_progress = false;
+        return true;
+      }
+    }
+  }
+
+  TickDone(com, 0);
+  return true;
+}
+
 static void Spin(uv_idle_t* handle, int status) {
   node::commons* com = node::commons::getInstanceByThreadId(handle->threadId);
   if (com->instance_status_ == node::JXCORE_INSTANCE_EXITED ||
@@ -102,6 +226,17 @@ static void Spin(uv_idle_t* handle, int status) {
 
   JS_DEFINE_STATE_MARKER(com);
 
+  if (!com->using_domains) {
+    // coming from spinner, reset!
+    com->tick_infobox->depth = 0;
+
+    JS_TRY_CATCH(try_catch);
+    if (!RunTickQueue(com, try_catch)) {
+      FatalException(try_catch);
+    }
+    return;
+  }
+
   if (JS_IS_EMPTY((com->process_tickFromSpinner))) {
     __JS_LOCAL_STRING tfs_str = JS_STRING_ID("_tickFromSpinner");
     JS_LOCAL_VALUE cb_v = JS_GET_NAME(com->getProcess(), tfs_str);
@@ -136,6 +271,38 @@ static JS_LOCAL_METHOD(NeedTickCallback) {
 }
 JS_METHOD_END
 
+static JS_LOCAL_METHOD(PushTick) {
+  if (com->instance_status_ == node::JXCORE_INSTANCE_EXITED ||
+      com->expects_reset)
+    RETURN();
+
+  if (!args.IsFunction(0)) {
+    THROW_TYPE_EXCEPTION("nextTick expects a function");
+  }
+
+  if (com->tick_infobox->length == com->tick_queue_size) GrowTickQueue(com);
+
+  const uint32_t pos = (com->tick_queue_head + com->tick_infobox->length) &
+                       (com->tick_queue_size - 1);
+  JS_LOCAL_FUNCTION fn = TO_LOCAL_FUNCTION(args.GetAsFunction(0));
+  JS_NEW_PERSISTENT_FUNCTION(com->tick_queue[pos], fn);
+  com->tick_infobox->length++;
+
+  StartTickSpinner(com);
+}
+JS_METHOD_END
+
+static JS_LOCAL_METHOD(RunTicks) {
+  JS_TRY_CATCH(try_catch);
+
+  if (!RunTickQueue(com, try_catch)) {
+#ifdef JS_ENGINE_V8
+    RETURN_PARAM(try_catch.ReThrow());
+#endif
+  }
+}
+JS_METHOD_END
+
 static void CheckImmediate(uv_check_t* handle, int status) {
   node::commons* com = node::commons::getInstanceByThreadId(handle->threadId);
   if (com->instance_status_ == node::JXCORE_INSTANCE_EXITED ||
@@ -213,6 +380,37 @@ JS_LOCAL_METHOD(UsingDomains) {
 
   JS_CLEAR_PERSISTENT(com->process_tickCallback);
   JS_NEW_PERSISTENT_FUNCTION(com->process_tickCallback, tdc);
+
+  // lib/domain.js shares its stack so MakeCallback can enter / exit the
+  // domains without calling into JS
+  if (args.Length() >= 4 && args.IsArray(0) && args.IsObject(1) &&
+      args.IsFunction(2) && args.IsFunction(3)) {
+    JS_HANDLE_ARRAY stack = args.GetAsArray(0);
+    JS_LOCAL_OBJECT module = JS_VALUE_TO_OBJECT(args.GetItem(1));
+    JS_LOCAL_FUNCTION enter = TO_LOCAL_FUNCTION(args.GetAsFunction(2));
+    JS_LOCAL_FUNCTION exit = TO_LOCAL_FUNCTION(args.GetAsFunction(3));
+    JS_NEW_PERSISTENT_ARRAY(com->domain_stack, stack);
+    JS_NEW_PERSISTENT_OBJECT(com->domain_module, module);
+    JS_NEW_PERSISTENT_FUNCTION(com->domain_enter, enter);
+    JS_NEW_PERSISTENT_FUNCTION(com->domain_exit, exit);
+  }
+
+  // from now on the ticks are kept on the JS queue. move the pending ones
+  // over there, keeping the order
+  __tickbox* box = com->tick_infobox;
+  uint32_t count = box->length;
+  box->length = 0;
+  box->index = 0;
+  for (; count > 0; count--) {
+    JS_PERSISTENT_FUNCTION& slot = com->tick_queue[com->tick_queue_head];
+    JS_LOCAL_VALUE argv[1] = {JS_TYPE_TO_LOCAL_FUNCTION(slot)};
+    JS_CLEAR_PERSISTENT(slot);
+    com->tick_queue_head =
+        (com->tick_queue_head + 1) & (com->tick_queue_size - 1);
+
+    JS_METHOD_CALL(ndt, process, 1, argv);
+  }
+  com->tick_queue_head = 0;
 }
 JS_METHOD_END
 
@@ -225,6 +423,87 @@ MakeDomainCallback(const JS_HANDLE_OBJECT_REF object,
   return MakeDomainCallback(com, object, callback, argc, argv);
 }
 
+enum OwnerDomain { DOMAIN_NONE, DOMAIN_ENTERED, DOMAIN_DISPOSED };
+
+// false if the domain overrides the Domain.prototype method. In that case
+// its own method is called instead
+static inline bool IsPrototypeMethod(node::commons* com,
+                                     JS_LOCAL_OBJECT& domain,
+                                     JS_LOCAL_VALUE method_v,
+                                     JS_PERSISTENT_FUNCTION& original) {
+  JS_DEFINE_STATE_MARKER(com);
+  if (!JS_IS_EMPTY(original) &&
+      JS_STRICT_EQUALS(method_v, JS_TYPE_TO_LOCAL_FUNCTION(original)))
+    return true;
+
+  JS_LOCAL_FUNCTION method = JS_CAST_FUNCTION(method_v);
+  assert(!JS_IS_EMPTY(method));
+  JS_METHOD_CALL_NO_PARAM(method, domain);
+  return false;
+}
+
+// same as Domain.prototype.enter (lib/domain.js) over com->domain_stack
+// expects a local scope
+static OwnerDomain EnterOwnerDomain(node::commons* com,
+                                    const JS_HANDLE_OBJECT_REF object,
+                                    JS_LOCAL_OBJECT& domain) {
+  JS_DEFINE_STATE_MARKER(com);
+  JS_LOCAL_VALUE domain_v = JS_GET_NAME(object, JS_PREDEFINED_STRING(domain));
+  if (!JS_IS_OBJECT(domain_v)) return DOMAIN_NONE;
+
+  domain = JS_VALUE_TO_OBJECT(domain_v);
+  assert(!JS_IS_EMPTY(domain));
+
+  if (JS_IS_TRUE(JS_GET_NAME(domain, JS_PREDEFINED_STRING(_disposed))))
+    return DOMAIN_DISPOSED;
+
+  if (!IsPrototypeMethod(com, domain,
+                         JS_GET_NAME(domain, JS_PREDEFINED_STRING(enter)),
+                         com->domain_enter))
+    return DOMAIN_ENTERED;
+
+  JS_LOCAL_ARRAY stack = JS_TYPE_TO_LOCAL_ARRAY(com->domain_stack);
+  JS_INDEX_SET(stack, JS_GET_ARRAY_LENGTH(stack), domain);
+
+  JS_LOCAL_OBJECT module = JS_TYPE_TO_LOCAL_OBJECT(com->domain_module);
+  JS_NAME_SET(module, JS_PREDEFINED_STRING(active), domain);
+  JS_NAME_SET(com->getProcess(), JS_PREDEFINED_STRING(domain), domain);
+
+  return DOMAIN_ENTERED;
+}
+
+// same as Domain.prototype.exit (lib/domain.js). Only the top of the stack
+// is handled here, the rest goes to the JS method
+static void ExitOwnerDomain(node::commons* com, JS_LOCAL_OBJECT& domain) {
+  JS_DEFINE_STATE_MARKER(com);
+
+  if (!IsPrototypeMethod(com, domain,
+                         JS_GET_NAME(domain, JS_PREDEFINED_STRING(exit)),
+                         com->domain_exit))
+    return;
+
+  if (JS_IS_TRUE(JS_GET_NAME(domain, JS_PREDEFINED_STRING(_disposed))))
+    return;
+
+  JS_LOCAL_ARRAY stack = JS_TYPE_TO_LOCAL_ARRAY(com->domain_stack);
+  const uint32_t length = JS_GET_ARRAY_LENGTH(stack);
+  if (length == 0 ||
+      !JS_STRICT_EQUALS(JS_GET_INDEX(stack, length - 1), domain)) {
+    JS_LOCAL_FUNCTION exit = JS_TYPE_TO_LOCAL_FUNCTION(com->domain_exit);
+    JS_METHOD_CALL_NO_PARAM(exit, domain);
+    return;
+  }
+
+  JS_NAME_SET(stack, JS_PREDEFINED_STRING(length),
+              STD_TO_INTEGER(length - 1));
+
+  JS_LOCAL_VALUE active = length > 1 ? JS_GET_INDEX(stack, length - 2)
+                                     : JS_UNDEFINED();
+  JS_LOCAL_OBJECT module = JS_TYPE_TO_LOCAL_OBJECT(com->domain_module);
+  JS_NAME_SET(module, JS_PREDEFINED_STRING(active), active);
+  JS_NAME_SET(com->getProcess(), JS_PREDEFINED_STRING(domain), active);
+}
+
 JS_HANDLE_VALUE
 MakeDomainCallback(node::commons* com, const JS_HANDLE_OBJECT_REF object,
                    const JS_HANDLE_FUNCTION_REF callback, int argc,
@@ -232,35 +511,18 @@ MakeDomainCallback(node::commons* com, const JS_HANDLE_OBJECT_REF object,
   JS_DEFINE_STATE_MARKER(com);
   if (com == NULL || com->expects_reset) return JS_UNDEFINED();
 
-  JS_LOCAL_VALUE domain_v;
   JS_LOCAL_OBJECT domain;
-  JS_LOCAL_FUNCTION enter;
-  JS_LOCAL_FUNCTION exit;
 
   JS_TRY_CATCH(try_catch);
 
-  bool has_domain = false;
+  OwnerDomain owner = DOMAIN_NONE;
   if (com->using_domains) {
-    domain_v = JS_GET_NAME(object, JS_PREDEFINED_STRING(domain));
-    has_domain = JS_IS_OBJECT(domain_v);
-    if (has_domain) {
-      domain = JS_VALUE_TO_OBJECT(domain_v);
-      assert(!JS_IS_EMPTY(domain));
-
-      __JS_LOCAL_STRING d_str = JS_STRING_ID("_disposed");
-      if (JS_IS_TRUE(JS_GET_NAME(domain, d_str))) {
-        return JS_UNDEFINED();
-      }
-
-      __JS_LOCAL_STRING str_enter = JS_STRING_ID("enter");
-      enter = JS_CAST_FUNCTION(JS_GET_NAME(domain, str_enter));
-      assert(!JS_IS_EMPTY(enter));
-      JS_METHOD_CALL_NO_PARAM(enter, domain);
+    owner = EnterOwnerDomain(com, object, domain);
+    if (owner == DOMAIN_DISPOSED) return JS_UNDEFINED();
 
-      if (try_catch.HasCaught()) {
-        FatalException(try_catch);
-        return JS_UNDEFINED();
-      }
+    if (try_catch.HasCaught()) {
+      FatalException(try_catch);
+      return JS_UNDEFINED();
     }
   }
 
@@ -271,11 +533,8 @@ MakeDomainCallback(node::commons* com, const JS_HANDLE_OBJECT_REF object,
     return JS_UNDEFINED();
   }
 
-  if (has_domain) {
-    __JS_LOCAL_STRING str_exit = JS_STRING_ID("exit");
-    exit = JS_CAST_FUNCTION(JS_GET_NAME(domain, str_exit));
-    assert(!JS_IS_EMPTY(exit));
-    JS_METHOD_CALL_NO_PARAM(exit, domain);
+  if (owner == DOMAIN_ENTERED) {
+    ExitOwnerDomain(com, domain);
 
     if (try_catch.HasCaught()) {
       FatalException(try_catch);
@@ -289,10 +548,7 @@ MakeDomainCallback(node::commons* com, const JS_HANDLE_OBJECT_REF object,
     return ret;
   }
 
-  JS_LOCAL_FUNCTION ptcl = JS_TYPE_TO_LOCAL_FUNCTION(com->process_tickCallback);
-  JS_METHOD_CALL_NO_PARAM(ptcl, com->getProcess());
-
-  if (try_catch.HasCaught()) {
+  if (!RunTickQueue(com, try_catch)) {
     FatalException(try_catch);
     return JS_UNDEFINED();
   }
@@ -337,27 +593,25 @@ MakeCallback(node::commons* com, JS_HANDLE_OBJECT_REF host, const char* name,
   JS_DEFINE_STATE_MARKER(com);
   if (com == NULL || com->expects_reset) return JS_UNDEFINED();
 
-  if (com->using_domains) {
-    if (argc > 0) {
-      // TODO(obastemur) improve perf for domains
-      MozJS::Value* args = (MozJS::Value*)malloc(sizeof(MozJS::Value) * (argc));
-      for (int i = 0; i < argc; i++)
-        args[i] = MozJS::Value(argv[i], JS_GET_STATE_MARKER());
-      JS_HANDLE_VALUE ret_val =
-          MakeCallback(com, host, STD_TO_STRING(name), argc, args);
-      free(args);
-      return ret_val;
-    } else {
-      return MakeCallback(com, host, STD_TO_STRING(name), 0, NULL);
-    }
-  }
-
   if (JS_IS_EMPTY((com->process_tickCallback))) {
     defineProcessCallbacks(com);
   }
 
   JS_TRY_CATCH(try_catch);
 
+  // the raw argv goes to the callback as is, with or without a domain
+  JS_LOCAL_OBJECT domain;
+  OwnerDomain owner = DOMAIN_NONE;
+  if (com->using_domains) {
+    owner = EnterOwnerDomain(com, host, domain);
+    if (owner == DOMAIN_DISPOSED) return JS_UNDEFINED();
+
+    if (try_catch.HasCaught()) {
+      FatalException(try_catch);
+      return JS_UNDEFINED();
+    }
+  }
+
   JS_LOCAL_VALUE ret = host.Call(name, argc, argv);
 
   if (try_catch.HasCaught()) {
@@ -367,22 +621,22 @@ MakeCallback(node::commons* com, JS_HANDLE_OBJECT_REF host, const char* name,
     return JS_UNDEFINED();
   }
 
+  if (owner == DOMAIN_ENTERED) {
+    ExitOwnerDomain(com, domain);
+
+    if (try_catch.HasCaught()) {
+      FatalException(try_catch);
+      return JS_UNDEFINED();
+    }
+  }
+
   if (com->tick_infobox->length == 0) {
     com->tick_infobox->index = 0;
     com->tick_infobox->depth = 0;
     return ret;
   }
 
-  JS_HANDLE_OBJECT pr = com->getProcess();
-  JS::RootedValue rov(__contextORisolate);
-
-  // We know for sure that we are in the right compartment
-  jsval pr_val = pr.GetRawValue();
-  jsval pt_val = com->process_tickCallback.GetRawValue();
-  JS_CallFunctionValueJX(__contextORisolate, pr_val, pt_val,
-                         JS::HandleValueArray::empty(), &rov);
-
-  if (try_catch.HasCaught()) {
+  if (!RunTickQueue(com, try_catch)) {
     if (!(com->expects_reset && com->threadId > 0)) {
       FatalException(try_catch);
     }
@@ -401,7 +655,7 @@ MakeCallback(node::commons* com, const JS_HANDLE_OBJECT_REF object,
   if (com == NULL || com->expects_reset) return JS_UNDEFINED();
 
   if (com->using_domains)
-    return MakeDomainCallback(object, callback, argc, argv);
+    return MakeDomainCallback(com, object, callback, argc, argv);
 
   if (JS_IS_EMPTY((com->process_tickCallback))) {
     defineProcessCallbacks(com);
@@ -422,11 +676,7 @@ MakeCallback(node::commons* com, const JS_HANDLE_OBJECT_REF object,
     return ret;
   }
 
-  JS_HANDLE_OBJECT process_obj = com->getProcess();
-  JS_LOCAL_FUNCTION ptc = JS_TYPE_TO_LOCAL_FUNCTION(com->process_tickCallback);
-  JS_METHOD_CALL_NO_PARAM(ptc, process_obj);
-
-  if (try_catch.HasCaught()) {
+  if (!RunTickQueue(com, try_catch)) {
     FatalException(try_catch);
     return JS_UNDEFINED();
   }
@@ -1041,6 +1291,81 @@ static JS_LOCAL_METHOD(Uptime) {
 }
 JS_METHOD_END
 
+// uv_run_jx calls it before the loop blocks, the engine collects in the idle
+// window instead of the middle of the next request
+static void IdleNotify(uv_loop_t* loop, unsigned int budget) {
+  node::commons* com = node::commons::getInstance();
+  if (com == NULL || com->node_isolate == NULL || com->expects_reset) return;
+  JS_DEFINE_STATE_MARKER(com);
+
+#ifdef JS_ENGINE_V8
+  v8::HeapStatistics v8_heap_stats;
+  if (com->idle_gc_done) {
+    JS_GET_HEAP_STATICS(&v8_heap_stats);
+    if (v8_heap_stats.used_heap_size() == com->idle_gc_heap_used) return;
+  }
+#endif
+
+  const uint64_t start = uv_hrtime();
+#ifdef V8_IS_3_14
+  com->idle_gc_done = JS_IDLE_NOTIFICATION(com->idle_gc_hint);
+#else
+  com->idle_gc_done = JS_IDLE_NOTIFICATION(budget);
+#endif
+  const uint64_t elapsed = uv_hrtime() - start;
+  com->idle_gc_time += elapsed;
+  com->idle_gc_notifications++;
+
+#ifdef V8_IS_3_14
+  // the next hint follows the time this one has taken. a single
+  // notification may still take longer than the budget
+  const uint64_t budget_ns = (uint64_t)budget * 1000000;
+  if (elapsed > budget_ns) {
+    com->idle_gc_hint /= 2;
+    if (com->idle_gc_hint < IDLE_GC_MIN_HINT)
+      com->idle_gc_hint = IDLE_GC_MIN_HINT;
+  } else if (elapsed < budget_ns / 2) {
+    com->idle_gc_hint *= 2;
+    if (com->idle_gc_hint > IDLE_GC_MAX_HINT)
+      com->idle_gc_hint = IDLE_GC_MAX_HINT;
+  }
+#endif
+
+  if (com->idle_gc_done) {
+    com->idle_gc_completed++;
+#ifdef JS_ENGINE_V8
+    JS_GET_HEAP_STATICS(&v8_heap_stats);
+    com->idle_gc_heap_used = v8_heap_stats.used_heap_size();
+#endif
+  }
+}
+
+// idleGC([budget]) sets the budget (ms) when it's given and returns the stats
+// of the thread
+static JS_LOCAL_METHOD(IdleGC) {
+  if (args.Length() > 0 && !args.IsUndefined(0)) {
+    if (!args.IsNumber(0) || args.GetInteger(0) < 0) {
+      THROW_TYPE_EXCEPTION(
+          "budget must be a non-negative number of milliseconds");
+    }
+    com->idle_gc_budget = args.GetUInteger(0);
+    uv_loop_set_idle_notify(com->loop, IdleNotify, com->idle_gc_budget);
+  }
+
+  JS_LOCAL_OBJECT info = JS_NEW_EMPTY_OBJECT();
+  JS_NAME_SET(info, JS_STRING_ID("budget"),
+              STD_TO_UNSIGNED(com->idle_gc_budget));
+  JS_NAME_SET(info, JS_STRING_ID("notifications"),
+              STD_TO_NUMBER((double)com->idle_gc_notifications));
+  JS_NAME_SET(info, JS_STRING_ID("completed"),
+              STD_TO_NUMBER((double)com->idle_gc_completed));
+  JS_NAME_SET(info, JS_STRING_ID("time"),
+              STD_TO_NUMBER(com->idle_gc_time / 1e6));
+
+  RETURN_POINTER(info);
+}
+JS_METHOD_END
+
 JS_LOCAL_METHOD(MemoryUsage) {
   size_t rss;
 
@@ -2268,6 +2593,8 @@ void SetupProcessObject(const int threadId, bool debug_worker) {
   JS_METHOD_SET(process, "_getActiveRequests", GetActiveRequests);
   JS_METHOD_SET(process, "_getActiveHandles", GetActiveHandles);
   JS_METHOD_SET(process, "_needTickCallback", NeedTickCallback);
+  JS_METHOD_SET(process, "_pushTick", PushTick);
+  JS_METHOD_SET(process, "_runTicks", RunTicks);
   JS_METHOD_SET(process, "reallyExit", Exit);
   JS_METHOD_SET(process, "abort", Abort);
   JS_METHOD_SET(process, "chdir", Chdir);
@@ -2298,6 +2625,8 @@ void SetupProcessObject(const int threadId, bool debug_worker) {
 
   JS_METHOD_SET(process, "uptime", Uptime);
   JS_METHOD_SET(process, "memoryUsage", MemoryUsage);
+  JS_METHOD_SET(process, "idleGC", IdleGC);
+  uv_loop_set_idle_notify(com->loop, IdleNotify, com->idle_gc_budget);
 
   JS_METHOD_SET(process, "binding", JXBinding);
 
@@ -2373,11 +2702,12 @@ void Load(JS_HANDLE_OBJECT process_l) {
 #if defined HAVE_DTRACE || defined HAVE_ETW || defined HAVE_SYSTEMTAP
     InitDTrace(global);
 #endif
+  }
 
 #if defined HAVE_PERFCTR
-    InitPerfCounters(global);
+  // every thread gets the COUNTER_* probes lib/ calls
+  InitPerfCounters(global);
 #endif
-  }
 
   JS_METHOD_CALL(f, global, 1, args);
   if (try_catch.HasCaught()) {
@@ -809,6 +809,10 @@
 
   startup.processNextTick = function() {
     var _needTickCallback = process._needTickCallback;
+    var _pushTick = process._pushTick;
+    // the callbacks without a domain are queued on the native side
+    // (see RunTickQueue in src/node.cc). this one is used after
+    // process._usingDomains() switches to _nextDomainTick
     var nextTickQueue = new Array();
     var needSpinner = true;
     var inTick = false;
@@ -817,6 +821,7 @@
     // can have easy accesss to our nextTick state, and avoid unnecessary
     // calls into process._tickCallback.
     // order is [length, index, depth]
+    // until the domains are in use, length is the size of the native queue
     // Never write code like this without very good reason!
     var infoBox = process._tickInfoBox;
     var length = 0;
@@ -826,7 +831,7 @@
     // needs to be accessible from cc land
     process._currentTickHandler = _nextTick;
     process._nextDomainTick = _nextDomainTick;
-    process._tickCallback = _tickCallback;
+    process._tickCallback = process._runTicks;
     process._tickDomainCallback = _tickDomainCallback;
     process._tickFromSpinner = _tickFromSpinner;
 
@@ -898,47 +903,6 @@
       process._tickCallback();
     }
 
-    // run callbacks that have no domain
-    // using domains will cause this to be overridden
-    function _tickCallback() {
-      var callback, nextTickLength, threw;
-
-      if (inTick)
-        return;
-      if (infoBox[length] === 0) {
-        infoBox[index] = 0;
-        infoBox[depth] = 0;
-        return;
-      }
-      inTick = true;
-
-      while (infoBox[depth]++ < process.maxTickDepth) {
-        nextTickLength = infoBox[length];
-        if (infoBox[index] === nextTickLength)
-          return tickDone(0);
-
-        while (infoBox[index] < nextTickLength) {
-          callback = nextTickQueue[infoBox[index]++].callback;
-          // threw = true;
-          try {
-            callback();
-            // threw = false;
-          }
-          // JIT doesn't support try/finally!
-          // finally {
-          // if (threw)
-          // tickDone(infoBox[depth]);
-          // }
-          catch (ee) {
-            tickDone(infoBox[depth]);
-            throw ee;
-          }
-        }
-      }
-
-      tickDone(0);
-    }
-
     function _tickDomainCallback() {
       var nextTickLength, tock, callback, threw;
 
@@ -1000,18 +964,7 @@
         maxTickWarn();
       }
 
-      var obj = {
-        callback: callback,
-        domain: null
-      };
-
-      nextTickQueue.push(obj);
-      infoBox[length]++;
-
-      if (needSpinner) {
-        _needTickCallback();
-        needSpinner = false;
-      }
+      _pushTick(callback);
     }
 
     function _nextDomainTick(callback) {
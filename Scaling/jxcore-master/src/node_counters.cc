@@ -65,6 +65,7 @@ static void counter_gc_done(v8::GCType type, v8::GCCallbackFlags flags) {
           static_cast<unsigned int>((gcperiod * 100) / totalperiod);
 
       NODE_COUNT_GC_PERCENTTIME(percent);
+      NODE_COUNT_GC_TIME(gcperiod);
       com->counter_gc_end_time = endgc;
     }
   }
@@ -74,14 +75,14 @@ static void counter_gc_done(v8::GCType type, v8::GCCallbackFlags flags) {
 
 struct dtabs {
   const char *name;
-  JS_HANDLE_VALUE (*func)(const JS_V8_ARGUMENT &);
+  JS_NATIVE_RETURN_TYPE (*func)(const JS_V8_ARGUMENT &);
   JS_PERSISTENT_FUNCTION_TEMPLATE templ;
 };
 static jxcore::ThreadStore<dtabs[6]> tabs;
 #define NODE_PROBE(a, nm) \
   a.name = #nm;           \
   a.func = nm;            \
-  a.templ = JS_PERSISTENT_FUNCTION_TEMPLATE()
+  JS_NEW_EMPTY_PERSISTENT_FUNCTION_TEMPLATE(a.templ)
 
 void InitPerfCounters(JS_HANDLE_OBJECT target) {
   JS_ENTER_SCOPE_COM();
@@ -97,15 +98,21 @@ void InitPerfCounters(JS_HANDLE_OBJECT target) {
   NODE_PROBE(tabs.templates[tid][5], COUNTER_HTTP_CLIENT_RESPONSE);
 
   for (int i = 0; i < 6; i++) {
-    tabs.templates[tid][i].templ = JS_PERSISTENT_FUNCTION_TEMPLATE::New(
-        JS_NEW_FUNCTION_TEMPLATE(tabs.templates[tid][i].func));
-    JS_NAME_SET(target, JS_STRING_ID(tabs.templates[tid][i].name),
-                tabs.templates[tid][i].templ->GetFunction());
+    dtabs &tab = tabs.templates[tid][i];
+    JS_LOCAL_FUNCTION_TEMPLATE fnct = JS_NEW_FUNCTION_TEMPLATE(tab.func);
+    JS_NEW_PERSISTENT_FUNCTION_TEMPLATE(tab.templ, fnct);
+    JS_NAME_SET(target, JS_STRING_ID(tab.name), JS_GET_FUNCTION(fnct));
   }
 
-  // Only Windows performance counters supported
-  // To enable other OS, use conditional compilation here
-  InitPerfCountersWin32();
+  // the provider is process wide, the probes and the GC hooks above and
+  // below belong to the thread
+  if (tid == 0) {
+#ifdef _WIN32
+    InitPerfCountersWin32();
+#else
+    InitPerfCountersLinux();
+#endif
+  }
 
   // init times for GC percent calculation and hook callbacks
   com->counter_gc_start_time = NODE_COUNT_GET_GC_RAWTIME();
@@ -116,8 +123,10 @@ void InitPerfCounters(JS_HANDLE_OBJECT target) {
 }
 
 void TermPerfCounters(JS_HANDLE_OBJECT target) {
-  // Only Windows performance counters supported
-  // To enable other OS, use conditional compilation here
+#ifdef _WIN32
   TermPerfCountersWin32();
+#else
+  TermPerfCountersLinux();
+#endif
 }
 }  // namespace node
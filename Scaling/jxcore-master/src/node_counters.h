@@ -11,8 +11,10 @@ void InitPerfCounters(JS_HANDLE_OBJECT target);
 void TermPerfCounters(JS_HANDLE_OBJECT target);
 }
 
-#ifdef HAVE_PERFCTR
+#if defined(HAVE_PERFCTR) && defined(_WIN32)
 #include "platform/win/node_win32_perfctr_provider.h"
+#elif defined(HAVE_PERFCTR)
+#include "platform/linux/node_linux_perfctr_provider.h"
 #else
 #define NODE_COUNTER_ENABLED() (false)
 #define NODE_COUNT_HTTP_SERVER_REQUEST()
@@ -24,9 +26,14 @@ void TermPerfCounters(JS_HANDLE_OBJECT target);
 #define NODE_COUNT_NET_BYTES_SENT(bytes)
 #define NODE_COUNT_NET_BYTES_RECV(bytes)
 #define NODE_COUNT_GET_GC_RAWTIME()
-#define NODE_COUNT_GC_PERCENTTIME()
+#define NODE_COUNT_GC_PERCENTTIME(percent)
+#define NODE_COUNT_GC_TIME(nanoseconds)
 #define NODE_COUNT_PIPE_BYTES_SENT(bytes)
 #define NODE_COUNT_PIPE_BYTES_RECV(bytes)
+#define NODE_COUNT_TASK_QUEUED()
+#define NODE_COUNT_TASK_DEQUEUED()
+#define NODE_COUNT_STORE_READ()
+#define NODE_COUNT_STORE_WRITE()
 #endif
 
 #endif  // SRC_NODE_COUNTERS_H_
@@ -26,6 +26,11 @@ NODE_EXT_LIST_ITEM(node_tty_wrap)
 NODE_EXT_LIST_ITEM(node_process_wrap)
 NODE_EXT_LIST_ITEM(node_fs_event_wrap)
 NODE_EXT_LIST_ITEM(node_signal_wrap)
+NODE_EXT_LIST_ITEM(node_querystring_wrap)
+NODE_EXT_LIST_ITEM(node_url_wrap)
+NODE_EXT_LIST_ITEM(node_string_decoder_wrap)
+NODE_EXT_LIST_ITEM(node_line_splitter_wrap)
+NODE_EXT_LIST_ITEM(node_websocket_wrap)
 
 NODE_EXT_LIST_ITEM(node_crypto_extension_wrap)
 
@@ -2,6 +2,7 @@
 
 #include "node.h"
 #include "jx/memory_store.h"
+#include "jx/store_allocator.h"
 #ifdef JXCORE_SOURCES_MINIFIED
 #include "jx_natives.h"
 #else
@@ -35,15 +36,12 @@ void JXDefineJavaScript() {
 
   std::string name = "jxcore";
   std::string value = "throw new Error('jxcore is a global variable');";
-  char *tmp = (char *)malloc(sizeof(char) * value.length() + 1);
-  memcpy(tmp, value.c_str(), sizeof(char) * value.length());
-  tmp[value.length()] = char(0);
-
   MAP_HOST_DATA jdata;
   jdata.length_ = value.length();
-  jdata.data_ = tmp;
+  jdata.data_ = StoreAllocator::New(-1, value.c_str(), value.length());
 
   XSpace::Store()->insert(std::make_pair(name, jdata));
+  XSpace::Stats()->Add(name, jdata.length_);
   XSpace::UNLOCKSTORE();
 
   for (int i = 0; jxcore::natives[i].name; i++) {
@@ -51,12 +49,9 @@ void JXDefineJavaScript() {
       std::string name(jxcore::natives[i].name);
 
       MAP_HOST_DATA data;
-      char *tmp;
       if (strcmp(jxcore::natives[i].name, "_jx_marker") != 0) {
         const size_t cslen = jxcore::natives[i].source_len;
-        tmp = (char *)malloc(sizeof(char) * (cslen + 1));
-        memcpy(tmp, jxcore::natives[i].source, sizeof(char) * cslen);
-        tmp[cslen] = char(0);
+        data.data_ = StoreAllocator::New(-1, jxcore::natives[i].source, cslen);
         data.length_ = cslen;
       } else {  // _jx_marker
         std::string bt(jxcore::natives[i].source);
@@ -69,14 +64,12 @@ void JXDefineJavaScript() {
             break;
         btn += "';";
 
-        tmp = (char *)malloc(sizeof(char) * btn.length() + 1);
-        memcpy(tmp, btn.c_str(), sizeof(char) * btn.length());
-        tmp[btn.length()] = char(0);
+        data.data_ = StoreAllocator::New(-1, btn.c_str(), btn.length());
         data.length_ = btn.length();
       }
-      data.data_ = tmp;
 
       XSpace::Store()->insert(std::make_pair(name, data));
+      XSpace::Stats()->Add(name, data.length_);
     }
   }
 }
@@ -0,0 +1,89 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_PLATFORM_LINUX_NODE_LINUX_PERFCTR_LAYOUT_H_
+#define SRC_PLATFORM_LINUX_NODE_LINUX_PERFCTR_LAYOUT_H_
+
+// Layout of the performance counter segment, shared with tools/jxcounters.c
+// (plain C on purpose).
+//
+// The segment is a memfd named JX_COUNTERS_NAME, readers find it under
+// /proc/<pid>/fd. Without memfd_create it's /dev/shm/jxcore-counters.<pid>.
+//
+//   jx_counters_header                       64 bytes
+//   char names[counter_count][32]            the counter names
+//   (padding up to header_size)
+//   slot[slot_count]                         slot_size bytes each
+//
+// Every slot belongs to a single thread (jxcore threadId + 1, slot 0 takes
+// the threads without an id) and holds counter_count uint64_t values. The
+// slots are cache line padded, the owner thread increments its values
+// without atomics and the readers add the slots up. magic is written last,
+// a reader that sees it can rely on the rest of the header.
+//
+// Counters are only appended, readers take the names and sizes from the
+// header. version changes when the layout itself does.
+
+#include <stdint.h>
+
+#define JX_COUNTERS_MAGIC 0x52544e554f43584aULL  // "JXCOUNTR"
+#define JX_COUNTERS_VERSION 1
+#define JX_COUNTERS_NAME "jxcore-counters"
+#define JX_COUNTERS_LINE 64
+#define JX_COUNTERS_NAME_SIZE 32
+
+enum jx_counter_id {
+  JX_COUNTER_HTTP_SERVER_REQUESTS,
+  JX_COUNTER_HTTP_SERVER_RESPONSES,
+  JX_COUNTER_HTTP_CLIENT_REQUESTS,
+  JX_COUNTER_HTTP_CLIENT_RESPONSES,
+  JX_COUNTER_SERVER_CONNS_OPENED,
+  JX_COUNTER_SERVER_CONNS_CLOSED,
+  JX_COUNTER_NET_BYTES_SENT,
+  JX_COUNTER_NET_BYTES_RECV,
+  JX_COUNTER_PIPE_BYTES_SENT,
+  JX_COUNTER_PIPE_BYTES_RECV,
+  JX_COUNTER_GC_COUNT,
+  JX_COUNTER_GC_TIME,  // nanoseconds
+  JX_COUNTER_TASKS_QUEUED,
+  JX_COUNTER_TASKS_DEQUEUED,
+  JX_COUNTER_STORE_READS,
+  JX_COUNTER_STORE_WRITES,
+  JX_COUNTER_COUNT
+};
+
+#define JX_COUNTER_NAMES           \
+  {                                \
+    "http_server_requests",        \
+    "http_server_responses",       \
+    "http_client_requests",        \
+    "http_client_responses",       \
+    "server_conns_opened",         \
+    "server_conns_closed",         \
+    "net_bytes_sent",              \
+    "net_bytes_recv",              \
+    "pipe_bytes_sent",             \
+    "pipe_bytes_recv",             \
+    "gc_count",                    \
+    "gc_time_ns",                  \
+    "tasks_queued",                \
+    "tasks_dequeued",              \
+    "store_reads",                 \
+    "store_writes"                 \
+  }
+
+typedef struct {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t header_size;  // offset of the first slot
+  uint32_t slot_size;
+  uint32_t slot_count;
+  uint32_t counter_count;
+  uint32_t pid;
+  uint64_t start_time;  // ms since the epoch
+  char reserved[24];
+} jx_counters_header;
+
+#define JX_COUNTERS_ALIGN(n) \
+  (((n) + JX_COUNTERS_LINE - 1) & ~(JX_COUNTERS_LINE - 1))
+
+#endif  // SRC_PLATFORM_LINUX_NODE_LINUX_PERFCTR_LAYOUT_H_
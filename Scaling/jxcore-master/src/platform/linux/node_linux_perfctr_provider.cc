@@ -0,0 +1,130 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "node_counters.h"
+#include "node_linux_perfctr_provider.h"
+#include "jx/commons.h"
+#include "uv.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+namespace node {
+
+char *NodeCounterSegment = NULL;
+__thread uint64_t *NodeCounterSlot = NULL;
+
+static char segment_path[64] = {0};  // /dev/shm fallback, unlinked at exit
+
+// the counters land here until the segment is mapped or when the thread
+// can't have a slot of its own
+static __thread uint64_t spare_slot[JX_COUNTER_COUNT];
+
+uint64_t *GetCounterSlot() {
+  jx_counters_header *header =
+      reinterpret_cast<jx_counters_header *>(NodeCounterSegment);
+  if (header == NULL) return spare_slot;
+
+  const int slot = commons::threadIdFromThreadPrivate() + 1;
+  if (slot < 0 || slot >= static_cast<int>(header->slot_count))
+    return spare_slot;
+
+  NodeCounterSlot = reinterpret_cast<uint64_t *>(
+      NodeCounterSegment + header->header_size + slot * header->slot_size);
+  return NodeCounterSlot;
+}
+
+uint64_t NODE_COUNT_GET_GC_RAWTIME() { return uv_hrtime(); }
+
+static void UnlinkSegment() {
+  if (segment_path[0] != '\0') unlink(segment_path);
+}
+
+static int CreateSegment() {
+  int fd;
+#ifdef __NR_memfd_create
+  fd = syscall(__NR_memfd_create, JX_COUNTERS_NAME, MFD_CLOEXEC);
+  if (fd != -1) return fd;
+#endif
+
+  snprintf(segment_path, sizeof(segment_path), "/dev/shm/%s.%d",
+           JX_COUNTERS_NAME, getpid());
+  fd = open(segment_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd == -1) {
+    segment_path[0] = '\0';
+    return -1;
+  }
+  atexit(UnlinkSegment);
+  return fd;
+}
+
+void InitPerfCountersLinux() {
+  if (NodeCounterSegment != NULL) return;
+
+  static const char names[JX_COUNTER_COUNT][JX_COUNTERS_NAME_SIZE] =
+      JX_COUNTER_NAMES;
+  const size_t header_size =
+      JX_COUNTERS_ALIGN(sizeof(jx_counters_header) + sizeof(names));
+  const size_t slot_size =
+      JX_COUNTERS_ALIGN(sizeof(uint64_t) * JX_COUNTER_COUNT);
+  // slot 0 and threadId + 1 for every thread id up to MAX_JX_THREADS
+  const size_t slot_count = MAX_JX_THREADS + 2;
+  const size_t size = header_size + slot_size * slot_count;
+
+  int fd = CreateSegment();
+  if (fd == -1) return;
+
+  char *segment = NULL;
+  if (ftruncate(fd, size) == 0) {
+    void *addr =
+        mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr != MAP_FAILED) segment = static_cast<char *>(addr);
+  }
+
+  // a memfd stays open, the readers reach it through /proc/<pid>/fd. the
+  // /dev/shm file is opened by its name, the mapping keeps it alive
+  if (segment == NULL || segment_path[0] != '\0') close(fd);
+  if (segment == NULL) {
+    UnlinkSegment();
+    segment_path[0] = '\0';
+    return;
+  }
+
+  jx_counters_header *header =
+      reinterpret_cast<jx_counters_header *>(segment);
+  struct timeval now;
+  gettimeofday(&now, NULL);
+
+  header->version = JX_COUNTERS_VERSION;
+  header->header_size = header_size;
+  header->slot_size = slot_size;
+  header->slot_count = slot_count;
+  header->counter_count = JX_COUNTER_COUNT;
+  header->pid = getpid();
+  header->start_time = now.tv_sec * 1000ULL + now.tv_usec / 1000;
+  memcpy(segment + sizeof(jx_counters_header), names, sizeof(names));
+
+  __sync_synchronize();
+  header->magic = JX_COUNTERS_MAGIC;
+
+  NodeCounterSegment = segment;
+}
+
+void TermPerfCountersLinux() {
+  if (NodeCounterSegment == NULL) return;
+
+  // the mapping stays, the threads that resolved a slot may still count
+  NodeCounterSegment = NULL;
+  UnlinkSegment();
+  segment_path[0] = '\0';
+}
+}  // namespace node
@@ -0,0 +1,83 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_PLATFORM_LINUX_NODE_LINUX_PERFCTR_PROVIDER_H_
+#define SRC_PLATFORM_LINUX_NODE_LINUX_PERFCTR_PROVIDER_H_
+
+#include <stdint.h>
+#include "node_linux_perfctr_layout.h"
+
+#define INLINE inline __attribute__((always_inline))
+
+namespace node {
+
+// NULL until InitPerfCountersLinux maps the segment (or when it failed)
+extern char *NodeCounterSegment;
+
+// the counters of the calling thread. resolved once per thread, the
+// increments below are plain adds into the thread's own cache lines
+extern __thread uint64_t *NodeCounterSlot;
+uint64_t *GetCounterSlot();
+
+INLINE uint64_t *CounterSlot() {
+  uint64_t *slot = NodeCounterSlot;
+  if (slot == NULL) slot = GetCounterSlot();
+  return slot;
+}
+
+INLINE bool NODE_COUNTER_ENABLED() { return NodeCounterSegment != NULL; }
+
+INLINE void NODE_COUNT_HTTP_SERVER_REQUEST() {
+  CounterSlot()[JX_COUNTER_HTTP_SERVER_REQUESTS]++;
+}
+INLINE void NODE_COUNT_HTTP_SERVER_RESPONSE() {
+  CounterSlot()[JX_COUNTER_HTTP_SERVER_RESPONSES]++;
+}
+INLINE void NODE_COUNT_HTTP_CLIENT_REQUEST() {
+  CounterSlot()[JX_COUNTER_HTTP_CLIENT_REQUESTS]++;
+}
+INLINE void NODE_COUNT_HTTP_CLIENT_RESPONSE() {
+  CounterSlot()[JX_COUNTER_HTTP_CLIENT_RESPONSES]++;
+}
+INLINE void NODE_COUNT_SERVER_CONN_OPEN() {
+  CounterSlot()[JX_COUNTER_SERVER_CONNS_OPENED]++;
+}
+INLINE void NODE_COUNT_SERVER_CONN_CLOSE() {
+  CounterSlot()[JX_COUNTER_SERVER_CONNS_CLOSED]++;
+}
+INLINE void NODE_COUNT_NET_BYTES_SENT(int bytes) {
+  CounterSlot()[JX_COUNTER_NET_BYTES_SENT] += bytes;
+}
+INLINE void NODE_COUNT_NET_BYTES_RECV(int bytes) {
+  CounterSlot()[JX_COUNTER_NET_BYTES_RECV] += bytes;
+}
+INLINE void NODE_COUNT_PIPE_BYTES_SENT(int bytes) {
+  CounterSlot()[JX_COUNTER_PIPE_BYTES_SENT] += bytes;
+}
+INLINE void NODE_COUNT_PIPE_BYTES_RECV(int bytes) {
+  CounterSlot()[JX_COUNTER_PIPE_BYTES_RECV] += bytes;
+}
+
+uint64_t NODE_COUNT_GET_GC_RAWTIME();
+// the readers derive the percentage from gc_time_ns over their own interval
+INLINE void NODE_COUNT_GC_PERCENTTIME(unsigned int percent) {}
+INLINE void NODE_COUNT_GC_TIME(uint64_t nanoseconds) {
+  uint64_t *slot = CounterSlot();
+  slot[JX_COUNTER_GC_COUNT]++;
+  slot[JX_COUNTER_GC_TIME] += nanoseconds;
+}
+
+INLINE void CounterAdd(int id, uint64_t value) { CounterSlot()[id] += value; }
+
+void InitPerfCountersLinux();
+void TermPerfCountersLinux();
+}
+
+// the callers of these aren't in namespace node (jxcore's task queue).
+// the queue depth is tasks_queued - tasks_dequeued
+#define NODE_COUNT_TASK_QUEUED() node::CounterAdd(JX_COUNTER_TASKS_QUEUED, 1)
+#define NODE_COUNT_TASK_DEQUEUED() \
+  node::CounterAdd(JX_COUNTER_TASKS_DEQUEUED, 1)
+#define NODE_COUNT_STORE_READ() node::CounterAdd(JX_COUNTER_STORE_READS, 1)
+#define NODE_COUNT_STORE_WRITE() node::CounterAdd(JX_COUNTER_STORE_WRITES, 1)
+
+#endif  // SRC_PLATFORM_LINUX_NODE_LINUX_PERFCTR_PROVIDER_H_
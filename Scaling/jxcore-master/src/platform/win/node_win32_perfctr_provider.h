@@ -46,6 +46,13 @@ void NODE_COUNT_GC_PERCENTTIME(unsigned int percent);
 void NODE_COUNT_PIPE_BYTES_SENT(int bytes);
 void NODE_COUNT_PIPE_BYTES_RECV(int bytes);
 
+// not in the Windows counter set (yet)
+#define NODE_COUNT_GC_TIME(nanoseconds)
+#define NODE_COUNT_TASK_QUEUED()
+#define NODE_COUNT_TASK_DEQUEUED()
+#define NODE_COUNT_STORE_READ()
+#define NODE_COUNT_STORE_WRITE()
+
 void InitPerfCountersWin32();
 void TermPerfCountersWin32();
 
@@ -3,6 +3,7 @@
 #include "jxtimers_wrap.h"
 #include "jx/extend.h"
 #include "jx/memory_store.h"
+#include "jx/store_allocator.h"
 
 #include <stdio.h>
 #include <string>
@@ -56,8 +57,15 @@ void JXTimersWrap::checkKeys() {
   XSpace::UNLOCKTIMERS();
   if (!todelete.empty()) {
     XSpace::LOCKSTORE();
+    _StringStore *store = XSpace::Store();
     while (!todelete.empty()) {
-      XSpace::Store()->erase(todelete.front());
+      const std::string &key = todelete.front();
+      _StringStore::const_iterator it = store->find(key);
+      if (it != store->end()) {
+        XSpace::Stats()->Remove(key, it->second.length_);
+        StoreAllocator::Delete(-1, it->second.data_, it->second.length_);
+        store->erase(key);
+      }
       todelete.pop();
     }
     XSpace::UNLOCKSTORE();
@@ -0,0 +1,156 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "line_splitter_wrap.h"
+#include "node_buffer.h"
+#include "jx/commons.h"
+#include <string.h>
+#include <string>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace node {
+
+// the unfinished line doesn't keep a larger allocation once it's emitted
+#define MAX_IDLE_TAIL (64 * 1024)
+
+class LineSplitter : public ObjectWrap {
+  friend class LineSplitterWrap;
+
+ public:
+  explicit LineSplitter(const bool any_ending)
+      : ObjectWrap(), any_ending_(any_ending), saw_return_(false) {}
+
+ private:
+  std::string tail_;
+  bool any_ending_;
+  bool saw_return_;  // the last Buffer ended with \r
+};
+
+// the first \r or \n
+static inline const char *FindLineEnd(const char *data, const char *end) {
+#if defined(__SSE2__)
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i lf = _mm_set1_epi8('\n');
+  for (; data + 16 <= end; data += 16) {
+    const __m128i chunk = _mm_loadu_si128((const __m128i *)data);
+    const int mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+    if (mask != 0) return data + __builtin_ctz(mask);
+  }
+#endif
+  for (; data < end; data++) {
+    if (*data == '\n' || *data == '\r') return data;
+  }
+  return NULL;
+}
+
+struct LineRange {
+  const char *data_;
+  size_t length_;
+};
+
+JS_METHOD(LineSplitterWrap, New) {
+  JS_CLASS_NEW_INSTANCE(obj, LineSplitter);
+  LineSplitter *splitter =
+      new LineSplitter(args.Length() > 0 && args.GetBoolean(0));
+  splitter->Wrap(obj);
+  RETURN_POINTER(obj);
+}
+JS_METHOD_END
+
+JS_METHOD(LineSplitterWrap, Write) {
+  LineSplitter *splitter = ObjectWrap::Unwrap<LineSplitter>(args.This());
+
+  if (!Buffer::jxHasInstance(GET_ARG(0), com)) {
+    THROW_TYPE_EXCEPTION("expects a Buffer");
+  }
+  JS_LOCAL_OBJECT buffer = JS_VALUE_TO_OBJECT(GET_ARG(0));
+  const char *pos = BUFFER__DATA(buffer);
+  const char *end = pos + BUFFER__LENGTH(buffer);
+
+  // \r\n split by the Buffers
+  if (pos < end) {
+    if (splitter->saw_return_ && *pos == '\n') pos++;
+    splitter->saw_return_ = false;
+  }
+
+  std::vector<LineRange> lines;
+  while (pos < end) {
+    const char *line_end;
+    if (splitter->any_ending_) {
+      line_end = FindLineEnd(pos, end);
+    } else {
+      line_end = (const char *)memchr(pos, '\n', end - pos);
+    }
+    if (line_end == NULL) break;
+
+    LineRange line = {pos, (size_t)(line_end - pos)};
+    if (lines.empty() && !splitter->tail_.empty()) {
+      splitter->tail_.append(pos, line_end - pos);
+      line.data_ = NULL;
+    }
+    lines.push_back(line);
+
+    pos = line_end + 1;
+    if (*line_end == '\r') {
+      if (pos == end) {
+        splitter->saw_return_ = true;
+      } else if (*pos == '\n') {
+        pos++;
+      }
+    }
+  }
+
+  JS_LOCAL_ARRAY arr = JS_NEW_ARRAY_WITH_COUNT(lines.size());
+  for (size_t i = 0; i < lines.size(); i++) {
+    const char *data = lines[i].data_;
+    size_t length = lines[i].length_;
+    // the first line continues the unfinished one
+    if (data == NULL) {
+      data = splitter->tail_.c_str();
+      length = splitter->tail_.length();
+    }
+
+    if (length == 0) {
+      JS_INDEX_SET(arr, i, JS_NEW_EMPTY_STRING());
+    } else {
+      JS_INDEX_SET(arr, i, UTF8_TO_STRING_WITH_LENGTH(data, length));
+    }
+  }
+
+  if (!lines.empty() && lines[0].data_ == NULL) {
+    if (splitter->tail_.capacity() > MAX_IDLE_TAIL) {
+      std::string().swap(splitter->tail_);
+    } else {
+      splitter->tail_.clear();
+    }
+  }
+  splitter->tail_.append(pos, end - pos);
+
+  RETURN_PARAM(arr);
+}
+JS_METHOD_END
+
+JS_METHOD(LineSplitterWrap, End) {
+  LineSplitter *splitter = ObjectWrap::Unwrap<LineSplitter>(args.This());
+
+  std::string tail;
+  tail.swap(splitter->tail_);
+  splitter->saw_return_ = false;
+
+  if (tail.empty()) RETURN_PARAM(JS_NEW_EMPTY_STRING());
+  RETURN_PARAM(UTF8_TO_STRING_WITH_LENGTH(tail.c_str(), tail.length()));
+}
+JS_METHOD_END
+
+JS_METHOD(LineSplitterWrap, Pending) {
+  LineSplitter *splitter = ObjectWrap::Unwrap<LineSplitter>(args.This());
+  RETURN_PARAM(STD_TO_UNSIGNED(splitter->tail_.length()));
+}
+JS_METHOD_END
+
+}  // namespace node
+
+NODE_MODULE(node_line_splitter_wrap, node::LineSplitterWrap::Initialize)
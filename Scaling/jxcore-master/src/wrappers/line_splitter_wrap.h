@@ -0,0 +1,37 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_WRAPPERS_LINE_SPLITTER_WRAP_H_
+#define SRC_WRAPPERS_LINE_SPLITTER_WRAP_H_
+
+#include "node.h"
+
+namespace node {
+
+// splits the UTF-8 Buffers of a stream into lines. The unfinished line is
+// kept natively until its line ending arrives
+//
+// new LineSplitter(anyEnding)
+//   anyEnding: false splits on \n (IPC), true on \r\n, \n and \r (readline)
+class LineSplitterWrap {
+  static DEFINE_JS_METHOD(New);
+
+  // write(buffer) returns the array of the completed lines
+  static DEFINE_JS_METHOD(Write);
+
+  // end() returns the unfinished line and resets the splitter
+  static DEFINE_JS_METHOD(End);
+
+  // pending() returns the byte length of the unfinished line
+  static DEFINE_JS_METHOD(Pending);
+
+  INIT_NAMED_CLASS_MEMBERS(LineSplitter, LineSplitterWrap) {
+    NODE_SET_PROTOTYPE_METHOD(constructor, "write", Write);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "end", End);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "pending", Pending);
+  }
+  END_INIT_NAMED_MEMBERS(LineSplitter)
+};
+
+}  // namespace node
+
+#endif  // SRC_WRAPPERS_LINE_SPLITTER_WRAP_H_
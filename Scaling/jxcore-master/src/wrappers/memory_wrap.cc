@@ -2,8 +2,11 @@
 
 #include "memory_wrap.h"
 #include "node_buffer.h"
+#include "node_counters.h"
+#include "jx/buffer_allocator.h"
 #include "jx/extend.h"
 #include "jx/memory_store.h"
+#include "jx/store_allocator.h"
 #include <iostream>
 
 namespace node {
@@ -40,6 +43,7 @@ JS_METHOD(MemoryWrap, SetCPUCountMap) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, MapGet) {
+  NODE_COUNT_STORE_WRITE();
   if (!args.IsNumber(0) || !args.IsString(1)) {
     THROW_EXCEPTION("Missing parameters (getMap) expects (int, string, bool).");
   }
@@ -56,13 +60,17 @@ JS_METHOD(MemoryWrap, MapGet) {
     if (!args.GetBoolean(2)) {  // is_buffer
       JS_LOCAL_STRING str =
           UTF8_TO_STRING_WITH_LENGTH(it->second.data_, it->second.length_);
-      free(it->second.data_);
+      XSpace::MapStats(tid)->Remove(jstr, it->second.length_);
+      StoreAllocator::Delete(com->threadId, it->second.data_,
+                             it->second.length_);
       node::commons::mapData[tid]->erase(jstr);
       RETURN_PARAM(str);
     } else {
       node::Buffer *buff =
           node::Buffer::New(it->second.data_, it->second.length_, com);
-      free(it->second.data_);
+      XSpace::MapStats(tid)->Remove(jstr, it->second.length_);
+      StoreAllocator::Delete(com->threadId, it->second.data_,
+                             it->second.length_);
       node::commons::mapData[tid]->erase(jstr);
       RETURN_PARAM(JS_TYPE_TO_LOCAL_OBJECT(buff->handle_));
     }
@@ -71,6 +79,7 @@ JS_METHOD(MemoryWrap, MapGet) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, MapExist) {
+  NODE_COUNT_STORE_READ();
   if (!args.IsNumber(0) || !args.IsString(1)) {
     THROW_EXCEPTION("Missing parameters (existMap) expects (int, string).");
   }
@@ -87,6 +96,7 @@ JS_METHOD(MemoryWrap, MapExist) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, MapRead) {
+  NODE_COUNT_STORE_READ();
   if (!args.IsNumber(0) || !args.IsString(1)) {
     THROW_EXCEPTION(
         "Missing parameters (readMap) expects (int, string, bool).");
@@ -114,6 +124,7 @@ JS_METHOD(MemoryWrap, MapRead) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, MapRemove) {
+  NODE_COUNT_STORE_WRITE();
   if (!args.IsNumber(0) || !args.IsString(1)) {
     THROW_EXCEPTION("Missing parameters (removeMap) expects (int, string).");
   }
@@ -126,19 +137,67 @@ JS_METHOD(MemoryWrap, MapRemove) {
   BTStore::const_iterator it = node::commons::mapData[tid]->find(jstr);
 
   if (it != node::commons::mapData[tid]->end()) {
-    free(it->second.data_);
+    XSpace::MapStats(tid)->Remove(jstr, it->second.length_);
+    StoreAllocator::Delete(com->threadId, it->second.data_,
+                           it->second.length_);
     node::commons::mapData[tid]->erase(jstr);
   }
 }
 JS_METHOD_END
 
-#define COPY_BUFFER(buf, to)                                \
-  size_t ln_##buf = BUFFER__LENGTH(buf);                    \
-  char *to = (char *)malloc(sizeof(char) * (ln_##buf + 1)); \
-  memcpy(to, BUFFER__DATA(buf), sizeof(char) * (ln_##buf)); \
-  to[ln_##buf] = char(0)
+// picks the string / buffer argument at 'index' without copying it
+// (the JXString keeps the string data alive until the end of the scope)
+#define GET_VALUE_ARG(index, name)                                          \
+  jxcore::JXString name##_str;                                             \
+  const char *name;                                                        \
+  size_t name##_len;                                                       \
+  if (args.IsString(index)) {                                              \
+    args.GetString(index, &name##_str);                                    \
+    name = *name##_str;                                                    \
+    name##_len = name##_str.length();                                      \
+  } else {                                                                 \
+    JS_LOCAL_OBJECT name##_obj = JS_VALUE_TO_OBJECT(args.GetItem(index));  \
+    name = BUFFER__DATA(name##_obj);                                       \
+    name##_len = BUFFER__LENGTH(name##_obj);                               \
+  }
+
+static inline bool ValueEquals(const MAP_HOST_DATA &data, const char *value,
+                               const size_t length) {
+  return data.length_ == length && memcmp(data.data_, value, length) == 0;
+}
+
+// sets or overwrites the value for key. an existing entry keeps its node and
+// key, the value block is reused when the new value fits its size class
+static void PutValue(const int tid, BTStore *store, StoreStats *stats,
+                     const std::string &key, const char *value,
+                     const size_t length) {
+  BTStore::iterator it = store->find(key);
+
+  if (it != store->end()) {
+    MAP_HOST_DATA &data = it->second;
+    stats->Remove(key, data.length_);
+
+    if (!StoreAllocator::Overwrite(tid, data.data_, data.length_, value,
+                                   length)) {
+      char *block = StoreAllocator::New(tid, value, length);
+      StoreAllocator::Delete(tid, data.data_, data.length_);
+      data.data_ = block;
+    }
+    data.length_ = length;
+    stats->Add(key, length);
+    return;
+  }
+
+  MAP_HOST_DATA data;
+  data.length_ = length;
+  data.data_ = StoreAllocator::New(tid, value, length);
+
+  store->insert(std::make_pair(key, data));
+  stats->Add(key, length);
+}
 
 JS_METHOD(MemoryWrap, MapSet) {
+  NODE_COUNT_STORE_WRITE();
   if (!args.IsNumber(0) || !args.IsString(1) ||
       (!Buffer::jxHasInstance(args.GetItem(2), com) && !args.IsString(2))) {
     THROW_EXCEPTION(
@@ -150,22 +209,10 @@ JS_METHOD(MemoryWrap, MapSet) {
   args.GetString(1, &str_key);
   std::string str_keys(*str_key);
 
-  MAP_HOST_DATA data;
-  if (!args.IsString(2)) {
-    JS_LOCAL_OBJECT obj = JS_VALUE_TO_OBJECT(args.GetItem(2));
-    COPY_BUFFER(obj, val);
-    data.data_ = val;
-    data.length_ = ln_obj;
-  } else {
-    jxcore::JXString val;
-    args.GetString(2, &val);
-    val.DisableAutoGC();
-    data.data_ = *val;
-    data.length_ = val.length();
-  }
+  GET_VALUE_ARG(2, val);
 
-  node::commons::mapData[tid]->erase(str_keys);
-  node::commons::mapData[tid]->insert(std::make_pair(str_keys, data));
+  PutValue(com->threadId, node::commons::mapData[tid], XSpace::MapStats(tid),
+           str_keys, val, val_len);
 }
 JS_METHOD_END
 
@@ -178,15 +225,17 @@ void MemoryWrap::MapClear(const bool clear_blocks) {
   for (int n = 0; n < commons::mapCount; n++) {
     BTStore::const_iterator it = commons::mapData[n]->begin();
     for (; it != commons::mapData[n]->end(); it++) {
-      free(it->second.data_);
+      StoreAllocator::Delete(-1, it->second.data_, it->second.length_);
     }
     commons::mapData[n]->clear();
+    XSpace::MapStats(n)->Clear();
     if (clear_blocks) delete commons::mapData[n];
   }
   commons::mapCount = 0;
 }
 
 JS_METHOD(MemoryWrap, SourceSetIfNotExists) {
+  NODE_COUNT_STORE_WRITE();
   if (XSpace::Store() == NULL) RETURN();
 
   if (!args.IsString(0) ||
@@ -200,27 +249,15 @@ JS_METHOD(MemoryWrap, SourceSetIfNotExists) {
   args.GetString(0, &str_key);
   std::string str_keys(*str_key);
 
+  GET_VALUE_ARG(1, val);
+
   bool set = false;
   XSpace::LOCKSTORE();
   _StringStore *store = XSpace::Store();
   if (store != NULL) {
     _StringStore::const_iterator it = store->find(str_keys);
     if (it == store->end()) {
-      MAP_HOST_DATA data;
-      if (!args.IsString(1)) {
-        JS_LOCAL_OBJECT obj = JS_VALUE_TO_OBJECT(args.GetItem(1));
-        COPY_BUFFER(obj, val);
-        data.data_ = val;
-        data.length_ = ln_obj;
-      } else {
-        jxcore::JXString val;
-        args.GetString(1, &val);
-        val.DisableAutoGC();
-        data.data_ = *val;
-        data.length_ = val.length();
-      }
-
-      store->insert(std::make_pair(str_keys, data));
+      PutValue(com->threadId, store, XSpace::Stats(), str_keys, val, val_len);
       set = true;
     }
   }
@@ -231,6 +268,7 @@ JS_METHOD(MemoryWrap, SourceSetIfNotExists) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, SourceSetIfEq) {
+  NODE_COUNT_STORE_WRITE();
   if (XSpace::Store() == NULL) RETURN();
 
   if (!args.IsString(0) ||
@@ -246,50 +284,18 @@ JS_METHOD(MemoryWrap, SourceSetIfEq) {
   args.GetString(0, &str_key);
   std::string str_keys(*str_key);
 
+  GET_VALUE_ARG(1, val);
+  GET_VALUE_ARG(2, cmp);
+
   bool set = false;
   XSpace::LOCKSTORE();
   _StringStore *store = XSpace::Store();
   if (store != NULL) {
     _StringStore::const_iterator it = store->find(str_keys);
-    if (it != store->end()) {
-      std::string cmps;
-      if (args.IsString(2)) {
-        jxcore::JXString cmp;
-        args.GetString(2, &cmp);
-        cmps = *cmp;
-      } else {
-        JS_LOCAL_OBJECT obj = JS_VALUE_TO_OBJECT(args.GetItem(2));
-        cmps = BUFFER__DATA(obj);
-      }
-      std::string org = it->second.data_;
-
-      if (org.compare(cmps) == 0) {
-        _StringStore::const_iterator it = store->find(str_keys);
-
-        if (it != store->end()) {
-          MAP_HOST_DATA old_data = it->second;
-          free(old_data.data_);
-          store->erase(str_keys);
-        }
-
-        MAP_HOST_DATA data;
-        if (!args.IsString(1)) {
-          JS_LOCAL_OBJECT obj = JS_VALUE_TO_OBJECT(args.GetItem(1));
-          COPY_BUFFER(obj, val);
-          data.data_ = val;
-          data.length_ = ln_obj;
-        } else {
-          jxcore::JXString val;
-          args.GetString(1, &val);
-          val.DisableAutoGC();
-          data.data_ = *val;
-          data.length_ = val.length();
-        }
-
-        store->insert(std::make_pair(str_keys, data));
-        set = true;
-        XSpace::ExpirationKick(*str_key);
-      }
+    if (it != store->end() && ValueEquals(it->second, cmp, cmp_len)) {
+      PutValue(com->threadId, store, XSpace::Stats(), str_keys, val, val_len);
+      set = true;
+      XSpace::ExpirationKick(*str_key);
     }
   }
   XSpace::UNLOCKSTORE();
@@ -299,6 +305,7 @@ JS_METHOD(MemoryWrap, SourceSetIfEq) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, SourceSetIfEqOrNull) {
+  NODE_COUNT_STORE_WRITE();
   if (XSpace::Store() == NULL) RETURN();
 
   if (!args.IsString(0) ||
@@ -313,58 +320,18 @@ JS_METHOD(MemoryWrap, SourceSetIfEqOrNull) {
   args.GetString(0, &str_key);
   std::string str_keys(*str_key);
 
+  GET_VALUE_ARG(1, val);
+  GET_VALUE_ARG(2, cmp);
+
   bool set = false;
 
   XSpace::LOCKSTORE();
   _StringStore *store = XSpace::Store();
   if (store != NULL) {
     _StringStore::const_iterator it = store->find(str_keys);
-    bool equal = false;
-    bool null = false;
-
-    if (it == store->end()) {
-      null = true;
-    } else {
-      if (!args.IsString(2)) {
-        JS_LOCAL_OBJECT obj = JS_VALUE_TO_OBJECT(args.GetItem(2));
-        std::string cmps(BUFFER__DATA(obj));
-        std::string org = it->second.data_;
 
-        if (org.compare(cmps) == 0) equal = true;
-      } else {
-        jxcore::JXString val;
-        args.GetString(2, &val);
-        std::string cmps(*val);
-        std::string org = it->second.data_;
-
-        if (org.compare(cmps) == 0) equal = true;
-      }
-    }
-
-    if (equal || null) {
-      _StringStore::const_iterator it = store->find(str_keys);
-
-      if (it != store->end()) {
-        MAP_HOST_DATA old_data = it->second;
-        free(old_data.data_);
-        store->erase(str_keys);
-      }
-
-      MAP_HOST_DATA data;
-      if (!args.IsString(1)) {
-        JS_LOCAL_OBJECT obj = JS_VALUE_TO_OBJECT(args.GetItem(1));
-        COPY_BUFFER(obj, val);
-        data.data_ = val;
-        data.length_ = ln_obj;
-      } else {
-        jxcore::JXString val;
-        args.GetString(1, &val);
-        val.DisableAutoGC();
-        data.data_ = *val;
-        data.length_ = val.length();
-      }
-
-      store->insert(std::make_pair(str_keys, data));
+    if (it == store->end() || ValueEquals(it->second, cmp, cmp_len)) {
+      PutValue(com->threadId, store, XSpace::Stats(), str_keys, val, val_len);
       set = true;
       XSpace::ExpirationKick(*str_key);
     }
@@ -376,34 +343,29 @@ JS_METHOD(MemoryWrap, SourceSetIfEqOrNull) {
 JS_METHOD_END
 
 void MemoryWrap::SharedSet(const char *name, const char *value,
-                           const size_t len) {
+                           const size_t len, const int tid) {
   XSpace::LOCKSTORE();
   _StringStore *store = XSpace::Store();
   if (store != NULL) {
     std::string str_key(name);
-    _StringStore::const_iterator it = store->find(str_key);
-
-    if (it != store->end()) {
-      MAP_HOST_DATA old_data = it->second;
-      free(old_data.data_);
-      store->erase(str_key);
-    }
 
     if (value != NULL) {
-      MAP_HOST_DATA data;
-      char *tmp = (char *)malloc(sizeof(char) * len + 1);
-      memcpy(tmp, value, sizeof(char) * len);
-      tmp[len] = char(0);
-      data.length_ = len;
-      data.data_ = tmp;
-
-      store->insert(std::make_pair(str_key, data));
+      PutValue(tid, store, XSpace::Stats(), str_key, value, len);
+    } else {
+      _StringStore::iterator it = store->find(str_key);
+
+      if (it != store->end()) {
+        XSpace::Stats()->Remove(str_key, it->second.length_);
+        StoreAllocator::Delete(tid, it->second.data_, it->second.length_);
+        store->erase(it);
+      }
     }
   }
   XSpace::UNLOCKSTORE();
 }
 
 JS_METHOD(MemoryWrap, SourceSet) {
+  NODE_COUNT_STORE_WRITE();
   if (XSpace::Store() == NULL) {
     RETURN();
   }
@@ -419,11 +381,11 @@ JS_METHOD(MemoryWrap, SourceSet) {
 
   if (!args.IsString(1)) {
     JS_LOCAL_OBJECT obj = JS_VALUE_TO_OBJECT(args.GetItem(1));
-    SharedSet(*str_key, BUFFER__DATA(obj), BUFFER__LENGTH(obj));
+    SharedSet(*str_key, BUFFER__DATA(obj), BUFFER__LENGTH(obj), com->threadId);
   } else {
     jxcore::JXString val;
     args.GetString(1, &val);
-    SharedSet(*str_key, *val, val.length());
+    SharedSet(*str_key, *val, val.length(), com->threadId);
   }
 
   XSpace::ExpirationKick(*str_key);
@@ -431,6 +393,7 @@ JS_METHOD(MemoryWrap, SourceSet) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, SourceExist) {
+  NODE_COUNT_STORE_READ();
   if (XSpace::Store() == NULL) RETURN_PARAM(STD_TO_BOOLEAN(false));
 
   if (!args.IsString(0)) {
@@ -456,6 +419,7 @@ JS_METHOD(MemoryWrap, SourceExist) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, SourceRead) {
+  NODE_COUNT_STORE_READ();
   if (XSpace::Store() == NULL) RETURN();
 
   if (!args.IsString(0)) {
@@ -494,6 +458,7 @@ JS_METHOD(MemoryWrap, SourceRead) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, SourceRemove) {
+  NODE_COUNT_STORE_WRITE();
   if (XSpace::Store() == NULL) RETURN();
 
   if (!args.IsString(0)) {
@@ -511,7 +476,8 @@ JS_METHOD(MemoryWrap, SourceRemove) {
 
     if (it != store->end()) {
       MAP_HOST_DATA data = it->second;
-      free(data.data_);
+      XSpace::Stats()->Remove(str_keys, data.length_);
+      StoreAllocator::Delete(com->threadId, data.data_, data.length_);
       store->erase(str_keys);
     }
   }
@@ -522,6 +488,7 @@ JS_METHOD(MemoryWrap, SourceRemove) {
 JS_METHOD_END
 
 JS_METHOD(MemoryWrap, SourceGet) {
+  NODE_COUNT_STORE_WRITE();
   if (XSpace::Store() == NULL) RETURN();
 
   if (!args.IsString(0)) {
@@ -542,7 +509,8 @@ JS_METHOD(MemoryWrap, SourceGet) {
         MAP_HOST_DATA data = it->second;
         JS_LOCAL_STRING str =
             UTF8_TO_STRING_WITH_LENGTH(data.data_, data.length_);
-        free(data.data_);
+        XSpace::Stats()->Remove(str_keys, data.length_);
+        StoreAllocator::Delete(com->threadId, data.data_, data.length_);
         store->erase(str_keys);
         XSpace::UNLOCKSTORE();
 
@@ -552,7 +520,9 @@ JS_METHOD(MemoryWrap, SourceGet) {
       } else {
         node::Buffer *buff =
             node::Buffer::New(it->second.data_, it->second.length_, com);
-        free(it->second.data_);
+        XSpace::Stats()->Remove(str_keys, it->second.length_);
+        StoreAllocator::Delete(com->threadId, it->second.data_,
+                               it->second.length_);
         store->erase(str_keys);
         XSpace::UNLOCKSTORE();
 
@@ -565,6 +535,152 @@ JS_METHOD(MemoryWrap, SourceGet) {
 }
 JS_METHOD_END
 
+static JS_LOCAL_OBJECT BuildStoreStats(commons *com, const StoreStats *stats,
+                                       const size_t node_bytes) {
+  JS_ENTER_SCOPE();
+  JS_DEFINE_STATE_MARKER(com);
+
+  JS_LOCAL_OBJECT info = JS_NEW_EMPTY_OBJECT();
+
+  JS_NAME_SET(info, JS_STRING_ID("keys"), STD_TO_NUMBER(stats->keys_));
+  JS_NAME_SET(info, JS_STRING_ID("keyBytes"),
+              STD_TO_NUMBER(stats->key_bytes_));
+  JS_NAME_SET(info, JS_STRING_ID("valueBytes"),
+              STD_TO_NUMBER(stats->value_bytes_));
+  JS_NAME_SET(info, JS_STRING_ID("nodeBytes"), STD_TO_NUMBER(node_bytes));
+  JS_NAME_SET(
+      info, JS_STRING_ID("total"),
+      STD_TO_NUMBER(stats->key_bytes_ + stats->value_bytes_ + node_bytes));
+
+  if (stats->prefixes_ != NULL) {
+    JS_LOCAL_OBJECT prefixes = JS_NEW_EMPTY_OBJECT();
+    _PrefixStore::const_iterator it = stats->prefixes_->begin();
+    for (; it != stats->prefixes_->end(); it++) {
+      JS_LOCAL_OBJECT pre = JS_NEW_EMPTY_OBJECT();
+      JS_NAME_SET(pre, JS_STRING_ID("samples"),
+                  STD_TO_NUMBER(it->second.samples_));
+      JS_NAME_SET(pre, JS_STRING_ID("keyBytes"),
+                  STD_TO_NUMBER(it->second.key_bytes_));
+      JS_NAME_SET(pre, JS_STRING_ID("valueBytes"),
+                  STD_TO_NUMBER(it->second.value_bytes_));
+      JS_NAME_SET(prefixes, JS_STRING_ID(it->first.c_str()), pre);
+    }
+    JS_NAME_SET(info, JS_STRING_ID("sampleRate"),
+                STD_TO_INTEGER(stats->sample_rate_));
+    JS_NAME_SET(info, JS_STRING_ID("prefixes"), prefixes);
+  }
+
+  return JS_LEAVE_SCOPE(info);
+}
+
+JS_METHOD(MemoryWrap, MapStats) {
+  if (!args.IsNumber(0)) {
+    THROW_EXCEPTION("Missing parameters (statsMap) expects (int).");
+  }
+
+  int tid = args.GetInteger(0) + 1;
+  if (tid < 0 || tid >= commons::mapCount) RETURN();
+
+  JS_LOCAL_OBJECT info =
+      BuildStoreStats(com, XSpace::MapStats(tid),
+                      StoreStats::NodeBytes(node::commons::mapData[tid]));
+  RETURN_POINTER(info);
+}
+JS_METHOD_END
+
+JS_METHOD(MemoryWrap, MapSampling) {
+  if (!args.IsNumber(0) || !args.IsNumber(1)) {
+    THROW_EXCEPTION("Missing parameters (samplingMap) expects (int, int).");
+  }
+
+  int tid = args.GetInteger(0) + 1;
+  if (tid < 0 || tid > MAX_JX_THREADS) RETURN();
+
+  XSpace::MapStats(tid)->SetSampling(args.GetInteger(1));
+}
+JS_METHOD_END
+
+JS_METHOD(MemoryWrap, SourceStats) {
+  if (XSpace::Store() == NULL) RETURN();
+
+  StoreStats stats;
+  size_t node_bytes = 0;
+
+  XSpace::LOCKSTORE();
+  _StringStore *store = XSpace::Store();
+  if (store != NULL) {
+    const StoreStats *shared = XSpace::Stats();
+    stats.keys_ = shared->keys_;
+    stats.key_bytes_ = shared->key_bytes_;
+    stats.value_bytes_ = shared->value_bytes_;
+    stats.sample_rate_ = shared->sample_rate_;
+    if (shared->prefixes_ != NULL) {
+      stats.prefixes_ = new _PrefixStore(*shared->prefixes_);
+    }
+    node_bytes = StoreStats::NodeBytes(store);
+  }
+  XSpace::UNLOCKSTORE();
+
+  JS_LOCAL_OBJECT info = BuildStoreStats(com, &stats, node_bytes);
+  RETURN_POINTER(info);
+}
+JS_METHOD_END
+
+JS_METHOD(MemoryWrap, SourceSampling) {
+  if (XSpace::Store() == NULL) RETURN();
+
+  if (!args.IsNumber(0)) {
+    THROW_EXCEPTION("Missing parameters (samplingSource) expects (int).");
+  }
+
+  XSpace::LOCKSTORE();
+  XSpace::Stats()->SetSampling(args.GetInteger(0));
+  XSpace::UNLOCKSTORE();
+}
+JS_METHOD_END
+
+JS_METHOD(MemoryWrap, AllocatorStats) {
+  StoreAllocatorStats stats;
+  StoreAllocator::GetStats(&stats);
+
+  JS_LOCAL_OBJECT info = JS_NEW_EMPTY_OBJECT();
+  JS_NAME_SET(info, JS_STRING_ID("reserved"), STD_TO_NUMBER(stats.reserved_));
+  JS_NAME_SET(info, JS_STRING_ID("free"), STD_TO_NUMBER(stats.free_));
+  JS_NAME_SET(info, JS_STRING_ID("used"), STD_TO_NUMBER(stats.used_));
+  JS_NAME_SET(info, JS_STRING_ID("requested"),
+              STD_TO_NUMBER(stats.requested_));
+  JS_NAME_SET(info, JS_STRING_ID("allocs"), STD_TO_NUMBER(stats.allocs_));
+  JS_NAME_SET(info, JS_STRING_ID("frees"), STD_TO_NUMBER(stats.frees_));
+  JS_NAME_SET(info, JS_STRING_ID("reuses"), STD_TO_NUMBER(stats.reuses_));
+
+  // share of the handed out block bytes lost to the size class rounding
+  double fragmentation = 0;
+  if (stats.used_ > 0) {
+    fragmentation = (double)(stats.used_ - stats.requested_) / stats.used_;
+  }
+  JS_NAME_SET(info, JS_STRING_ID("fragmentation"),
+              STD_TO_NUMBER(fragmentation));
+
+  RETURN_POINTER(info);
+}
+JS_METHOD_END
+
+JS_METHOD(MemoryWrap, BufferStats) {
+  BufferAllocatorStats stats;
+  BufferAllocator::GetStats(com->threadId, &stats);
+
+  JS_LOCAL_OBJECT info = JS_NEW_EMPTY_OBJECT();
+  JS_NAME_SET(info, JS_STRING_ID("cached"), STD_TO_NUMBER(stats.cached_));
+  JS_NAME_SET(info, JS_STRING_ID("limit"), STD_TO_NUMBER(stats.limit_));
+  JS_NAME_SET(info, JS_STRING_ID("returned"), STD_TO_NUMBER(stats.returned_));
+  JS_NAME_SET(info, JS_STRING_ID("allocs"), STD_TO_NUMBER(stats.allocs_));
+  JS_NAME_SET(info, JS_STRING_ID("reuses"), STD_TO_NUMBER(stats.reuses_));
+  JS_NAME_SET(info, JS_STRING_ID("frees"), STD_TO_NUMBER(stats.frees_));
+
+  RETURN_POINTER(info);
+}
+JS_METHOD_END
+
 }  // namespace node
 
 NODE_MODULE(node_memory_wrap, node::MemoryWrap::Initialize)
@@ -9,7 +9,8 @@ namespace node {
 
 class MemoryWrap {
  public:
-  static void SharedSet(const char *name, const char *value, const size_t len);
+  static void SharedSet(const char *name, const char *value, const size_t len,
+                        const int tid = -1);
   static void MapClear(const bool clear_blocks);
 
  private:
@@ -43,6 +44,18 @@ class MemoryWrap {
 
   static DEFINE_JS_METHOD(ReadEmbeddedSource);
 
+  static DEFINE_JS_METHOD(MapStats);
+
+  static DEFINE_JS_METHOD(MapSampling);
+
+  static DEFINE_JS_METHOD(SourceStats);
+
+  static DEFINE_JS_METHOD(SourceSampling);
+
+  static DEFINE_JS_METHOD(AllocatorStats);
+
+  static DEFINE_JS_METHOD(BufferStats);
+
   INIT_CLASS_MEMBERS() {
     SET_CLASS_METHOD("readEmbeddedSource", ReadEmbeddedSource, 0);
     SET_CLASS_METHOD("setMapCount", SetCPUCountMap, 1);
@@ -51,6 +64,8 @@ class MemoryWrap {
     SET_CLASS_METHOD("readMap", MapRead, 2);
     SET_CLASS_METHOD("existMap", MapExist, 2);
     SET_CLASS_METHOD("removeMap", MapRemove, 2);
+    SET_CLASS_METHOD("statsMap", MapStats, 1);
+    SET_CLASS_METHOD("samplingMap", MapSampling, 2);
 
     SET_CLASS_METHOD("setSource", SourceSet, 2);
     SET_CLASS_METHOD("setSourceIfNotExists", SourceSetIfNotExists, 2);
@@ -60,6 +75,11 @@ class MemoryWrap {
     SET_CLASS_METHOD("removeSource", SourceRemove, 1);
     SET_CLASS_METHOD("getSource", SourceGet, 1);
     SET_CLASS_METHOD("existsSource", SourceExist, 1);
+    SET_CLASS_METHOD("statsSource", SourceStats, 0);
+    SET_CLASS_METHOD("samplingSource", SourceSampling, 1);
+
+    SET_CLASS_METHOD("statsAllocator", AllocatorStats, 0);
+    SET_CLASS_METHOD("statsBuffers", BufferStats, 0);
   }
   END_INIT_MEMBERS
 };
@@ -2,6 +2,7 @@
 
 #include "node_buffer.h"
 #include "string_bytes.h"
+#include "jx/buffer_allocator.h"
 
 #include <assert.h>
 #include <string.h>  // memcpy
@@ -151,11 +152,23 @@ void Buffer::Replace(char* data, size_t length, free_callback callback,
   node::commons* com = com_;
   JS_DEFINE_STATE_MARKER(com);
 
+#ifdef JS_ENGINE_V8
+  // the blocks come from the size classes of the thread, the engine hears
+  // about the external memory in batches
+  int64_t external = 0;
+  if (callback_) {
+    callback_(data_, callback_hint_);
+  } else if (length_) {
+    BufferAllocator::Delete(com->threadId, data_, length_);
+    external -= static_cast<int64_t>(sizeof(Buffer) + length_);
+  }
+#else
   if (callback_) {
     callback_(data_, callback_hint_);
   } else if (length_) {
     JS_REMOVE_EXTERNAL_MEMORY(data_, length_);
   }
+#endif
 
   length_ = length;
   callback_ = callback;
@@ -164,12 +177,25 @@ void Buffer::Replace(char* data, size_t length, free_callback callback,
   if (callback_) {
     data_ = data;
   } else if (length_) {
+#ifdef JS_ENGINE_V8
+    data_ = BufferAllocator::New(com->threadId, length_);
+    assert(data_ != NULL && "Buffer::Replace out of memory");
+    external += static_cast<int64_t>(sizeof(Buffer) + length_);
+#else
     JS_ADD_EXTERNAL_MEMORY(data_, length_);
+#endif
     if (data) memcpy(data_, data, length_);
   } else {
     data_ = NULL;
   }
 
+#ifdef JS_ENGINE_V8
+  if (external != 0) {
+    external = BufferAllocator::AdjustExternal(com->threadId, external);
+    if (external != 0) JS_ADJUST_EXTERNAL_MEMORY(external);
+  }
+#endif
+
   if (disposing_) return;
 
   JS_LOCAL_VALUE val_len = STD_TO_UNSIGNED(length_);
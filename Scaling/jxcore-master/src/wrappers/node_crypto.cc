@@ -2,6 +2,7 @@
 
 #include "node_crypto.h"
 #include "node_crypto_groups.h"
+#include "node_crypto_random.h"
 #include "node.h"
 #include "node_buffer.h"
 #include "string_bytes.h"
@@ -139,7 +140,7 @@ static int CryptoPemCallback(char *buf, int size, int rwflag, void *u) {
 // The only time when /dev/urandom may conceivably block is right after boot,
 // when the whole system is still low on entropy.  That's not something we can
 // do anything about.
-inline void CheckEntropy() {
+void CheckEntropy() {
   for (;;) {
     int status = RAND_status();
     assert(status >= 0);  // Cannot fail.
@@ -4329,6 +4330,18 @@ JS_LOCAL_METHOD(RandomBytes) {
     THROW_TYPE_EXCEPTION("size > Buffer::kMaxLength");
   }
 
+  // the small synchronous requests come from the thread's buffered pool,
+  // lib/crypto.js calls the callback of the small ones itself
+  if (size <= RANDOM_POOL_SMALL_MAX && !args.IsFunction(1)) {
+    char* data = new char[size];
+    if (RandomPool::Fill(com->threadId, reinterpret_cast<unsigned char*>(data),
+                         size)) {
+      Buffer* buffer = Buffer::New(data, size, RandomBytesFree, NULL, com);
+      RETURN_POINTER(JS_OBJECT_FROM_PERSISTENT(buffer->handle_));
+    }
+    delete[] data;
+  }
+
   RandomBytesRequest* req = new RandomBytesRequest();
   req->error_ = 0;
   req->data_ = new char[size];
@@ -4356,6 +4369,29 @@ JS_LOCAL_METHOD(RandomBytes) {
 }
 JS_METHOD_END
 
+// fills the whole buffer (argument #1) from the thread's pool, many ids are
+// generated with a single call (crypto.randomBytesBatch)
+JS_LOCAL_METHOD(RandomFill) {
+  if (!Buffer::jxHasInstance(GET_ARG(0), com)) {
+    THROW_TYPE_EXCEPTION("Argument #1 must be a Buffer");
+  }
+
+  JS_LOCAL_OBJECT buffer = JS_VALUE_TO_OBJECT(GET_ARG(0));
+  unsigned char* data =
+      reinterpret_cast<unsigned char*>(BUFFER__DATA(buffer));
+  const size_t length = BUFFER__LENGTH(buffer);
+
+  if (!RandomPool::Fill(com->threadId, data, length)) {
+    CheckEntropy();
+    if (RAND_bytes(data, length) != 1) {
+      ThrowCryptoError(ERR_get_error());
+    }
+  }
+
+  RETURN_POINTER(buffer);
+}
+JS_METHOD_END
+
 JS_LOCAL_METHOD(GetSSLCiphers) {
   SSL_CTX* ctx = SSL_CTX_new(TLSv1_server_method());
   if (ctx == NULL) {
@@ -4452,6 +4488,7 @@ DECLARE_CLASS_INITIALIZER(InitCrypto) {
   JS_METHOD_SET(target, "PBKDF2", PBKDF2);
   JS_METHOD_SET(target, "randomBytes", RandomBytes<false>);
   JS_METHOD_SET(target, "pseudoRandomBytes", RandomBytes<true>);
+  JS_METHOD_SET(target, "randomFill", RandomFill);
   JS_METHOD_SET(target, "getSSLCiphers", GetSSLCiphers);
   JS_METHOD_SET(target, "getCiphers", GetCiphers);
   JS_METHOD_SET(target, "getHashes", GetHashes);
@@ -4460,6 +4497,8 @@ DECLARE_CLASS_INITIALIZER(InitCrypto) {
   JS_METHOD_SET(target, "privateDecrypt", PublicKeyCipher::PrivateDecrypt);
 
   JS_NAME_SET(target, JS_STRING_ID("SSL3_ENABLE"), STD_TO_BOOLEAN(SSL3_ENABLE));
+  JS_NAME_SET(target, JS_STRING_ID("RANDOM_POOL_SMALL_MAX"),
+              STD_TO_INTEGER(RANDOM_POOL_SMALL_MAX));
 }
 
 }  // namespace crypto
@@ -338,6 +338,8 @@ class Connection : ObjectWrap {
   END_INIT_NAMED_MEMBERS(Connection)
 };
 
+// waits until OpenSSL's PRNG is seeded
+void CheckEntropy();
 bool EntropySource(unsigned char* buffer, size_t length);
 DECLARE_CLASS_INITIALIZER(InitCrypto);
 
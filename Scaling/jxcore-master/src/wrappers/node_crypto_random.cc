@@ -0,0 +1,177 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "node_crypto_random.h"
+#include "node_crypto.h"
+#include "jx/commons.h"
+#include <string.h>
+#include <errno.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#define RANDOM_KEY_WORDS 8
+#define RANDOM_KEY_SIZE (RANDOM_KEY_WORDS * 4)
+#define RANDOM_BUFFER_SIZE (RANDOM_POOL_BLOCKS * 64)
+
+namespace node {
+namespace crypto {
+
+struct RandomState {
+  uint32_t key_[RANDOM_KEY_WORDS];
+  // keystream after the next key, served from the end
+  unsigned char buffer_[RANDOM_BUFFER_SIZE];
+  size_t left_;
+  size_t generated_;  // bytes served since the last seed
+  unsigned fork_generation_;
+  bool seeded_;
+};
+
+// thread ids go up to MAX_JX_THREADS
+static RandomState states[MAX_JX_THREADS + 1];
+
+// bumped in the child of a fork, the pools seed again before the next read
+static volatile unsigned fork_generation = 0;
+
+#ifndef _WIN32
+static uv_once_t fork_once = UV_ONCE_INIT;
+
+static void OnFork() { fork_generation++; }
+
+static void InitForkHandler() { pthread_atfork(NULL, NULL, OnFork); }
+#endif
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define QUARTER_ROUND(a, b, c, d) \
+  a += b;                         \
+  d = ROTL32(d ^ a, 16);          \
+  c += d;                         \
+  b = ROTL32(b ^ c, 12);          \
+  a += b;                         \
+  d = ROTL32(d ^ a, 8);           \
+  c += d;                         \
+  b = ROTL32(b ^ c, 7)
+
+// one ChaCha20 block of the input state, little endian
+static void ChaCha20Block(const uint32_t input[16], unsigned char *out) {
+  uint32_t x[16];
+  memcpy(x, input, sizeof(x));
+
+  for (int i = 0; i < 10; i++) {
+    QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+    QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+    QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+    QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+    QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+    QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+    QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+    QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+  }
+
+  for (int i = 0; i < 16; i++) {
+    const uint32_t v = x[i] + input[i];
+    out[i * 4] = (unsigned char)v;
+    out[i * 4 + 1] = (unsigned char)(v >> 8);
+    out[i * 4 + 2] = (unsigned char)(v >> 16);
+    out[i * 4 + 3] = (unsigned char)(v >> 24);
+  }
+}
+
+static bool ReadSeed(unsigned char *seed, const size_t length) {
+#if defined(__linux__) && defined(SYS_getrandom)
+  size_t done = 0;
+  while (done < length) {
+    long r = syscall(SYS_getrandom, seed + done, length - done, 0);
+    if (r < 0) {
+      if (errno == EINTR) continue;
+      break;  // ENOSYS, older kernel
+    }
+    done += r;
+  }
+  if (done == length) return true;
+#endif
+
+  CheckEntropy();
+  return RAND_bytes(seed, length) == 1;
+}
+
+// the new seed is mixed into the key, a weak seed doesn't throw away the
+// entropy of the current one
+static bool Seed(RandomState *state) {
+  unsigned char seed[RANDOM_KEY_SIZE];
+  if (!ReadSeed(seed, sizeof(seed))) return false;
+
+  for (int i = 0; i < RANDOM_KEY_WORDS; i++) {
+    state->key_[i] ^= (uint32_t)seed[i * 4] |
+                      ((uint32_t)seed[i * 4 + 1] << 8) |
+                      ((uint32_t)seed[i * 4 + 2] << 16) |
+                      ((uint32_t)seed[i * 4 + 3] << 24);
+  }
+  memset(seed, 0, sizeof(seed));
+
+  // the buffered bytes came from the old key (or the parent's)
+  memset(state->buffer_, 0, sizeof(state->buffer_));
+  state->left_ = 0;
+  state->generated_ = 0;
+  state->fork_generation_ = fork_generation;
+  state->seeded_ = true;
+  return true;
+}
+
+static void Refill(RandomState *state) {
+  // "expand 32-byte k", the key, then a zero counter and nonce
+  uint32_t input[16] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+  memcpy(input + 4, state->key_, sizeof(state->key_));
+
+  for (int i = 0; i < RANDOM_POOL_BLOCKS; i++) {
+    input[12] = i;
+    ChaCha20Block(input, state->buffer_ + i * 64);
+  }
+  memset(input, 0, sizeof(input));
+
+  // the first bytes are the next key and never leave the state
+  for (int i = 0; i < RANDOM_KEY_WORDS; i++) {
+    const unsigned char *k = state->buffer_ + i * 4;
+    state->key_[i] = (uint32_t)k[0] | ((uint32_t)k[1] << 8) |
+                     ((uint32_t)k[2] << 16) | ((uint32_t)k[3] << 24);
+  }
+  memset(state->buffer_, 0, RANDOM_KEY_SIZE);
+  state->left_ = RANDOM_BUFFER_SIZE - RANDOM_KEY_SIZE;
+}
+
+bool RandomPool::Fill(const int tid, unsigned char *data, size_t length) {
+  if (tid < 0 || tid > MAX_JX_THREADS) return false;
+
+#ifndef _WIN32
+  uv_once(&fork_once, InitForkHandler);
+#endif
+
+  RandomState *state = &states[tid];
+  if (!state->seeded_ || state->fork_generation_ != fork_generation ||
+      state->generated_ >= RANDOM_POOL_RESEED) {
+    if (!Seed(state)) return false;
+  }
+
+  state->generated_ += length;
+  while (length > 0) {
+    if (state->left_ == 0) Refill(state);
+
+    const size_t n = length < state->left_ ? length : state->left_;
+    unsigned char *from = state->buffer_ + RANDOM_BUFFER_SIZE - state->left_;
+    memcpy(data, from, n);
+    memset(from, 0, n);
+
+    state->left_ -= n;
+    data += n;
+    length -= n;
+  }
+
+  return true;
+}
+
+}  // namespace crypto
+}  // namespace node
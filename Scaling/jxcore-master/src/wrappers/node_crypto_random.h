@@ -0,0 +1,35 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_WRAPPERS_NODE_CRYPTO_RANDOM_H_
+#define SRC_WRAPPERS_NODE_CRYPTO_RANDOM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Buffered random bytes for the small randomBytes requests (session ids,
+// uuids, nonces). Every thread (commons::threadId) runs its own ChaCha20
+// keystream and serves the requests from a refill buffer without a lock or
+// a call into OpenSSL. Each refill replaces the key with the first bytes of
+// the new keystream, and the bytes handed out are wiped from the buffer,
+// so the state never reveals output already served. The key is seeded from
+// getrandom() (OpenSSL's PRNG where that isn't available), and seeded
+// again after RANDOM_POOL_RESEED bytes and in a forked child.
+#define RANDOM_POOL_SMALL_MAX 256  // bigger randomBytes requests use OpenSSL
+#define RANDOM_POOL_BLOCKS 12      // ChaCha20 blocks (64 bytes) per refill
+#define RANDOM_POOL_RESEED (1024 * 1024)
+
+namespace node {
+namespace crypto {
+
+class RandomPool {
+ public:
+  // fills data with length bytes of the thread's keystream. tid must be the
+  // caller's thread id. returns false if the thread has no pool or the
+  // seed couldn't be read, the caller falls back to RAND_bytes
+  static bool Fill(const int tid, unsigned char *data, size_t length);
+};
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // SRC_WRAPPERS_NODE_CRYPTO_RANDOM_H_
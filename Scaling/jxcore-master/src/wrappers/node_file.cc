@@ -16,6 +16,11 @@
 #include <io.h>
 #endif
 
+#if defined(__POSIX__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace node {
 
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -908,6 +913,210 @@ JS_METHOD(File, FUTimes) {
 }
 JS_METHOD_END
 
+#if defined(__POSIX__)
+// fs.mmapSync mappings. they are shared by all the threads of the process,
+// the same range of an unchanged file is mapped once and released (munmap)
+// when the last Buffer on it is collected
+struct MappedFile {
+  dev_t dev_;
+  ino_t ino_;
+  off_t offset_;  // page aligned
+  size_t length_;
+  // the file when it was mapped, a modified file gets a new mapping
+  off_t size_;
+  time_t mtime_;
+  char* addr_;
+  int refs_;
+  MappedFile* next_;
+};
+
+static MappedFile* mapped_files = NULL;
+static uv_mutex_t mapped_files_lock;
+static uv_once_t mapped_files_once = UV_ONCE_INIT;
+
+static void InitMappedFiles() { uv_mutex_init(&mapped_files_lock); }
+
+// returns the mapping with a new reference, NULL (errno) if mmap failed
+static MappedFile* GetMapping(const int fd, const struct stat& st,
+                              off_t offset, size_t length) {
+  uv_mutex_lock(&mapped_files_lock);
+  MappedFile* map = mapped_files;
+  while (map != NULL) {
+    if (map->dev_ == st.st_dev && map->ino_ == st.st_ino &&
+        map->offset_ == offset && map->length_ == length &&
+        map->size_ == st.st_size && map->mtime_ == st.st_mtime) {
+      map->refs_++;
+      uv_mutex_unlock(&mapped_files_lock);
+      return map;
+    }
+    map = map->next_;
+  }
+
+  // under the lock, the threads asking for the same file at the same time
+  // don't map it twice
+  void* addr = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, offset);
+  if (addr != MAP_FAILED) {
+    map = new MappedFile();
+    map->dev_ = st.st_dev;
+    map->ino_ = st.st_ino;
+    map->offset_ = offset;
+    map->length_ = length;
+    map->size_ = st.st_size;
+    map->mtime_ = st.st_mtime;
+    map->addr_ = static_cast<char*>(addr);
+    map->refs_ = 1;
+    map->next_ = mapped_files;
+    mapped_files = map;
+  }
+  uv_mutex_unlock(&mapped_files_lock);
+  return map;
+}
+
+// free callback of the Buffers, called by the thread collecting the Buffer
+static void ReleaseMapping(char* data, void* hint) {
+  MappedFile* map = static_cast<MappedFile*>(hint);
+
+  uv_mutex_lock(&mapped_files_lock);
+  if (--map->refs_ > 0) {
+    uv_mutex_unlock(&mapped_files_lock);
+    return;
+  }
+
+  MappedFile** link = &mapped_files;
+  while (*link != map) link = &(*link)->next_;
+  *link = map->next_;
+  uv_mutex_unlock(&mapped_files_lock);
+
+  munmap(map->addr_, map->length_);
+  delete map;
+}
+
+// lib/fs.js maps the advice names to these
+static const int mmap_advice[] = {MADV_NORMAL, MADV_RANDOM, MADV_SEQUENTIAL,
+                                  MADV_WILLNEED};
+#endif
+
+#if defined(__linux__) && defined(POSIX_FADV_SEQUENTIAL)
+#define HAVE_FADVISE 1
+// lib/fs.js (ReadStream) uses the indexes
+static const int fadvise_advice[] = {POSIX_FADV_NORMAL, POSIX_FADV_SEQUENTIAL,
+                                     POSIX_FADV_WILLNEED};
+#endif
+
+/*
+ * Access pattern hint for the kernel, posix_fadvise(2)
+ *
+ * applied = fs.fadvise(fd, offset, length, advice)
+ *
+ * 0 fd        integer. file descriptor
+ * 1 offset    integer. file position
+ * 2 length    integer. 0 up to the end of the file
+ * 3 advice    integer. index of fadvise_advice
+ *
+ * returns false where it isn't supported or it didn't apply (pipes). the
+ * readahead started by WILLNEED doesn't wait for the disk
+ */
+JS_METHOD(File, Fadvise) {
+  if (args.Length() < 4 || !args.IsInteger(0) || !args.IsNumber(1) ||
+      !args.IsNumber(2) || !args.IsInteger(3)) {
+    THROW_TYPE_EXCEPTION(
+        "expects (fd integer, offset integer, length integer, advice "
+        "integer)");
+  }
+
+#ifdef HAVE_FADVISE
+  const int fd = args.GetInt32(0);
+  const int64_t offset = args.GetInteger(1);
+  const int64_t length = args.GetInteger(2);
+  const int advice = args.GetInt32(3);
+
+  if (advice < 0 || advice >= (int)ARRAY_SIZE(fadvise_advice)) {
+    THROW_TYPE_EXCEPTION("Unknown advice");
+  }
+
+  const bool applied = offset >= 0 && length >= 0 &&
+                       posix_fadvise(fd, offset, length,
+                                     fadvise_advice[advice]) == 0;
+  RETURN_PARAM(STD_TO_BOOLEAN(applied));
+#else
+  RETURN_PARAM(STD_TO_BOOLEAN(false));
+#endif
+}
+JS_METHOD_END
+
+/*
+ * Read only, shared mapping of a file (fs.mmapSync)
+ *
+ * buffer = fs.mmap(fd, offset, length, advice)
+ *
+ * 0 fd        integer. file descriptor, may be closed after the call
+ * 1 offset    integer. file position of the first byte
+ * 2 length    integer. -1 up to the end of the file
+ * 3 advice    integer. index of mmap_advice
+ *
+ * returns null for an empty range
+ */
+JS_METHOD(File, Mmap) {
+  if (args.Length() < 4 || !args.IsInteger(0) || !args.IsNumber(1) ||
+      !args.IsNumber(2) || !args.IsInteger(3)) {
+    THROW_TYPE_EXCEPTION(
+        "expects (fd integer, offset integer, length integer, advice "
+        "integer)");
+  }
+
+#if defined(__POSIX__)
+  const int fd = args.GetInt32(0);
+  const int64_t offset = args.GetInteger(1);
+  int64_t length = args.GetInteger(2);
+  const int advice = args.GetInt32(3);
+
+  if (advice < 0 || advice >= (int)ARRAY_SIZE(mmap_advice)) {
+    THROW_TYPE_EXCEPTION("Unknown advice");
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    THROW_EXCEPTION_OBJECT(ErrnoException(errno, "fstat"));
+  }
+
+  if (offset < 0 || offset > st.st_size) {
+    THROW_RANGE_EXCEPTION("Offset is out of bounds");
+  }
+  if (length < 0) length = st.st_size - offset;
+  if (offset + length > st.st_size) {
+    THROW_RANGE_EXCEPTION("Length extends beyond the end of the file");
+  }
+  if (length > Buffer::kMaxLength) {
+    THROW_RANGE_EXCEPTION("length > Buffer::kMaxLength");
+  }
+  if (length == 0) {
+    RETURN_PARAM(JS_NULL());
+  }
+
+  // mmap wants a page aligned offset
+  const int64_t page = sysconf(_SC_PAGESIZE);
+  const off_t map_offset = offset - offset % page;
+  const size_t map_length = static_cast<size_t>(offset - map_offset + length);
+
+  uv_once(&mapped_files_once, InitMappedFiles);
+  MappedFile* map = GetMapping(fd, st, map_offset, map_length);
+  if (map == NULL) {
+    THROW_EXCEPTION_OBJECT(ErrnoException(errno, "mmap"));
+  }
+
+  char* data = map->addr_ + (offset - map_offset);
+  // only a hint, the mapping is usable either way
+  madvise(map->addr_, map_length, mmap_advice[advice]);
+
+  Buffer* buffer = Buffer::New(data, static_cast<size_t>(length),
+                               ReleaseMapping, map, com);
+  RETURN_POINTER(JS_OBJECT_FROM_PERSISTENT(buffer->handle_));
+#else
+  THROW_EXCEPTION("fs.mmapSync is not supported on this platform");
+#endif
+}
+JS_METHOD_END
+
 }  // end namespace node
 
 NODE_MODULE(node_fs, node::File::Initialize)
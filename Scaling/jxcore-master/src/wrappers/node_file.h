@@ -34,6 +34,8 @@ class File {
   static DEFINE_JS_METHOD(FChown);
   static DEFINE_JS_METHOD(UTimes);
   static DEFINE_JS_METHOD(FUTimes);
+  static DEFINE_JS_METHOD(Mmap);
+  static DEFINE_JS_METHOD(Fadvise);
 
   INIT_CLASS_MEMBERS() {
     JS_LOCAL_FUNCTION_TEMPLATE stat_templ = JS_NEW_EMPTY_FUNCTION_TEMPLATE();
@@ -71,6 +73,9 @@ class File {
     SET_CLASS_METHOD("utimes", UTimes, 4);
     SET_CLASS_METHOD("futimes", FUTimes, 4);
 
+    SET_CLASS_METHOD("mmap", Mmap, 4);
+    SET_CLASS_METHOD("fadvise", Fadvise, 4);
+
     StatWatcher::Initialize(constructor);
   }
   END_INIT_MEMBERS
@@ -0,0 +1,340 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "querystring_wrap.h"
+#include "node_buffer.h"
+#include "jx/commons.h"
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace node {
+
+static inline int HexValue(const unsigned char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// the state machine of QueryString.unescapeBuffer (lib/querystring.js)
+// clean() is false if there was a malformed % escape. In that case
+// decodeURIComponent would have thrown
+class Unescaper {
+  enum State { STATE_CHAR, STATE_HEX0, STATE_HEX1 };
+
+  std::string *out_;
+  State state_;
+  int high_;
+  unsigned char hex_char_;
+  bool decode_spaces_;
+  bool clean_;
+
+ public:
+  Unescaper(std::string *out, const bool decode_spaces)
+      : out_(out),
+        state_(STATE_CHAR),
+        high_(0),
+        hex_char_(0),
+        decode_spaces_(decode_spaces),
+        clean_(true) {}
+
+  inline bool clean() const { return clean_; }
+
+  inline void Feed(const unsigned char c) {
+    int value;
+    switch (state_) {
+      case STATE_CHAR:
+        if (c == '%') {
+          state_ = STATE_HEX0;
+        } else if (c == '+' && decode_spaces_) {
+          *out_ += ' ';
+        } else {
+          *out_ += (char)c;
+        }
+        break;
+
+      case STATE_HEX0:
+        value = HexValue(c);
+        if (value < 0) {
+          *out_ += '%';
+          *out_ += (char)c;
+          state_ = STATE_CHAR;
+          clean_ = false;
+          break;
+        }
+        hex_char_ = c;
+        high_ = value;
+        state_ = STATE_HEX1;
+        break;
+
+      case STATE_HEX1:
+        state_ = STATE_CHAR;
+        value = HexValue(c);
+        if (value < 0) {
+          *out_ += '%';
+          *out_ += (char)hex_char_;
+          *out_ += (char)c;
+          clean_ = false;
+          break;
+        }
+        *out_ += (char)(high_ * 16 + value);
+        break;
+    }
+  }
+
+  // querystring.parse replaces '+' with '%20' before unescaping
+  inline void FeedQuery(const unsigned char c) {
+    if (c == '+') {
+      Feed('%');
+      Feed('2');
+      Feed('0');
+    } else {
+      Feed(c);
+    }
+  }
+
+  inline void End() {
+    if (state_ == STATE_HEX0) {
+      *out_ += '%';
+      clean_ = false;
+    } else if (state_ == STATE_HEX1) {
+      *out_ += '%';
+      *out_ += (char)hex_char_;
+      clean_ = false;
+    }
+    state_ = STATE_CHAR;
+  }
+};
+
+// returns false if str is not valid UTF-8 (what decodeURIComponent rejects;
+// overlong forms, surrogates and the code points above U+10FFFF).
+// If out is given, it receives a copy of str where the invalid sequences are
+// replaced with U+FFFD (maximal subparts). Doing it here keeps the grouping
+// of the keys in line with the strings the engine creates
+static bool CheckUTF8(const std::string &str, std::string *out) {
+  const unsigned char *s = (const unsigned char *)str.c_str();
+  const size_t length = str.length();
+  bool valid = true;
+
+  for (size_t i = 0; i < length;) {
+    const unsigned char c = s[i];
+    if (c < 0x80) {
+      if (out != NULL) *out += (char)c;
+      i++;
+      continue;
+    }
+
+    size_t extra = 0;
+    unsigned char low = 0x80, high = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+      extra = 1;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+      extra = 2;
+      if (c == 0xE0) low = 0xA0;
+      if (c == 0xED) high = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+      extra = 3;
+      if (c == 0xF0) low = 0x90;
+      if (c == 0xF4) high = 0x8F;
+    }
+
+    size_t j = 1;
+    if (extra > 0) {
+      for (; j <= extra && i + j < length; j++) {
+        if (s[i + j] < low || s[i + j] > high) break;
+        low = 0x80;
+        high = 0xBF;
+      }
+    }
+
+    if (extra > 0 && j > extra) {
+      if (out != NULL) out->append((const char *)s + i, extra + 1);
+      i += extra + 1;
+      continue;
+    }
+
+    valid = false;
+    if (out == NULL) return false;
+    out->append("\xEF\xBF\xBD");
+    i += j;
+  }
+
+  return valid;
+}
+
+// expects the output of Unescaper
+static inline void FixUTF8(std::string *str) {
+  if (CheckUTF8(*str, NULL)) return;
+
+  std::string fixed;
+  fixed.reserve(str->length() + 8);
+  CheckUTF8(*str, &fixed);
+  str->swap(fixed);
+}
+
+static inline const char *FindToken(const char *str, const size_t length,
+                                    const char *token,
+                                    const size_t token_length) {
+  if (token_length == 1) return (const char *)memchr(str, token[0], length);
+
+  if (token_length > length) return NULL;
+  const char *last = str + (length - token_length);
+  for (const char *pos = str; pos <= last; pos++) {
+    if (*pos == token[0] && memcmp(pos, token, token_length) == 0) return pos;
+  }
+  return NULL;
+}
+
+struct QueryEntry {
+  std::string key_;
+  std::vector<std::string> values_;
+};
+
+static inline void UnescapeQuery(const char *str, const size_t length,
+                                 std::string *out) {
+  Unescaper unescaper(out, true);
+  for (size_t i = 0; i < length; i++) unescaper.FeedQuery(str[i]);
+  unescaper.End();
+}
+
+// arg 0 is either a string or a Buffer
+#define GET_INPUT_ARG(data, length)                            \
+  jxcore::JXString str_input;                                  \
+  const char *data;                                            \
+  size_t length;                                               \
+  if (args.IsString(0)) {                                      \
+    length = args.GetString(0, &str_input);                    \
+    data = *str_input;                                         \
+  } else if (Buffer::jxHasInstance(GET_ARG(0), com)) {         \
+    JS_LOCAL_OBJECT buffer = JS_VALUE_TO_OBJECT(GET_ARG(0));   \
+    data = BUFFER__DATA(buffer);                               \
+    length = BUFFER__LENGTH(buffer);                           \
+  } else {                                                     \
+    THROW_TYPE_EXCEPTION("expects a string or Buffer");        \
+  }
+
+JS_METHOD(QueryStringWrap, Parse) {
+  GET_INPUT_ARG(data, length);
+
+  jxcore::JXString str_sep, str_eq;
+  const char *sep = "&", *eq = "=";
+  size_t sep_length = 1, eq_length = 1;
+  if (args.IsString(1) && args.GetString(1, &str_sep) > 0) {
+    sep = *str_sep;
+    sep_length = str_sep.Utf8Length();
+  }
+  if (args.IsString(2) && args.GetString(2, &str_eq) > 0) {
+    eq = *str_eq;
+    eq_length = str_eq.Utf8Length();
+  }
+
+  // 0 or less means no limit
+  int64_t max_keys = 1000;
+  if (args.IsNumber(3)) max_keys = args.GetInteger(3);
+
+  JS_LOCAL_OBJECT obj = JS_NEW_EMPTY_OBJECT();
+  if (length == 0) RETURN_PARAM(obj);
+
+  // keys in the order they first appear, the values are grouped under them
+  std::vector<QueryEntry> entries;
+  std::map<std::string, size_t> index;
+  std::string key, value;
+
+  size_t pos = 0;
+  int64_t count = 0;
+  while (max_keys <= 0 || count < max_keys) {
+    const char *piece = data + pos;
+    const char *piece_end = FindToken(piece, length - pos, sep, sep_length);
+    const size_t piece_length =
+        piece_end == NULL ? length - pos : piece_end - piece;
+
+    const char *split = FindToken(piece, piece_length, eq, eq_length);
+    key.clear();
+    value.clear();
+    if (split == NULL) {
+      UnescapeQuery(piece, piece_length, &key);
+    } else {
+      UnescapeQuery(piece, split - piece, &key);
+      const size_t value_start = (split - piece) + eq_length;
+      UnescapeQuery(split + eq_length, piece_length - value_start, &value);
+    }
+    FixUTF8(&key);
+    FixUTF8(&value);
+
+    std::map<std::string, size_t>::iterator it = index.find(key);
+    if (it == index.end()) {
+      index[key] = entries.size();
+      entries.push_back(QueryEntry());
+      entries.back().key_ = key;
+      entries.back().values_.push_back(value);
+    } else {
+      entries[it->second].values_.push_back(value);
+    }
+
+    count++;
+    if (piece_end == NULL) break;
+    pos += piece_length + sep_length;
+  }
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    const QueryEntry &entry = entries[i];
+    JS_LOCAL_STRING name =
+        UTF8_TO_STRING_WITH_LENGTH(entry.key_.c_str(), entry.key_.length());
+
+    const size_t values = entry.values_.size();
+    if (values == 1) {
+      JS_LOCAL_STRING str = UTF8_TO_STRING_WITH_LENGTH(
+          entry.values_[0].c_str(), entry.values_[0].length());
+      JS_NAME_SET(obj, name, str);
+      continue;
+    }
+
+    JS_LOCAL_ARRAY arr = JS_NEW_ARRAY_WITH_COUNT(values);
+    for (size_t j = 0; j < values; j++) {
+      JS_LOCAL_STRING str = UTF8_TO_STRING_WITH_LENGTH(
+          entry.values_[j].c_str(), entry.values_[j].length());
+      JS_INDEX_SET(arr, j, str);
+    }
+    JS_NAME_SET(obj, name, arr);
+  }
+
+  RETURN_PARAM(obj);
+}
+JS_METHOD_END
+
+// decodeURIComponent(str) or unescapeBuffer(str, decodeSpaces).toString()
+// when decodeURIComponent would throw
+JS_METHOD(QueryStringWrap, Unescape) {
+  GET_INPUT_ARG(data, length);
+
+  const bool decode_spaces = args.Length() > 1 && args.GetBoolean(1);
+
+  std::string out;
+  out.reserve(length);
+
+  bool has_plus = false;
+  Unescaper unescaper(&out, false);
+  for (size_t i = 0; i < length; i++) {
+    if (data[i] == '+') has_plus = true;
+    unescaper.Feed(data[i]);
+  }
+  unescaper.End();
+
+  // the fallback differs only by the '+' characters
+  if (decode_spaces && has_plus &&
+      !(unescaper.clean() && CheckUTF8(out, NULL))) {
+    out.clear();
+    Unescaper fallback(&out, true);
+    for (size_t i = 0; i < length; i++) fallback.Feed(data[i]);
+    fallback.End();
+  }
+  FixUTF8(&out);
+
+  RETURN_PARAM(UTF8_TO_STRING_WITH_LENGTH(out.c_str(), out.length()));
+}
+JS_METHOD_END
+
+}  // namespace node
+
+NODE_MODULE(node_querystring_wrap, node::QueryStringWrap::Initialize)
@@ -0,0 +1,29 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_WRAPPERS_QUERYSTRING_WRAP_H_
+#define SRC_WRAPPERS_QUERYSTRING_WRAP_H_
+
+#include "node.h"
+
+namespace node {
+
+// native helpers for lib/querystring.js. Both methods accept a string or a
+// Buffer and follow the results of the JS implementation (decodeURIComponent
+// and the unescapeBuffer fallback for the malformed input)
+class QueryStringWrap {
+  // parse(qs, sep, eq, maxKeys)
+  static DEFINE_JS_METHOD(Parse);
+
+  // unescape(str, decodeSpaces)
+  static DEFINE_JS_METHOD(Unescape);
+
+  INIT_CLASS_MEMBERS() {
+    SET_CLASS_METHOD("parse", Parse, 4);
+    SET_CLASS_METHOD("unescape", Unescape, 2);
+  }
+  END_INIT_MEMBERS
+};
+
+}  // namespace node
+
+#endif  // SRC_WRAPPERS_QUERYSTRING_WRAP_H_
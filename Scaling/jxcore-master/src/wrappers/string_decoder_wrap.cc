@@ -0,0 +1,190 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "string_decoder_wrap.h"
+#include "node_buffer.h"
+#include "string_bytes.h"
+#include "jx/commons.h"
+#include <stdint.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace node {
+
+// the held bytes followed by the new Buffer
+struct DecoderStream {
+  const unsigned char *held_;
+  size_t held_length_;
+  const unsigned char *data_;
+  size_t length_;
+
+  inline size_t size() const { return held_length_ + length_; }
+
+  inline unsigned char operator[](const size_t i) const {
+    return i < held_length_ ? held_[i] : data_[i - held_length_];
+  }
+};
+
+// the JS version (detectIncompleteChar) announced an incomplete character
+// by the last 3 bytes. A complete CESU-8 lead surrogate (ED A0-AF 80-BF) at
+// the end waits for its trail surrogate as well
+static size_t Utf8Cut(const DecoderStream &stream) {
+  const size_t length = stream.size();
+
+  size_t i = length >= 3 ? 3 : length;
+  for (; i > 0; i--) {
+    const unsigned char c = stream[length - i];
+    if (i == 1 && c >> 5 == 0x06) break;      // 110XXXXX
+    if (i <= 2 && c >> 4 == 0x0E) break;      // 1110XXXX
+    if (i <= 3 && c >> 3 == 0x1E) break;      // 11110XXX
+  }
+
+  size_t cut = length - i;
+  if (cut >= 3 && stream[cut - 3] == 0xED && stream[cut - 2] >= 0xA0 &&
+      stream[cut - 2] <= 0xAF && stream[cut - 1] >= 0x80 &&
+      stream[cut - 1] <= 0xBF) {
+    cut -= 3;
+  }
+  return cut;
+}
+
+// whole code units, a lead surrogate (D800-DBFF) waits for the trail one
+static size_t Ucs2Cut(const DecoderStream &stream) {
+  size_t cut = stream.size() & ~(size_t)1;
+  if (cut >= 2 && stream[cut - 1] >= 0xD8 && stream[cut - 1] <= 0xDB) cut -= 2;
+  return cut;
+}
+
+// base64 encodes 3 bytes at a time without padding
+static inline size_t Base64Cut(const DecoderStream &stream) {
+  return stream.size() - stream.size() % 3;
+}
+
+static inline bool IsAscii(const char *data, const size_t length) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 16 <= length; i += 16) {
+    const __m128i chunk = _mm_loadu_si128((const __m128i *)(data + i));
+    if (_mm_movemask_epi8(chunk) != 0) return false;
+  }
+#else
+  const uintptr_t mask = ~(uintptr_t)0 / 0xFF * 0x80;
+  for (; i + sizeof(uintptr_t) <= length; i += sizeof(uintptr_t)) {
+    uintptr_t word;
+    memcpy(&word, data + i, sizeof(uintptr_t));
+    if (word & mask) return false;
+  }
+#endif
+  for (; i < length; i++) {
+    if (data[i] & 0x80) return false;
+  }
+  return true;
+}
+
+static JS_LOCAL_VALUE DecodeChunk(const char *data, const size_t length,
+                                  const int encoding) {
+  JS_ENTER_SCOPE_COM();
+  JS_DEFINE_STATE_MARKER(com);
+
+  if (length == 0) return JS_LEAVE_SCOPE(JS_NEW_EMPTY_STRING());
+
+  // no need to decode
+  if (encoding == UTF8 && IsAscii(data, length))
+    return JS_LEAVE_SCOPE(STD_TO_STRING_WITH_LENGTH(data, length));
+
+  return JS_LEAVE_SCOPE(
+      StringBytes::Encode(data, length, (enum encoding)encoding));
+}
+
+// arg 0 is the state Buffer
+#define GET_STATE_ARG(state)                                           \
+  if (!Buffer::jxHasInstance(GET_ARG(0), com)) {                       \
+    THROW_TYPE_EXCEPTION("expects a state Buffer");                    \
+  }                                                                    \
+  JS_LOCAL_OBJECT state_buffer = JS_VALUE_TO_OBJECT(GET_ARG(0));       \
+  if (BUFFER__LENGTH(state_buffer) < DECODER_STATE_SIZE) {             \
+    THROW_TYPE_EXCEPTION("state Buffer is too small");                 \
+  }                                                                    \
+  unsigned char *state = (unsigned char *)BUFFER__DATA(state_buffer)
+
+JS_METHOD(StringDecoderWrap, Init) {
+  GET_STATE_ARG(state);
+
+  enum encoding encoding = ParseEncoding(GET_ARG(1), BINARY);
+  if (encoding != UTF8 && encoding != UCS2 && encoding != BASE64) {
+    THROW_TYPE_EXCEPTION("expects utf8, ucs2 or base64 encoding");
+  }
+
+  memset(state, 0, DECODER_STATE_SIZE);
+  state[DECODER_ENCODING] = (unsigned char)encoding;
+}
+JS_METHOD_END
+
+JS_METHOD(StringDecoderWrap, Write) {
+  GET_STATE_ARG(state);
+
+  if (!Buffer::jxHasInstance(GET_ARG(1), com)) {
+    THROW_TYPE_EXCEPTION("expects a Buffer");
+  }
+  JS_LOCAL_OBJECT buffer = JS_VALUE_TO_OBJECT(GET_ARG(1));
+
+  const int encoding = state[DECODER_ENCODING];
+  DecoderStream stream;
+  stream.held_ = state + DECODER_BYTES;
+  stream.held_length_ = state[DECODER_COUNT];
+  stream.data_ = (const unsigned char *)BUFFER__DATA(buffer);
+  stream.length_ = BUFFER__LENGTH(buffer);
+
+  size_t cut;
+  if (encoding == UTF8) {
+    cut = Utf8Cut(stream);
+  } else if (encoding == UCS2) {
+    cut = Ucs2Cut(stream);
+  } else {
+    cut = Base64Cut(stream);
+  }
+
+  const char *data = (const char *)stream.data_;
+  const size_t held = stream.held_length_;
+  char *joined = NULL;
+  if (held > 0 && cut > 0) {
+    // the complete bytes have to be contiguous
+    if (cut <= held) {
+      data = (const char *)stream.held_;
+    } else {
+      joined = new char[cut];
+      memcpy(joined, stream.held_, held);
+      memcpy(joined + held, stream.data_, cut - held);
+      data = joined;
+    }
+  }
+
+  JS_LOCAL_VALUE str = DecodeChunk(data, cut, encoding);
+  if (joined != NULL) delete[] joined;
+
+  unsigned char rest[DECODER_MAX_BYTES];
+  const size_t rest_length = stream.size() - cut;
+  for (size_t i = 0; i < rest_length; i++) rest[i] = stream[cut + i];
+  memcpy(state + DECODER_BYTES, rest, rest_length);
+  state[DECODER_COUNT] = (unsigned char)rest_length;
+
+  RETURN_PARAM(str);
+}
+JS_METHOD_END
+
+JS_METHOD(StringDecoderWrap, End) {
+  GET_STATE_ARG(state);
+
+  const size_t held = state[DECODER_COUNT];
+  const int encoding = state[DECODER_ENCODING];
+  state[DECODER_COUNT] = 0;
+
+  RETURN_PARAM(
+      DecodeChunk((const char *)state + DECODER_BYTES, held, encoding));
+}
+JS_METHOD_END
+
+}  // namespace node
+
+NODE_MODULE(node_string_decoder_wrap, node::StringDecoderWrap::Initialize)
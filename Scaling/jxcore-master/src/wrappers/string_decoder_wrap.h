@@ -0,0 +1,43 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_WRAPPERS_STRING_DECODER_WRAP_H_
+#define SRC_WRAPPERS_STRING_DECODER_WRAP_H_
+
+#include "node.h"
+
+namespace node {
+
+// layout of the state Buffer a StringDecoder (lib/string_decoder.js) keeps.
+// The bytes of the incomplete character (a CESU-8 lead surrogate and the
+// start of the next character at most) are carried to the next write
+enum StringDecoderState {
+  DECODER_BYTES = 0,
+  DECODER_MAX_BYTES = 6,
+  DECODER_COUNT = DECODER_MAX_BYTES,
+  DECODER_ENCODING,
+  DECODER_STATE_SIZE
+};
+
+// streaming UTF-8, UCS-2 and base64 decoding. The concatenated results are
+// the same as decoding the whole stream at once
+class StringDecoderWrap {
+  // init(state, encoding)
+  static DEFINE_JS_METHOD(Init);
+
+  // write(state, buffer)
+  static DEFINE_JS_METHOD(Write);
+
+  // end(state)
+  static DEFINE_JS_METHOD(End);
+
+  INIT_CLASS_MEMBERS() {
+    SET_CLASS_METHOD("init", Init, 2);
+    SET_CLASS_METHOD("write", Write, 2);
+    SET_CLASS_METHOD("end", End, 1);
+  }
+  END_INIT_MEMBERS
+};
+
+}  // namespace node
+
+#endif  // SRC_WRAPPERS_STRING_DECODER_WRAP_H_
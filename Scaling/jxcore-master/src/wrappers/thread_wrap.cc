@@ -3,6 +3,7 @@
 #include "thread_wrap.h"
 #include "jx/job_store.h"
 #include "jx/job.h"
+#include "jx/channel_store.h"
 #include "jx/memory_store.h"
 #include "jx/extend.h"
 
@@ -118,6 +119,12 @@ JS_METHOD(ThreadWrap, AddTask) {
   }
 
   bool skip_thread_creation = args.IsBoolean(5) ? args.GetBoolean(5) : false;
+  int priority = args.IsInteger(6) ? args.GetInteger(6) : JOB_PRIORITY_NORMAL;
+  int timeout = args.IsInteger(7) ? args.GetInteger(7) : 0;  // milliseconds
+
+  if (priority < JOB_PRIORITY_HIGH || priority > JOB_PRIORITY_LOW) {
+    THROW_RANGE_EXCEPTION("Task priority is out of range");
+  }
 
   int taskId = args.GetInteger(0);
   int mlen = -1, plen = -1;
@@ -153,6 +160,9 @@ JS_METHOD(ThreadWrap, AddTask) {
                                      cbId, notRemember);
 
     if (cbId != -2) {
+      j->priority = priority;
+      if (timeout > 0) j->deadline = uv_hrtime() + (uint64_t)timeout * 1000000;
+
       const int m = nth % 2;  // JBEND
       nth %= 10000;
       nth++;
@@ -178,7 +188,7 @@ JS_METHOD(ThreadWrap, AddTask) {
 JS_METHOD_END
 
 JS_HANDLE_VALUE ThreadWrap::collectResults(node::commons *com, const int tid,
-                                           bool emit_call) {
+                                           bool emit_call, int *count) {
   JS_ENTER_SCOPE_WITH(com->node_isolate);
   JS_DEFINE_STATE_MARKER(com);
   int i = 0;
@@ -196,6 +206,7 @@ JS_HANDLE_VALUE ThreadWrap::collectResults(node::commons *com, const int tid,
   if (emit_call) setThreadMessage(tid, 0);
   threadUnlock(tid);
 
+  if (count != NULL) *count = i;
   return JS_LEAVE_SCOPE(arr);
 }
 
@@ -289,19 +300,153 @@ void ThreadWrap::EmitOnMessage(const int tid) {
   JS_ENTER_SCOPE();
   JS_HANDLE_OBJECT process_object = com->getProcess();
 
+  const bool channel_ping = jxcore::TakeChannelPing(tid);
+  int count = 0;
   JS_LOCAL_OBJECT vals =
-      JS_VALUE_TO_OBJECT(ThreadWrap::collectResults(com, tid, true));
+      JS_VALUE_TO_OBJECT(ThreadWrap::collectResults(com, tid, true, &count));
+  const bool has_channel = jxcore::HasChannelMessages(tid);
 
+  // a ping for the channel messages alone has nothing for the threadMessage
+  // listeners, even when an earlier channelMessage already drained them
+  if (count > 0 || (!has_channel && !channel_ping)) {
 #ifdef JS_ENGINE_MOZJS
-  __JS_LOCAL_VALUE args[2] = {JS_CORE_REFERENCE(com->pstr_threadMessage),
-                              JS_CORE_REFERENCE(vals)};
+    __JS_LOCAL_VALUE args[2] = {JS_CORE_REFERENCE(com->pstr_threadMessage),
+                                JS_CORE_REFERENCE(vals)};
 #elif defined(JS_ENGINE_V8)
-  // both works for MozJS but above is faster
-  __JS_LOCAL_VALUE args[2] = {JS_PREDEFINED_STRING(threadMessage), vals};
+    // both works for MozJS but above is faster
+    __JS_LOCAL_VALUE args[2] = {JS_PREDEFINED_STRING(threadMessage), vals};
 #endif
 
-  MakeCallback(com, process_object, JS_PREDEFINED_STRING(emit), 2, args);
+    MakeCallback(com, process_object, JS_PREDEFINED_STRING(emit), 2, args);
+  }
+
+  if (has_channel) {
+#ifdef JS_ENGINE_MOZJS
+    __JS_LOCAL_VALUE args[1] = {JS_CORE_REFERENCE(com->pstr_channelMessage)};
+#elif defined(JS_ENGINE_V8)
+    __JS_LOCAL_VALUE args[1] = {JS_PREDEFINED_STRING(channelMessage)};
+#endif
+
+    MakeCallback(com, process_object, JS_PREDEFINED_STRING(emit), 1, args);
+  }
+}
+
+JS_METHOD(ThreadWrap, QueueStats) {
+  CHECK_EMBEDDED_THREADS()
+
+  jxcore::JobQueueStats stats[JOB_PRIORITY_COUNT];
+  jxcore::getJobQueueStats(stats);
+
+  JS_LOCAL_ARRAY arr = JS_NEW_ARRAY_WITH_COUNT(JOB_PRIORITY_COUNT);
+  for (int i = 0; i < JOB_PRIORITY_COUNT; i++) {
+    const jxcore::JobQueueStats *qs = &stats[i];
+    const int64_t dequeued = qs->dispatched + qs->expired;
+
+    JS_LOCAL_OBJECT info = JS_NEW_EMPTY_OBJECT();
+    JS_NAME_SET(info, JS_STRING_ID("queued"), STD_TO_NUMBER(qs->queued));
+    JS_NAME_SET(info, JS_STRING_ID("dispatched"),
+                STD_TO_NUMBER(qs->dispatched));
+    JS_NAME_SET(info, JS_STRING_ID("expired"), STD_TO_NUMBER(qs->expired));
+    // milliseconds
+    JS_NAME_SET(info, JS_STRING_ID("waitAverage"),
+                STD_TO_NUMBER(dequeued > 0 ? qs->wait_total / 1e6 / dequeued
+                                           : 0));
+    JS_NAME_SET(info, JS_STRING_ID("waitMax"),
+                STD_TO_NUMBER(qs->wait_max / 1e6));
+    JS_INDEX_SET(arr, i, info);
+  }
+
+  RETURN_PARAM(arr);
+}
+JS_METHOD_END
+
+JS_METHOD(ThreadWrap, CancelTask) {
+  if (!args.IsInteger(0)) {
+    THROW_EXCEPTION("Missing parameters (cancelTask) expects (int).");
+  }
+
+  jxcore::cancelJob(args.GetInteger(0));
 }
+JS_METHOD_END
+
+JS_METHOD(ThreadWrap, IsTaskCancelled) {
+  if (!args.IsInteger(0)) {
+    THROW_EXCEPTION("Missing parameters (isTaskCancelled) expects (int).");
+  }
+
+  RETURN_PARAM(STD_TO_BOOLEAN(jxcore::isJobCancelled(args.GetInteger(0))));
+}
+JS_METHOD_END
+
+JS_METHOD(ThreadWrap, ReleaseTask) {
+  if (!args.IsInteger(0)) {
+    THROW_EXCEPTION("Missing parameters (releaseTask) expects (int).");
+  }
+
+  jxcore::releaseCancelledJob(args.GetInteger(0));
+}
+JS_METHOD_END
+
+JS_METHOD(ThreadWrap, Subscribe) {
+  if (!args.IsString(0)) {
+    THROW_EXCEPTION("Missing parameters (subscribe) expects (string).");
+  }
+
+  jxcore::JXString jxs;
+  int ln = args.GetString(0, &jxs);
+  std::string topic(*jxs, ln);
+  RETURN_PARAM(STD_TO_BOOLEAN(jxcore::SubscribeChannel(topic, com->threadId)));
+}
+JS_METHOD_END
+
+JS_METHOD(ThreadWrap, Unsubscribe) {
+  if (!args.IsString(0)) {
+    THROW_EXCEPTION("Missing parameters (unsubscribe) expects (string).");
+  }
+
+  jxcore::JXString jxs;
+  int ln = args.GetString(0, &jxs);
+  std::string topic(*jxs, ln);
+  RETURN_PARAM(
+      STD_TO_BOOLEAN(jxcore::UnsubscribeChannel(topic, com->threadId)));
+}
+JS_METHOD_END
+
+JS_METHOD(ThreadWrap, Publish) {
+  if (!args.IsString(0) || !args.IsString(1)) {
+    THROW_EXCEPTION("Missing parameters (publish) expects (string, string).");
+  }
+
+  jxcore::JXString jxs;
+  int ln = args.GetString(0, &jxs);
+  std::string topic(*jxs, ln);
+  jxcore::JXString str;
+  int str_len = args.GetString(1, &str);
+
+  const int count =
+      jxcore::PublishChannel(topic, *str, str_len, com->threadId);
+  RETURN_PARAM(STD_TO_INTEGER(count));
+}
+JS_METHOD_END
+
+// returns [topic, sender threadId, data, topic, ...]
+JS_METHOD(ThreadWrap, PullChannel) {
+  std::vector<jxcore::ChannelMessage *> msgs;
+  jxcore::PullChannelMessages(com->threadId, &msgs);
+
+  JS_LOCAL_ARRAY arr = JS_NEW_ARRAY_WITH_COUNT(msgs.size() * 3);
+  for (size_t i = 0; i < msgs.size(); i++) {
+    const jxcore::ChannelMessage *msg = msgs[i];
+    JS_INDEX_SET(arr, i * 3, STD_TO_STRING(msg->topic_.c_str()));
+    JS_INDEX_SET(arr, i * 3 + 1, STD_TO_INTEGER(msg->sender_ - 1));
+    JS_INDEX_SET(arr, i * 3 + 2,
+                 UTF8_TO_STRING_WITH_LENGTH(msg->data_, msg->length_));
+  }
+  jxcore::ReleaseChannelMessages(&msgs);
+
+  RETURN_PARAM(arr);
+}
+JS_METHOD_END
 
 }  // namespace node
 
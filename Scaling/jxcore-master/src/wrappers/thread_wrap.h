@@ -36,14 +36,31 @@ class ThreadWrap {
 
   static DEFINE_JS_METHOD(CPU);
 
+  static DEFINE_JS_METHOD(QueueStats);
+
+  static DEFINE_JS_METHOD(CancelTask);
+
+  static DEFINE_JS_METHOD(IsTaskCancelled);
+
+  static DEFINE_JS_METHOD(ReleaseTask);
+
+  static DEFINE_JS_METHOD(Subscribe);
+
+  static DEFINE_JS_METHOD(Unsubscribe);
+
+  static DEFINE_JS_METHOD(Publish);
+
+  static DEFINE_JS_METHOD(PullChannel);
+
  public:
+  // count (optional) receives the number of the collected messages
   static JS_HANDLE_VALUE collectResults(node::commons* com, const int tid,
-                                        bool emit_call);
+                                        bool emit_call, int* count = NULL);
 
   static void EmitOnMessage(const int tid);
 
   INIT_CLASS_MEMBERS_NO_COM() {
-    SET_CLASS_METHOD("addTask", AddTask, 6);
+    SET_CLASS_METHOD("addTask", AddTask, 8);
     SET_CLASS_METHOD("resetThread", ResetThread, 1);
     SET_CLASS_METHOD("sendToAll", SendToThreads, 3);
     SET_CLASS_METHOD("getResults", GetResults, 0);
@@ -55,6 +72,14 @@ class ThreadWrap {
     SET_CLASS_METHOD("cpuCount", CpuCount, 0);
     SET_CLASS_METHOD("freeGC", Free, 0);
     SET_CLASS_METHOD("killThread", Kill, 1);
+    SET_CLASS_METHOD("queueStats", QueueStats, 0);
+    SET_CLASS_METHOD("cancelTask", CancelTask, 1);
+    SET_CLASS_METHOD("isTaskCancelled", IsTaskCancelled, 1);
+    SET_CLASS_METHOD("releaseTask", ReleaseTask, 1);
+    SET_CLASS_METHOD("subscribe", Subscribe, 1);
+    SET_CLASS_METHOD("unsubscribe", Unsubscribe, 1);
+    SET_CLASS_METHOD("publish", Publish, 2);
+    SET_CLASS_METHOD("pullChannel", PullChannel, 0);
   }
   END_INIT_MEMBERS
 };
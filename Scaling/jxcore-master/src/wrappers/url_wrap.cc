@@ -0,0 +1,225 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "url_wrap.h"
+#include "jx/commons.h"
+#include <string.h>
+
+namespace node {
+
+// ASCII part of String.prototype.trim
+static inline bool IsTrimSpace(const char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+// the characters Url.prototype.parse would escape or rewrite. Whitespace and
+// the non-ASCII characters (punycode) are in this group too
+static inline bool NeedsRewrite(const unsigned char c) {
+  if (c <= 0x20 || c >= 0x7F) return true;
+  return c == '\\' || c == '\'' || c == '<' || c == '>' || c == '"' ||
+         c == '`';
+}
+
+// nonHostChars of lib/url.js, minus the ones NeedsRewrite rejects
+static inline bool IsNonHostChar(const char c) {
+  return c == '%' || c == '/' || c == '?' || c == ';' || c == '#' ||
+         c == '{' || c == '}' || c == '|' || c == '^' || c == '~';
+}
+
+static inline bool IsProtocolChar(const char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '.' || c == '+' || c == '-';
+}
+
+static inline bool IsHostnameChar(const char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.';
+}
+
+static inline bool IsProtocol(const char *str, const size_t length,
+                              const char *name) {
+  return strlen(name) == length && memcmp(str, name, length) == 0;
+}
+
+// slashedProtocol of lib/url.js. Like the JS, the lookup is case sensitive
+static inline bool IsSlashedProtocol(const char *str, const size_t length) {
+  return IsProtocol(str, length, "http:") ||
+         IsProtocol(str, length, "https:") ||
+         IsProtocol(str, length, "ftp:") ||
+         IsProtocol(str, length, "gopher:") ||
+         IsProtocol(str, length, "file:");
+}
+
+// /^\/\/[^@\/]+@[^@\/]+/
+static inline bool HasAuthPrefix(const char *str, const size_t length) {
+  if (length < 2 || str[0] != '/' || str[1] != '/') return false;
+
+  size_t pos = 2;
+  while (pos < length && str[pos] != '@' && str[pos] != '/') pos++;
+  if (pos == 2 || pos + 1 >= length || str[pos] != '@') return false;
+
+  return str[pos + 1] != '@' && str[pos + 1] != '/';
+}
+
+// 'hostnamePartPattern' for every label and the length limit
+static inline bool IsPlainHostname(const char *str, const size_t length) {
+  if (length > 255) return false;
+
+  size_t label = 0;
+  for (size_t i = 0; i < length; i++) {
+    if (!IsHostnameChar(str[i])) return false;
+    if (str[i] == '.') {
+      label = 0;
+    } else if (++label > 63) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static inline const char *FindAny(const char *str, const char *end,
+                                  const char *chars) {
+  for (; str < end; str++) {
+    if (strchr(chars, *str) != NULL) return str;
+  }
+  return NULL;
+}
+
+// follows Url.prototype.parse step by step. Returns false when the url needs
+// any of the steps the tokenizer doesn't implement
+static bool TokenizeUrl(const char *data, const size_t length,
+                        const bool slashes_denote_host, int64_t *tokens) {
+  for (int i = 0; i < URL_TOKEN_COUNT; i++) tokens[i] = -1;
+  tokens[URL_SLASHES] = 0;
+
+  const char *pos = data;
+  const char *end = data + length;
+  while (pos < end && IsTrimSpace(*pos)) pos++;
+  while (end > pos && IsTrimSpace(*(end - 1))) end--;
+
+  for (const char *c = pos; c < end; c++) {
+    if (NeedsRewrite(*c)) return false;
+  }
+
+  const char *proto = pos;
+  size_t proto_length = 0;
+  while (proto + proto_length < end && IsProtocolChar(proto[proto_length]))
+    proto_length++;
+
+  if (proto_length > 0 && proto + proto_length < end &&
+      proto[proto_length] == ':') {
+    proto_length++;
+    // hostless and unsafe
+    if (proto_length == 11 && strncasecmp(proto, "javascript:", 11) == 0)
+      return false;
+
+    tokens[URL_PROTOCOL_START] = proto - data;
+    tokens[URL_PROTOCOL_END] = proto - data + proto_length;
+    pos += proto_length;
+  } else {
+    proto_length = 0;
+  }
+
+  bool slashes = false;
+  if (slashes_denote_host || proto_length > 0 ||
+      HasAuthPrefix(pos, end - pos)) {
+    slashes = end - pos >= 2 && pos[0] == '/' && pos[1] == '/';
+    if (slashes) {
+      tokens[URL_SLASHES] = 1;
+      pos += 2;
+    }
+  }
+
+  if (slashes ||
+      (proto_length > 0 && !IsSlashedProtocol(proto, proto_length))) {
+    // the last '@' before any of the host ending chars
+    const char *host_end = FindAny(pos, end, "/?#");
+    if (host_end == NULL) host_end = end;
+
+    const char *at_sign = NULL;
+    for (const char *c = host_end; c > pos; c--) {
+      if (*(c - 1) == '@') {
+        at_sign = c - 1;
+        break;
+      }
+    }
+
+    if (at_sign != NULL) {
+      // decodeURIComponent(auth) may rewrite or throw
+      if (memchr(pos, '%', at_sign - pos) != NULL) return false;
+
+      tokens[URL_AUTH_START] = pos - data;
+      tokens[URL_AUTH_END] = at_sign - data;
+      pos = at_sign + 1;
+    }
+
+    host_end = pos;
+    while (host_end < end && !IsNonHostChar(*host_end)) host_end++;
+
+    // portPattern, /:[0-9]*$/
+    const char *hostname_end = host_end;
+    for (const char *c = host_end; c > pos; c--) {
+      if (*(c - 1) == ':') {
+        hostname_end = c - 1;
+        break;
+      }
+      if (*(c - 1) < '0' || *(c - 1) > '9') break;
+    }
+
+    if (hostname_end + 1 < host_end) {
+      tokens[URL_PORT_START] = hostname_end + 1 - data;
+      tokens[URL_PORT_END] = host_end - data;
+    }
+
+    // IPv6 addresses and the names the JS would cut are left to the JS
+    if (!IsPlainHostname(pos, hostname_end - pos)) return false;
+
+    tokens[URL_HOSTNAME_START] = pos - data;
+    tokens[URL_HOSTNAME_END] = hostname_end - data;
+    pos = host_end;
+  }
+
+  const char *hash = (const char *)memchr(pos, '#', end - pos);
+  if (hash != NULL) {
+    tokens[URL_HASH_START] = hash - data;
+    tokens[URL_HASH_END] = end - data;
+    end = hash;
+  }
+
+  const char *search = (const char *)memchr(pos, '?', end - pos);
+  if (search != NULL) {
+    tokens[URL_SEARCH_START] = search - data;
+    tokens[URL_SEARCH_END] = end - data;
+    end = search;
+  }
+
+  tokens[URL_PATHNAME_START] = pos - data;
+  tokens[URL_PATHNAME_END] = end - data;
+
+  return true;
+}
+
+JS_METHOD(UrlWrap, Tokenize) {
+  if (!args.IsString(0)) THROW_TYPE_EXCEPTION("expects a string");
+
+  jxcore::JXString str_url;
+  const size_t length = args.GetString(0, &str_url);
+  const bool slashes_denote_host = args.Length() > 1 && args.GetBoolean(1);
+
+  // the offsets are byte offsets, they only match the string indices for
+  // ASCII (TokenizeUrl rejects the rest)
+  int64_t tokens[URL_TOKEN_COUNT];
+  if (!TokenizeUrl(*str_url, length, slashes_denote_host, tokens)) RETURN();
+
+  JS_LOCAL_ARRAY arr = JS_NEW_ARRAY_WITH_COUNT(URL_TOKEN_COUNT);
+  for (int i = 0; i < URL_TOKEN_COUNT; i++) {
+    JS_INDEX_SET(arr, i, STD_TO_INTEGER(tokens[i]));
+  }
+
+  RETURN_PARAM(arr);
+}
+JS_METHOD_END
+
+}  // namespace node
+
+NODE_MODULE(node_url_wrap, node::UrlWrap::Initialize)
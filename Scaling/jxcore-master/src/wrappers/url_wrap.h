@@ -0,0 +1,44 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_WRAPPERS_URL_WRAP_H_
+#define SRC_WRAPPERS_URL_WRAP_H_
+
+#include "node.h"
+
+namespace node {
+
+// offsets returned by UrlWrap::Tokenize. Every part is a [start, end) pair
+// into the original string, -1 when the part is not there
+enum UrlToken {
+  URL_PROTOCOL_START = 0,
+  URL_PROTOCOL_END,
+  URL_SLASHES,  // 1 or 0
+  URL_AUTH_START,
+  URL_AUTH_END,
+  URL_HOSTNAME_START,
+  URL_HOSTNAME_END,
+  URL_PORT_START,
+  URL_PORT_END,
+  URL_PATHNAME_START,
+  URL_PATHNAME_END,
+  URL_SEARCH_START,
+  URL_SEARCH_END,
+  URL_HASH_START,
+  URL_HASH_END,
+  URL_TOKEN_COUNT
+};
+
+// single pass tokenizer for lib/url.js. It only accepts the urls where
+// Url.prototype.parse would not escape, decode or rewrite any of the parts
+// (printable ASCII, plain host names) and returns undefined for the rest
+class UrlWrap {
+  // tokenize(url, slashesDenoteHost)
+  static DEFINE_JS_METHOD(Tokenize);
+
+  INIT_CLASS_MEMBERS() { SET_CLASS_METHOD("tokenize", Tokenize, 2); }
+  END_INIT_MEMBERS
+};
+
+}  // namespace node
+
+#endif  // SRC_WRAPPERS_URL_WRAP_H_
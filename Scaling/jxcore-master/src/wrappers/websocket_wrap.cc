@@ -0,0 +1,626 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#include "websocket_wrap.h"
+#include "node_buffer.h"
+#include "jx/commons.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace node {
+
+// 2 bytes, the 64 bit extended length and the masking key
+#define WS_MAX_HEADER 14
+#define WS_MAX_CONTROL_PAYLOAD 125
+#define WS_DEFAULT_MAX_MESSAGE (64 * 1024 * 1024)
+
+#define WS_CLOSE_PROTOCOL_ERROR 1002
+#define WS_CLOSE_INVALID_DATA 1007
+#define WS_CLOSE_TOO_BIG 1009
+
+struct WebSocketEvent {
+  int opcode_;
+  // the payload in the chunk, when data_ is NULL
+  size_t start_;
+  size_t end_;
+  // otherwise the payload was reassembled or copied (owned_, malloc'ed)
+  char *data_;
+  size_t length_;
+  bool owned_;
+  const char *reason_;
+};
+
+class FrameCodec : public ObjectWrap {
+  friend class WebSocketWrap;
+
+ public:
+  FrameCodec(const bool is_server, const size_t max_message)
+      : ObjectWrap(),
+        header_length_(0),
+        in_payload_(false),
+        message_opcode_(0),
+        message_(NULL),
+        message_length_(0),
+        message_capacity_(0),
+        control_length_(0),
+        is_server_(is_server),
+        max_message_(max_message),
+        failed_(false),
+        error_code_(0),
+        error_reason_(NULL) {}
+
+  ~FrameCodec() { free(message_); }
+
+  void Execute(char *data, size_t pos, const size_t end,
+               std::vector<WebSocketEvent> *events);
+  void Reset();
+
+ private:
+  bool StartFrame(const size_t available, std::vector<WebSocketEvent> *events);
+  void EndFrame(char *data, const size_t start, const size_t end,
+                std::vector<WebSocketEvent> *events);
+  bool ReserveMessage(const uint64_t length);
+  void Fail(const int code, const char *reason,
+            std::vector<WebSocketEvent> *events);
+
+  unsigned char header_[WS_MAX_HEADER];
+  size_t header_length_;
+
+  // the frame being received
+  bool in_payload_;
+  bool in_place_;  // its whole payload is in the chunk
+  bool fin_;
+  bool masked_;
+  int opcode_;  // WS_COMPRESSED included
+  uint64_t remaining_;
+  unsigned char mask_[4];
+  unsigned mask_offset_;
+
+  // the fragmented message (or the payload split by the chunks)
+  int message_opcode_;  // 0 when there is none
+  char *message_;
+  size_t message_length_;
+  size_t message_capacity_;
+
+  char control_[WS_MAX_CONTROL_PAYLOAD];
+  size_t control_length_;
+
+  bool is_server_;
+  size_t max_message_;
+  bool failed_;
+  int error_code_;
+  const char *error_reason_;
+};
+
+// XORs the payload with the masking key, offset is the position of data in
+// the 4 byte key cycle
+static void Unmask(char *data, size_t length, const unsigned char *mask,
+                   const unsigned offset) {
+  unsigned char key[4];
+  for (unsigned i = 0; i < 4; i++) key[i] = mask[(offset + i) & 3];
+
+  // every block is a multiple of 4 bytes, the key cycle is kept
+  uint32_t key32;
+  memcpy(&key32, key, 4);
+#if defined(__SSE2__)
+  const __m128i key128 = _mm_set1_epi32((int)key32);
+  for (; length >= 16; data += 16, length -= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)data);
+    _mm_storeu_si128((__m128i *)data, _mm_xor_si128(chunk, key128));
+  }
+#endif
+  const uint64_t key64 = ((uint64_t)key32 << 32) | key32;
+  for (; length >= 8; data += 8, length -= 8) {
+    uint64_t word;
+    memcpy(&word, data, 8);
+    word ^= key64;
+    memcpy(data, &word, 8);
+  }
+  for (size_t i = 0; i < length; i++) data[i] ^= key[i & 3];
+}
+
+// rejects the overlong forms, the surrogates and the code points above
+// U+10FFFF
+static bool IsValidUtf8(const unsigned char *data, const size_t length) {
+  size_t i = 0;
+  while (i < length) {
+#if defined(__SSE2__)
+    while (i + 16 <= length &&
+           _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(data + i))) ==
+               0) {
+      i += 16;
+    }
+#else
+    while (i + 8 <= length) {
+      uint64_t word;
+      memcpy(&word, data + i, 8);
+      if (word & 0x8080808080808080ULL) break;
+      i += 8;
+    }
+#endif
+    if (i == length) break;
+
+    const unsigned char c = data[i];
+    if (c < 0x80) {
+      i++;
+      continue;
+    }
+
+    size_t size;
+    unsigned char min_next = 0x80, max_next = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+      size = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+      size = 3;
+      if (c == 0xE0) min_next = 0xA0;
+      if (c == 0xED) max_next = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+      size = 4;
+      if (c == 0xF0) min_next = 0x90;
+      if (c == 0xF4) max_next = 0x8F;
+    } else {
+      return false;
+    }
+
+    if (length - i < size) return false;
+    if (data[i + 1] < min_next || data[i + 1] > max_next) return false;
+    for (size_t k = 2; k < size; k++) {
+      if ((data[i + k] & 0xC0) != 0x80) return false;
+    }
+    i += size;
+  }
+  return true;
+}
+
+static bool IsValidCloseCode(const int code) {
+  if (code >= 3000 && code <= 4999) return true;
+  return (code >= 1000 && code <= 1003) || (code >= 1007 && code <= 1011);
+}
+
+// the header bytes of the frame, 2 until the second byte is known
+static size_t HeaderSize(const unsigned char *header, const size_t received) {
+  if (received < 2) return 2;
+
+  size_t size = 2;
+  const unsigned length = header[1] & 0x7F;
+  if (length == 126) {
+    size += 2;
+  } else if (length == 127) {
+    size += 8;
+  }
+  if (header[1] & 0x80) size += 4;
+  return size;
+}
+
+static size_t BuildHeader(unsigned char *header, const int opcode,
+                          const uint64_t length, const bool fin,
+                          const unsigned char *mask) {
+  header[0] = (fin ? 0x80 : 0) | ((opcode & WS_COMPRESSED) ? 0x40 : 0) |
+              (opcode & 0x0F);
+  const unsigned char mask_bit = mask != NULL ? 0x80 : 0;
+
+  size_t size = 2;
+  if (length < 126) {
+    header[1] = mask_bit | (unsigned char)length;
+  } else if (length <= 0xFFFF) {
+    header[1] = mask_bit | 126;
+    header[2] = (unsigned char)(length >> 8);
+    header[3] = (unsigned char)length;
+    size = 4;
+  } else {
+    header[1] = mask_bit | 127;
+    for (int i = 0; i < 8; i++) {
+      header[2 + i] = (unsigned char)(length >> (56 - 8 * i));
+    }
+    size = 10;
+  }
+
+  if (mask != NULL) {
+    memcpy(header + size, mask, 4);
+    size += 4;
+  }
+  return size;
+}
+
+void FrameCodec::Fail(const int code, const char *reason,
+                      std::vector<WebSocketEvent> *events) {
+  failed_ = true;
+  error_code_ = code;
+  error_reason_ = reason;
+
+  WebSocketEvent event = {WS_ERROR, 0, 0, NULL, 0, false, reason};
+  event.start_ = code;
+  events->push_back(event);
+}
+
+bool FrameCodec::ReserveMessage(const uint64_t length) {
+  const size_t needed = message_length_ + (size_t)length;
+  if (needed <= message_capacity_) return true;
+
+  // the fragments of a message don't reallocate it for each one
+  size_t capacity = message_capacity_ * 2;
+  if (capacity > max_message_) capacity = max_message_;
+  if (capacity < needed) capacity = needed;
+
+  char *message = (char *)realloc(message_, capacity);
+  if (message == NULL) return false;
+  message_ = message;
+  message_capacity_ = capacity;
+  return true;
+}
+
+// validates the received header, available is the size of the chunk after it
+bool FrameCodec::StartFrame(const size_t available,
+                            std::vector<WebSocketEvent> *events) {
+  const unsigned char *header = header_;
+  fin_ = (header[0] & 0x80) != 0;
+  const bool rsv1 = (header[0] & 0x40) != 0;
+  opcode_ = header[0] & 0x0F;
+  masked_ = (header[1] & 0x80) != 0;
+
+  uint64_t length = header[1] & 0x7F;
+  size_t offset = 2;
+  if (length == 126) {
+    length = ((uint64_t)header[2] << 8) | header[3];
+    offset = 4;
+  } else if (length == 127) {
+    length = 0;
+    for (int i = 0; i < 8; i++) length = (length << 8) | header[2 + i];
+    offset = 10;
+    if (length >> 63) {
+      Fail(WS_CLOSE_PROTOCOL_ERROR, "invalid payload length", events);
+      return false;
+    }
+  }
+  if (masked_) memcpy(mask_, header + offset, 4);
+
+  if (header[0] & 0x30) {
+    Fail(WS_CLOSE_PROTOCOL_ERROR, "RSV2 and RSV3 must be clear", events);
+    return false;
+  }
+
+  if (masked_ != is_server_) {
+    Fail(WS_CLOSE_PROTOCOL_ERROR,
+         is_server_ ? "client frames must be masked"
+                    : "server frames must not be masked",
+         events);
+    return false;
+  }
+
+  const bool control = opcode_ >= WS_OPCODE_CLOSE;
+  if (control) {
+    if (opcode_ > WS_OPCODE_PONG) {
+      Fail(WS_CLOSE_PROTOCOL_ERROR, "unknown opcode", events);
+      return false;
+    }
+    if (!fin_ || rsv1 || length > WS_MAX_CONTROL_PAYLOAD) {
+      Fail(WS_CLOSE_PROTOCOL_ERROR, "invalid control frame", events);
+      return false;
+    }
+  } else if (opcode_ == WS_OPCODE_CONTINUATION) {
+    // RSV1 belongs to the first frame of the message
+    if (message_opcode_ == 0 || rsv1) {
+      Fail(WS_CLOSE_PROTOCOL_ERROR, "unexpected continuation frame", events);
+      return false;
+    }
+  } else if (opcode_ <= WS_OPCODE_BINARY) {
+    if (message_opcode_ != 0) {
+      Fail(WS_CLOSE_PROTOCOL_ERROR, "fragmented message was interrupted",
+           events);
+      return false;
+    }
+    if (rsv1) opcode_ |= WS_COMPRESSED;
+  } else {
+    Fail(WS_CLOSE_PROTOCOL_ERROR, "unknown opcode", events);
+    return false;
+  }
+
+  if (!control && length > max_message_ - message_length_) {
+    Fail(WS_CLOSE_TOO_BIG, "message is too big", events);
+    return false;
+  }
+
+  // a single frame in the chunk is reported from there, the rest is copied
+  in_place_ = length <= available &&
+              (control || (fin_ && opcode_ != WS_OPCODE_CONTINUATION));
+  if (!in_place_) {
+    if (control) {
+      control_length_ = 0;
+    } else {
+      if (opcode_ != WS_OPCODE_CONTINUATION) message_opcode_ = opcode_;
+      if (!ReserveMessage(length)) {
+        Fail(WS_CLOSE_TOO_BIG, "message is too big", events);
+        return false;
+      }
+    }
+  }
+
+  in_payload_ = true;
+  remaining_ = length;
+  mask_offset_ = 0;
+  return true;
+}
+
+void FrameCodec::EndFrame(char *data, const size_t start, const size_t end,
+                          std::vector<WebSocketEvent> *events) {
+  in_payload_ = false;
+
+  WebSocketEvent event = {opcode_, start, end, NULL, 0, false, NULL};
+  const unsigned char *payload = (const unsigned char *)data + start;
+  size_t length = end - start;
+
+  if (opcode_ >= WS_OPCODE_CLOSE) {
+    if (!in_place_) {
+      payload = (const unsigned char *)control_;
+      length = control_length_;
+    }
+
+    if (opcode_ == WS_OPCODE_CLOSE && length > 0) {
+      if (length == 1 || !IsValidCloseCode((payload[0] << 8) | payload[1])) {
+        Fail(WS_CLOSE_PROTOCOL_ERROR, "invalid close code", events);
+        return;
+      }
+      if (!IsValidUtf8(payload + 2, length - 2)) {
+        Fail(WS_CLOSE_INVALID_DATA, "invalid UTF-8 close reason", events);
+        return;
+      }
+    }
+
+    // the next frame of the chunk may start a control frame again, the
+    // payload can't stay in control_
+    if (!in_place_) {
+      event.data_ = (char *)malloc(length > 0 ? length : 1);
+      if (event.data_ == NULL) {
+        Fail(WS_CLOSE_TOO_BIG, "out of memory", events);
+        return;
+      }
+      memcpy(event.data_, control_, length);
+      event.length_ = length;
+      event.owned_ = true;
+    }
+    events->push_back(event);
+    return;
+  }
+
+  if (!in_place_) {
+    // the fragmented message goes on
+    if (!fin_) return;
+
+    event.opcode_ = message_opcode_;
+    event.data_ = message_;
+    event.length_ = message_length_;
+    event.owned_ = true;
+    payload = (const unsigned char *)message_;
+    length = message_length_;
+
+    // the Buffer takes the reassembled message over
+    message_ = NULL;
+    message_length_ = 0;
+    message_capacity_ = 0;
+    message_opcode_ = 0;
+  }
+
+  // a compressed message is validated once it's inflated
+  if (event.opcode_ == WS_OPCODE_TEXT && !IsValidUtf8(payload, length)) {
+    if (event.owned_) free(event.data_);
+    Fail(WS_CLOSE_INVALID_DATA, "invalid UTF-8 text message", events);
+    return;
+  }
+  events->push_back(event);
+}
+
+void FrameCodec::Execute(char *data, size_t pos, const size_t end,
+                         std::vector<WebSocketEvent> *events) {
+  if (failed_) {
+    Fail(error_code_, error_reason_, events);
+    return;
+  }
+
+  while (pos < end) {
+    if (!in_payload_) {
+      size_t needed = HeaderSize(header_, header_length_);
+      while (header_length_ < needed && pos < end) {
+        header_[header_length_++] = (unsigned char)data[pos++];
+        needed = HeaderSize(header_, header_length_);
+      }
+      if (header_length_ < needed) break;
+
+      header_length_ = 0;
+      if (!StartFrame(end - pos, events)) return;
+      if (remaining_ == 0) {
+        EndFrame(data, pos, pos, events);
+        if (failed_) return;
+        continue;
+      }
+    }
+
+    size_t take = end - pos;
+    if (remaining_ < take) take = (size_t)remaining_;
+
+    char *payload = data + pos;
+    if (masked_) Unmask(payload, take, mask_, mask_offset_);
+    mask_offset_ = (mask_offset_ + take) & 3;
+
+    if (!in_place_) {
+      if (opcode_ >= WS_OPCODE_CLOSE) {
+        memcpy(control_ + control_length_, payload, take);
+        control_length_ += take;
+      } else {
+        memcpy(message_ + message_length_, payload, take);
+        message_length_ += take;
+      }
+    }
+
+    const size_t start = pos;
+    pos += take;
+    remaining_ -= take;
+    if (remaining_ == 0) {
+      EndFrame(data, start, pos, events);
+      if (failed_) return;
+    }
+  }
+}
+
+void FrameCodec::Reset() {
+  header_length_ = 0;
+  in_payload_ = false;
+  free(message_);
+  message_ = NULL;
+  message_length_ = 0;
+  message_capacity_ = 0;
+  message_opcode_ = 0;
+  control_length_ = 0;
+  failed_ = false;
+}
+
+static void FreeMessage(char *data, void *hint) { free(data); }
+
+JS_METHOD(WebSocketWrap, New) {
+  JS_CLASS_NEW_INSTANCE(obj, FrameCodec);
+
+  size_t max_message = WS_DEFAULT_MAX_MESSAGE;
+  if (args.Length() > 1 && args.IsNumber(1)) {
+    const int64_t max = args.GetInteger(1);
+    max_message = max > 0 ? (size_t)max : 0;
+  }
+  if (max_message > Buffer::kMaxLength) max_message = Buffer::kMaxLength;
+
+  FrameCodec *codec =
+      new FrameCodec(args.Length() > 0 && args.GetBoolean(0), max_message);
+  codec->Wrap(obj);
+  RETURN_POINTER(obj);
+}
+JS_METHOD_END
+
+JS_METHOD(WebSocketWrap, Execute) {
+  FrameCodec *codec = ObjectWrap::Unwrap<FrameCodec>(args.This());
+
+  if (!Buffer::jxHasInstance(GET_ARG(0), com)) {
+    THROW_TYPE_EXCEPTION("expects a Buffer");
+  }
+  JS_LOCAL_OBJECT buffer = JS_VALUE_TO_OBJECT(GET_ARG(0));
+  char *data = BUFFER__DATA(buffer);
+  const size_t length = BUFFER__LENGTH(buffer);
+
+  const size_t start = args.Length() > 1 ? args.GetUInteger(1) : 0;
+  const size_t end = args.Length() > 2 ? args.GetUInteger(2) : length;
+  if (start > end || end > length) {
+    THROW_RANGE_EXCEPTION("out of range index");
+  }
+
+  std::vector<WebSocketEvent> events;
+  codec->Execute(data, start, end, &events);
+
+  JS_LOCAL_ARRAY arr = JS_NEW_ARRAY_WITH_COUNT(events.size() * 3);
+  for (size_t i = 0; i < events.size(); i++) {
+    const WebSocketEvent &event = events[i];
+    JS_INDEX_SET(arr, i * 3, STD_TO_INTEGER(event.opcode_));
+
+    if (event.opcode_ == WS_ERROR) {
+      JS_INDEX_SET(arr, i * 3 + 1, STD_TO_INTEGER(event.start_));
+      JS_INDEX_SET(arr, i * 3 + 2, STD_TO_STRING(event.reason_));
+      continue;
+    }
+
+    if (event.data_ == NULL) {
+      JS_INDEX_SET(arr, i * 3 + 1, STD_TO_UNSIGNED(event.start_));
+      JS_INDEX_SET(arr, i * 3 + 2, STD_TO_UNSIGNED(event.end_));
+      continue;
+    }
+
+    Buffer *payload;
+    if (event.owned_ && event.length_ > 0) {
+      payload = Buffer::New(event.data_, event.length_, FreeMessage, NULL, com);
+    } else {
+      payload = Buffer::New(event.data_, event.length_, com);
+      if (event.owned_) free(event.data_);
+    }
+    JS_INDEX_SET(arr, i * 3 + 1, JS_TYPE_TO_LOCAL_OBJECT(payload->handle_));
+    JS_INDEX_SET(arr, i * 3 + 2, STD_TO_UNSIGNED(event.length_));
+  }
+
+  RETURN_PARAM(arr);
+}
+JS_METHOD_END
+
+JS_METHOD(WebSocketWrap, Reset) {
+  FrameCodec *codec = ObjectWrap::Unwrap<FrameCodec>(args.This());
+  codec->Reset();
+  RETURN();
+}
+JS_METHOD_END
+
+// the masking key argument, NULL when there is none
+#define GET_MASK_ARG(index)                                              \
+  const unsigned char *mask = NULL;                                      \
+  if (args.Length() > index && !args.IsUndefined(index)) {               \
+    if (!Buffer::jxHasInstance(GET_ARG(index), com) ||                   \
+        BUFFER__LENGTH(JS_VALUE_TO_OBJECT(GET_ARG(index))) != 4) {       \
+      THROW_TYPE_EXCEPTION("expects a 4 byte Buffer as the masking key"); \
+    }                                                                    \
+    mask = (const unsigned char *)BUFFER__DATA(                          \
+        JS_VALUE_TO_OBJECT(GET_ARG(index)));                             \
+  }
+
+JS_METHOD(WebSocketWrap, Header) {
+  if (!args.IsNumber(0) || !args.IsNumber(1)) {
+    THROW_TYPE_EXCEPTION("expects the opcode and the payload length");
+  }
+  const int opcode = args.GetInt32(0);
+  const int64_t length = args.GetInteger(1);
+  if (length < 0) THROW_RANGE_EXCEPTION("invalid payload length");
+  const bool fin = args.Length() < 3 || args.GetBoolean(2);
+  GET_MASK_ARG(3);
+
+  unsigned char header[WS_MAX_HEADER];
+  const size_t size = BuildHeader(header, opcode, length, fin, mask);
+
+  Buffer *buffer = Buffer::New((const char *)header, size, com);
+  RETURN_PARAM(JS_TYPE_TO_LOCAL_OBJECT(buffer->handle_));
+}
+JS_METHOD_END
+
+JS_METHOD(WebSocketWrap, Encode) {
+  if (!args.IsNumber(0)) THROW_TYPE_EXCEPTION("expects the opcode");
+
+  const char *payload;
+  size_t length;
+  jxcore::JXString str;
+  if (args.IsString(1)) {
+    length = args.GetString(1, &str);
+    payload = *str;
+  } else if (Buffer::jxHasInstance(GET_ARG(1), com)) {
+    JS_LOCAL_OBJECT obj = JS_VALUE_TO_OBJECT(GET_ARG(1));
+    payload = BUFFER__DATA(obj);
+    length = BUFFER__LENGTH(obj);
+  } else {
+    THROW_TYPE_EXCEPTION("expects a Buffer or a string payload");
+  }
+
+  const int opcode = args.GetInt32(0);
+  const bool fin = args.Length() < 3 || args.GetBoolean(2);
+  GET_MASK_ARG(3);
+
+  unsigned char header[WS_MAX_HEADER];
+  const size_t size = BuildHeader(header, opcode, length, fin, mask);
+  if (length > Buffer::kMaxLength - size) {
+    THROW_RANGE_EXCEPTION("payload is too big");
+  }
+
+  Buffer *buffer = Buffer::New(size + length, com);
+  char *frame = Buffer::Data(buffer);
+  memcpy(frame, header, size);
+  memcpy(frame + size, payload, length);
+  if (mask != NULL) Unmask(frame + size, length, mask, 0);
+
+  RETURN_PARAM(JS_TYPE_TO_LOCAL_OBJECT(buffer->handle_));
+}
+JS_METHOD_END
+
+}  // namespace node
+
+NODE_MODULE(node_websocket_wrap, node::WebSocketWrap::Initialize)
@@ -0,0 +1,70 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+#ifndef SRC_WRAPPERS_WEBSOCKET_WRAP_H_
+#define SRC_WRAPPERS_WEBSOCKET_WRAP_H_
+
+#include "node.h"
+
+namespace node {
+
+enum WebSocketOpcode {
+  WS_OPCODE_CONTINUATION = 0x0,
+  WS_OPCODE_TEXT = 0x1,
+  WS_OPCODE_BINARY = 0x2,
+  WS_OPCODE_CLOSE = 0x8,
+  WS_OPCODE_PING = 0x9,
+  WS_OPCODE_PONG = 0xA,
+  // RSV1, the message is compressed (permessage-deflate)
+  WS_COMPRESSED = 0x40,
+  // execute() reports a protocol error instead of a message
+  WS_ERROR = -1
+};
+
+// RFC 6455 frames of an upgraded connection. execute() takes the chunks the
+// socket reads (a slab Buffer and its range), unmasks the payloads in place
+// and reassembles the fragmented messages natively
+//
+// new FrameCodec(isServer, maxMessage)
+//   isServer: true expects masked frames, false expects unmasked ones
+//   maxMessage: the largest (reassembled) message payload in bytes
+class WebSocketWrap {
+  static DEFINE_JS_METHOD(New);
+
+  // execute(buffer, start, end) returns [opcode, payload, end, ...]. When
+  // the payload is a number the message is buffer.slice(payload, end),
+  // otherwise it is a Buffer of its own. On a protocol error the last
+  // triplet is [WS_ERROR, closeCode, reason] and the codec stops parsing
+  static DEFINE_JS_METHOD(Execute);
+
+  // reset() drops the partial frame and message
+  static DEFINE_JS_METHOD(Reset);
+
+  // header(opcode, length, fin, mask) returns the frame header alone, the
+  // payload is written after it as it is (unmasked frames only)
+  static DEFINE_JS_METHOD(Header);
+
+  // encode(opcode, payload, fin, mask) returns the whole frame. mask is a
+  // 4 byte Buffer (client frames) or undefined
+  static DEFINE_JS_METHOD(Encode);
+
+  INIT_NAMED_CLASS_MEMBERS(FrameCodec, WebSocketWrap) {
+    NODE_SET_PROTOTYPE_METHOD(constructor, "execute", Execute);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "reset", Reset);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "header", Header);
+    NODE_SET_PROTOTYPE_METHOD(constructor, "encode", Encode);
+
+    NODE_DEFINE_CONSTANT(target, WS_OPCODE_CONTINUATION);
+    NODE_DEFINE_CONSTANT(target, WS_OPCODE_TEXT);
+    NODE_DEFINE_CONSTANT(target, WS_OPCODE_BINARY);
+    NODE_DEFINE_CONSTANT(target, WS_OPCODE_CLOSE);
+    NODE_DEFINE_CONSTANT(target, WS_OPCODE_PING);
+    NODE_DEFINE_CONSTANT(target, WS_OPCODE_PONG);
+    NODE_DEFINE_CONSTANT(target, WS_COMPRESSED);
+    NODE_DEFINE_CONSTANT(target, WS_ERROR);
+  }
+  END_INIT_NAMED_MEMBERS(FrameCodec)
+};
+
+}  // namespace node
+
+#endif  // SRC_WRAPPERS_WEBSOCKET_WRAP_H_
@@ -0,0 +1,98 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the SlowBuffer memory of the size classes. Buffers
+ around the class boundaries are filled, released and allocated again while
+ the others are kept, none of them may share or lose its memory. The
+ allocator counters are checked after a churn. With mt-keep every thread
+ churns its own buffers.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var SlowBuffer = require('buffer').SlowBuffer;
+
+var finished = false;
+
+// below, at and above the 8KB .. 256KB class sizes
+var sizes = [4096, 4097, 8191, 8192, 8193, 16384, 65535, 65536, 65537,
+  262144, 262145, 1024 * 1024];
+
+var fill = function (buf, seed) {
+  for (var i = 0; i < buf.length - 1; i += 511)
+    buf[i] = (seed + i) & 0xff;
+  buf[buf.length - 1] = seed & 0xff;
+};
+
+var check = function (buf, seed, size) {
+  assert.strictEqual(buf.length, size, "Wrong buffer length.");
+  for (var i = 0; i < buf.length - 1; i += 511)
+    assert.strictEqual(buf[i], (seed + i) & 0xff,
+        "Buffer of " + size + " bytes lost its data at " + i);
+  assert.strictEqual(buf[buf.length - 1], seed & 0xff,
+      "Buffer of " + size + " bytes lost its last byte.");
+};
+
+var kept = [];
+for (var round = 0; round < 20; round++) {
+  sizes.forEach(function (size, n) {
+    var seed = round * sizes.length + n;
+    var slow = new SlowBuffer(size);
+    fill(slow, seed);
+    // the large fast buffers are backed by a SlowBuffer of their own
+    var fast = new Buffer(size);
+    fill(fast, seed + 1);
+
+    // every other buffer is released, its block goes back to the class
+    if (seed % 2) kept.push([slow, seed, size], [fast, seed + 1, size]);
+  });
+  // let the released ones be collected between the rounds
+  if (typeof gc === 'function') gc();
+}
+
+kept.forEach(function (item) {
+  check(item[0], item[1], item[2]);
+});
+
+// the pool chunks (8KB) and the slices of them
+var slices = [];
+for (var i = 0; i < 4096; i++) {
+  var s = new Buffer(100);
+  s.fill(i & 0xff);
+  slices.push(s);
+}
+slices.forEach(function (s, i) {
+  assert.strictEqual(s[0], i & 0xff, "Pooled slice was overwritten.");
+  assert.strictEqual(s[99], i & 0xff, "Pooled slice was overwritten.");
+});
+
+// copy between buffers of different classes
+var src = new Buffer(70000);
+fill(src, 7);
+var dst = new Buffer(70000);
+src.copy(dst);
+check(dst, 7, 70000);
+
+// released blocks are reused, and no more than the limit is kept. gc is
+// there with --expose_gc (see the .json)
+if (typeof gc === 'function') {
+  var before = SlowBuffer.allocatorUsage();
+  for (var round = 0; round < 10; round++) {
+    for (var i = 0; i < 16; i++) new SlowBuffer(65536);
+    gc();
+  }
+  var after = SlowBuffer.allocatorUsage();
+  assert.ok(after.reuses > before.reuses, "Released blocks were not reused.");
+  assert.ok(after.allocs > before.allocs, "Allocations were not counted.");
+  assert.ok(after.cached <= after.limit, "Kept more than the limit.");
+}
+
+finished = true;
+
+// mt-keep threads stay alive until they are released
+if (process.threadId !== -1)
+  process.release();
+
+process.on("exit", function (code) {
+  assert.ok(finished, "Test unit did not finish.");
+});
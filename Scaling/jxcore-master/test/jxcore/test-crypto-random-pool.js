@@ -0,0 +1,85 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the buffered random pool of the small randomBytes
+ requests and crypto.randomBytesBatch. With mt-keep every thread reads its
+ own pool.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var crypto = require('crypto');
+
+var finished = false;
+var called = 0;
+
+// up to 256 bytes from the pool, 257 goes to OpenSSL
+[0, 1, 16, 32, 255, 256, 257, 4096].forEach(function (size) {
+  [crypto.randomBytes, crypto.pseudoRandomBytes].forEach(function (f) {
+    var buf = f(size);
+    assert.ok(Buffer.isBuffer(buf), "randomBytes didn't return a Buffer.");
+    assert.strictEqual(buf.length, size, "Wrong length for " + size);
+
+    var sync = true;
+    f(size, function (err, buf) {
+      assert.ok(!sync, "The callback was called synchronously.");
+      assert.strictEqual(err, null, "Unexpected error: " + err);
+      assert.strictEqual(buf.length, size, "Wrong length for " + size);
+      // mt-keep threads stay alive until they are released
+      if (++called === 16 && process.threadId !== -1)
+        process.release();
+    });
+    sync = false;
+  });
+});
+
+[-1, 1.5, undefined, null, true, {}, []].forEach(function (value) {
+  assert.throws(function () {
+    crypto.randomBytes(value, function () {});
+  }, TypeError);
+});
+
+// no repeated ids, the bits are balanced
+var seen = {};
+var ones = 0;
+for (var i = 0; i < 20000; i++) {
+  var id = crypto.randomBytes(16);
+  var hex = id.toString('hex');
+  assert.ok(!seen[hex], "Repeated id " + hex);
+  seen[hex] = true;
+  for (var j = 0; j < id.length; j++)
+    for (var b = id[j]; b; b >>= 1) ones += b & 1;
+}
+var ratio = ones / (20000 * 128);
+assert.ok(ratio > 0.49 && ratio < 0.51, "Biased output: " + ratio);
+
+var ids = crypto.randomBytesBatch(1000, 16, 'hex');
+assert.strictEqual(ids.length, 1000, "Wrong batch size.");
+ids.forEach(function (hex) {
+  assert.strictEqual(hex.length, 32, "Wrong id length.");
+  assert.ok(!seen[hex], "Repeated id " + hex);
+  seen[hex] = true;
+});
+
+var bufs = crypto.randomBytesBatch(10, 300);
+assert.strictEqual(bufs.length, 10, "Wrong batch size.");
+assert.ok(Buffer.isBuffer(bufs[9]) && bufs[9].length === 300,
+    "Wrong batch item.");
+assert.notStrictEqual(bufs[0].toString('hex'), bufs[1].toString('hex'),
+    "Repeated batch items.");
+assert.strictEqual(crypto.randomBytesBatch(0, 16).length, 0,
+    "Empty batch wasn't empty.");
+
+assert.throws(function () {
+  crypto.randomBytesBatch(-1, 16);
+}, TypeError);
+assert.throws(function () {
+  crypto.randomBytesBatch(10, 0);
+}, TypeError);
+
+finished = true;
+
+process.on("exit", function (code) {
+  assert.ok(finished, "Test unit did not finish.");
+  assert.strictEqual(called, 16, "Callbacks called: " + called);
+});
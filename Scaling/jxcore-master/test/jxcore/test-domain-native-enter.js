@@ -0,0 +1,58 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the domain enter / exit done by MakeCallback. The
+ domain stack has to be the same with the one Domain.prototype.enter / exit
+ would leave, and the overridden methods still have to be called.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var domain = require('domain');
+var fs = require('fs');
+
+var plainDone = false, customEnters = 0, customExits = 0;
+
+process.on('exit', function () {
+  assert.ok(plainDone, "The callback of the plain domain did not run.");
+  assert.strictEqual(customEnters, 2, "Overridden enter was not called.");
+  assert.strictEqual(customExits, 2, "Overridden exit was not called.");
+  assert.strictEqual(domain._stack.length, 0, "Domain stack is not empty.");
+});
+
+var d = domain.create();
+d.run(function () {
+  fs.stat(__filename, function (err) {
+    assert.ifError(err);
+    assert.strictEqual(process.domain, d, "process.domain is not set.");
+    assert.strictEqual(domain.active, d, "domain.active is not set.");
+    assert.strictEqual(domain._stack[domain._stack.length - 1], d,
+        "Domain is not on the stack.");
+    plainDone = true;
+
+    // the immediate enters d by itself. if the fs callback left d entered
+    // the stack would hold it twice
+    setImmediate(function () {
+      assert.strictEqual(domain._stack.length, 1, "Domain was not exited.");
+      assert.strictEqual(domain._stack[0], d, "Domain is not on the stack.");
+    });
+  });
+});
+
+var custom = domain.create();
+custom.enter = function () {
+  customEnters++;
+  domain.Domain.prototype.enter.call(this);
+};
+custom.exit = function () {
+  customExits++;
+  domain.Domain.prototype.exit.call(this);
+};
+
+// entered once by run() and once more for the fs callback
+custom.run(function () {
+  fs.stat(__filename, function (err) {
+    assert.ifError(err);
+    assert.strictEqual(process.domain, custom, "Custom domain is not active.");
+  });
+});
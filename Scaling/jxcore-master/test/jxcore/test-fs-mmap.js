@@ -0,0 +1,88 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing fs.mmapSync. The mapped Buffers must show the same
+ bytes as fs.readFileSync for the whole file and for the unaligned ranges.
+ With mt-keep every thread maps its own file.
+ */
+
+if (process.platform === 'win32' || process.isPackaged)
+  return;
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var fs = require('fs');
+var path = require('path');
+
+var finished = false;
+var tid = process.threadId === -1 ? 0 : process.threadId;
+var file = path.join(__dirname, "test-fs-mmap-tmp-" + tid + ".bin");
+var empty = path.join(__dirname, "test-fs-mmap-tmp-empty-" + tid + ".bin");
+
+var data = new Buffer(3 * 4096 + 123);
+for (var i = 0; i < data.length; i++)
+  data[i] = (i * 7 + tid) & 0xff;
+fs.writeFileSync(file, data);
+fs.writeFileSync(empty, "");
+
+process.on("exit", function (code) {
+  fs.unlinkSync(file);
+  fs.unlinkSync(empty);
+  assert.ok(finished, "Test unit did not finish.");
+});
+
+var same = function (buf, start, end, msg) {
+  assert.strictEqual(buf.length, end - start, msg + ": wrong length.");
+  assert.strictEqual(buf.toString('hex'),
+      data.slice(start, end).toString('hex'), msg + ": wrong contents.");
+};
+
+same(fs.mmapSync(file), 0, data.length, "whole file");
+
+['normal', 'random', 'sequential', 'willneed'].forEach(function (advice) {
+  same(fs.mmapSync(file, { advice: advice }), 0, data.length, advice);
+});
+
+// unaligned ranges
+same(fs.mmapSync(file, { offset: 1 }), 1, data.length, "offset 1");
+same(fs.mmapSync(file, { offset: 4095, length: 2 }), 4095, 4097,
+    "across pages");
+same(fs.mmapSync(file, { offset: 8192, length: 4096 }), 8192, 12288,
+    "one page");
+same(fs.mmapSync(file, { offset: data.length - 5 }), data.length - 5,
+    data.length, "end of file");
+
+// the same range twice shares the mapping, the slices work as usual
+var a = fs.mmapSync(file, { offset: 100, length: 1000 });
+var b = fs.mmapSync(file, { offset: 100, length: 1000 });
+same(a.slice(10, 20), 110, 120, "slice");
+same(b, 100, 1100, "second mapping");
+a = null;
+if (typeof gc === 'function') gc();
+same(b, 100, 1100, "after the first one was released");
+
+assert.strictEqual(fs.mmapSync(empty).length, 0, "Empty file.");
+assert.strictEqual(fs.mmapSync(file, { offset: data.length }).length, 0,
+    "Empty range.");
+
+assert.throws(function () {
+  fs.mmapSync(file, { offset: data.length + 1 });
+}, RangeError);
+assert.throws(function () {
+  fs.mmapSync(file, { offset: 10, length: data.length });
+}, RangeError);
+assert.throws(function () {
+  fs.mmapSync(file, { advice: 'dontneed' });
+}, TypeError);
+assert.throws(function () {
+  fs.mmapSync(file, { offset: -1 });
+}, TypeError);
+assert.throws(function () {
+  fs.mmapSync(file + ".missing");
+}, /ENOENT/);
+
+finished = true;
+
+// mt-keep threads stay alive until they are released
+if (process.threadId !== -1)
+  process.release();
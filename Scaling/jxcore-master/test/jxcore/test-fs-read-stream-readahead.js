@@ -0,0 +1,88 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the read-ahead of fs.ReadStream. The streams must
+ deliver the same bytes with and without readAhead, for the whole file and
+ for a range, and the blocks grow beyond highWaterMark for a fast reader.
+ readAhead is off by default.
+ */
+
+if (process.isPackaged)
+  return;
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var fs = require('fs');
+var path = require('path');
+
+var tid = process.threadId === -1 ? 0 : process.threadId;
+var file = path.join(__dirname, "test-fs-readahead-tmp-" + tid + ".bin");
+
+var data = new Buffer(6 * 1024 * 1024 + 17);
+for (var i = 0; i < data.length; i++)
+  data[i] = (i * 13 + (i >> 16)) & 0xff;
+fs.writeFileSync(file, data);
+
+var pending = 0;
+
+// mt-keep threads stay alive until they are released
+var done = function () {
+  if (--pending === 0 && process.threadId !== -1)
+    process.release();
+};
+
+process.on("exit", function (code) {
+  fs.unlinkSync(file);
+  assert.strictEqual(pending, 0, "Test unit did not finish.");
+});
+
+var check = function (options, start, end, check_chunks) {
+  pending++;
+  var chunks = [];
+  var largest = 0;
+
+  var rs = fs.createReadStream(file, options);
+  rs.on('data', function (chunk) {
+    chunks.push(chunk);
+    largest = Math.max(largest, chunk.length);
+  });
+  rs.on('end', function () {
+    var got = Buffer.concat(chunks);
+    assert.strictEqual(got.length, end - start,
+        "Wrong length with " + JSON.stringify(options));
+    assert.ok(got.toString('hex') === data.slice(start, end).toString('hex'),
+        "Wrong contents with " + JSON.stringify(options));
+    check_chunks(largest);
+    done();
+  });
+};
+
+check({ readAhead: true }, 0, data.length, function (largest) {
+  assert.ok(largest > 64 * 1024, "The blocks didn't grow: " + largest);
+  assert.ok(largest <= 4 * 1024 * 1024, "Too big block: " + largest);
+});
+
+check({}, 0, data.length, function (largest) {
+  assert.ok(largest <= 64 * 1024, "Block bigger than highWaterMark.");
+});
+
+check({ readAhead: true, start: 100, end: 5000000 }, 100, 5000001,
+      function () {});
+check({ readAhead: true, start: 0, end: 0 }, 0, 1, function () {});
+check({ start: 100, end: 5000000 }, 100, 5000001, function () {});
+
+// destroyed while a read is in flight, no errors or data afterwards
+pending++;
+var rs = fs.createReadStream(file, { readAhead: true });
+rs.once('data', function () {
+  rs.destroy();
+  rs.on('data', function () {
+    assert.fail("data after destroy");
+  });
+});
+rs.on('error', function (err) {
+  assert.fail("error after destroy: " + err);
+});
+rs.on('close', function () {
+  done();
+});
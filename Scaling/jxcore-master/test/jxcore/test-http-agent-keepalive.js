@@ -0,0 +1,99 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the keep-alive pool of http.Agent. Sequential requests
+ share a single socket, a pooled socket is closed and removed from the pool
+ once it reaches its idle timeout or emits an error.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var http = require("http");
+
+var finished = false;
+var port = 8127;
+var name = 'localhost:' + port;
+var agent = new http.Agent({ keepAlive: true, freeSocketTimeout: 200 });
+var sockets = [];
+var responses = 0;
+
+
+// ########   server
+
+var srv = http.createServer(function (req, res) {
+  assert.strictEqual(req.headers.connection, 'keep-alive',
+      "Client didn't ask for keep-alive.");
+  res.end("ok");
+});
+
+srv.on('error', function (e) {
+  jx.throwMT("Server error: \n" + e);
+});
+
+srv.on("listening", function () {
+  request(5, expireIdle);
+});
+srv.listen(port, "localhost");
+
+
+// ########   client
+
+var request = function (left, next) {
+  var req = http.get({
+    hostname: 'localhost',
+    port: port,
+    path: '/',
+    agent: agent
+  }, function (res) {
+    res.resume();
+    res.on('end', function () {
+      responses++;
+      // the socket is parked after the 'end' listeners
+      setImmediate(function () {
+        assert.strictEqual(agent.freeSockets[name].length, 1,
+            "Socket wasn't parked.");
+        assert.ok(!agent.sockets[name], "Parked socket is still in use.");
+        if (left > 1)
+          request(left - 1, next);
+        else
+          next();
+      });
+    });
+  });
+
+  req.on('socket', function (socket) {
+    if (sockets.indexOf(socket) === -1)
+      sockets.push(socket);
+  });
+
+  req.on("error", function (err) {
+    assert.ifError(err, "Client error: \n" + err);
+  });
+};
+
+var expireIdle = function () {
+  assert.strictEqual(sockets.length, 1, "Requests didn't share the socket.");
+
+  setTimeout(function () {
+    assert.ok(!agent.freeSockets[name], "Idle socket wasn't closed.");
+    request(1, evictOnError);
+  }, 600);
+};
+
+var evictOnError = function () {
+  assert.strictEqual(sockets.length, 2, "Closed socket was reused.");
+
+  // nobody listens for the errors of a parked socket
+  agent.freeSockets[name][0].emit('error', new Error('test error'));
+  setTimeout(function () {
+    assert.ok(!agent.freeSockets[name], "Failed socket wasn't removed.");
+    srv.close();
+    finished = true;
+  }, 100);
+};
+
+
+process.on("exit", function (code) {
+  assert.ok(finished, "Test unit did not finish.");
+  assert.strictEqual(responses, 6, "Wrong number of responses.");
+});
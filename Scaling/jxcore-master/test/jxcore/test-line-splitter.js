@@ -0,0 +1,36 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the native line splitter used by readline and the IPC
+ channel. The lines are split the same way for every chunk size, including
+ the \r\n pairs and the UTF-8 characters split by the chunks.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var LineSplitter = process.binding('line_splitter_wrap').LineSplitter;
+
+var long = new Array(100001).join('y');
+var text = 'a\r\nb\rc\n\nçé€😀\r\r\n' + long + '\nlast';
+var expected = ['a', 'b', 'c', '', 'çé€😀', '', long];
+var buffer = new Buffer(text);
+
+[1, 2, 3, 7, 1000, buffer.length].forEach(function(size) {
+  var splitter = new LineSplitter(true);
+  var lines = [];
+  for (var pos = 0; pos < buffer.length; pos += size) {
+    lines = lines.concat(splitter.write(buffer.slice(pos, pos + size)));
+  }
+  assert.deepEqual(lines, expected, "Wrong lines for chunk size " + size);
+  assert.strictEqual(splitter.pending(), 4, "Wrong pending length.");
+  assert.strictEqual(splitter.end(), 'last', "Wrong unfinished line.");
+  assert.strictEqual(splitter.pending(), 0, "End didn't reset.");
+});
+
+// only \n ends a line for the IPC channel
+var splitter = new LineSplitter(false);
+assert.deepEqual(splitter.write(new Buffer('{"a":1}\r\n{"b"')), ['{"a":1}\r'],
+                 "Wrong IPC lines.");
+assert.deepEqual(splitter.write(new Buffer(':2}\n')), ['{"b":2}'],
+                 "Wrong IPC continuation.");
+assert.deepEqual(splitter.write(new Buffer('\r')), [], "\\r ended a line.");
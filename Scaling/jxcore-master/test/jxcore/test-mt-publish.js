@@ -0,0 +1,73 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ In this test unit (executed with mt-keep) every thread subscribes to a topic
+ and publishes `count` messages to it. We check if every subscriber (including
+ the publisher itself) has received all of them and the unsubscribed topics
+ don't deliver anything. The pings of the channels shouldn't reach the
+ threadMessage listeners
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+
+var threads = parseInt(process.argv[1].replace("mt-keep:", ""));
+
+if (isNaN(threads)) {
+  threads = 2; // default value for thread pool
+}
+
+var count = 50;
+var counter = 0;
+var cnts = {};
+var finished = false;
+
+var done = function() {
+  if (finished) return;
+  finished = true;
+
+  for (var a = 0; a < threads; a++) {
+    assert.strictEqual(cnts[a], count, "Thread " + process.threadId + " received from thread " + a + " " + cnts[a] + " messages instead of " + count);
+  }
+  jxcore.tasks.unsubscribe("test-channel");
+  if (process.subThread)
+    process.release();
+};
+
+jxcore.tasks.subscribe("test-channel", function (msg, threadId, topic) {
+  assert.strictEqual(topic, "test-channel");
+  assert.strictEqual(msg.x, threadId, "threadId should point to the publisher");
+
+  counter++;
+  cnts[msg.x] = (cnts[msg.x] || 0) + 1;
+
+  if (counter === count * threads)
+    done();
+});
+
+// a thread may receive an empty batch while it starts, check the ones
+// after the publishing has started
+var publishing = false;
+process.on("threadMessage", function (msgs) {
+  if (publishing)
+    assert.ok(msgs.length > 0, "threadMessage was emitted with an empty batch");
+});
+
+var ignored = function () {
+  assert.fail("unsubscribed callback was called");
+};
+jxcore.tasks.subscribe("test-ignored", ignored);
+jxcore.tasks.unsubscribe("test-ignored", ignored);
+
+setTimeout(function () {
+  publishing = true;
+  assert.strictEqual(jxcore.tasks.publish("test-nobody", {}), 0);
+
+  var tm = count;
+  while (tm--) {
+    var n = jxcore.tasks.publish("test-channel", {x: process.threadId});
+    assert.ok(n > 0 && n <= threads, "unexpected subscriber count " + n);
+  }
+  // if done() was not called already...
+  setTimeout(done, 10000).unref();
+}, 700);
@@ -0,0 +1,46 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the native nextTick queue. The ring grows past its
+ initial size, keeps the order and hands the pending callbacks over to the JS
+ queue once the domain module is loaded.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+
+var count = 1000, order = [], domainTicks = 0;
+
+process.on('exit', function () {
+  assert.strictEqual(order.length, count, "Some of the ticks did not run.");
+  for (var i = 0; i < count; i++)
+    assert.strictEqual(order[i], i, "Ticks ran out of order at " + i);
+  assert.strictEqual(domainTicks, 2, "Domain ticks did not run.");
+});
+
+function push(i) {
+  process.nextTick(function () {
+    order.push(i);
+  });
+}
+
+for (var i = 0; i < count / 2; i++)
+  push(i);
+
+process.nextTick(function () {
+  // switches to the JS queue while the native one still has callbacks
+  var domain = require('domain');
+  var d = domain.create();
+  d.run(function () {
+    process.nextTick(function () {
+      assert.strictEqual(process.domain, d, "Domain was not entered.");
+      domainTicks++;
+    });
+  });
+  process.nextTick(function () {
+    domainTicks++;
+  });
+});
+
+for (var i = count / 2; i < count; i++)
+  push(i);
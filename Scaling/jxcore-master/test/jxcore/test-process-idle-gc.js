@@ -0,0 +1,57 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the idle-time GC of the event loop. The engine is
+ notified when the loop waits for a far timer, the budget can be changed and
+ a zero budget turns the notification off.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+
+var finished = false;
+
+var stats = process.idleGC();
+assert.strictEqual(stats.budget, 5, "Wrong default budget.");
+assert.strictEqual(typeof stats.notifications, 'number',
+    "Notification count is missing.");
+assert.strictEqual(typeof stats.time, 'number', "GC time is missing.");
+
+assert.throws(function () {
+  process.idleGC(-1);
+}, TypeError, "Negative budget was accepted.");
+
+var garbage = function () {
+  var list = [];
+  for (var i = 0; i < 100000; i++)
+    list.push({ index: i, text: 'item ' + i });
+  return list.length;
+};
+
+garbage();
+var before = process.idleGC().notifications;
+
+// the loop waits 100ms for the timer
+setTimeout(function () {
+  var after = process.idleGC();
+  assert.ok(after.notifications > before, "Engine wasn't notified.");
+  assert.ok(after.time >= 0, "Wrong GC time.");
+
+  assert.strictEqual(process.idleGC(0).budget, 0, "Budget wasn't changed.");
+  garbage();
+  var disabled = process.idleGC().notifications;
+
+  setTimeout(function () {
+    assert.strictEqual(process.idleGC().notifications, disabled,
+        "Engine was notified with a zero budget.");
+    process.idleGC(5);
+    finished = true;
+    if (process.threadId !== -1)
+      process.release();
+  }, 100);
+}, 100);
+
+
+process.on("exit", function (code) {
+  assert.ok(finished, "Test unit did not finish.");
+});
@@ -0,0 +1,55 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the native querystring.parse / unescape against the
+ JS fallback paths (custom decoder, overridden unescape) and the Buffer input.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var qs = require('querystring');
+
+var body = 'a=1&b=%E2%82%AC+x&a=2&c&=e&bad=%zz%E2%82&d=%C3%A9';
+var expected = {
+  a: ['1', '2'],
+  b: '€ x',
+  c: '',
+  '': 'e',
+  bad: '%zz�',
+  d: 'é'
+};
+
+assert.deepEqual(qs.parse(body), expected, "native parse failed");
+assert.deepEqual(qs.parse(new Buffer(body)), expected,
+    "native parse of a Buffer failed");
+
+// custom separators and maxKeys
+assert.deepEqual(qs.parse('a:1;;b:2;c:3', ';;', ':'), {a: '1', b: '2;c:3'});
+assert.deepEqual(qs.parse('a=1&b=2&c=3', null, null, {maxKeys: 2}),
+    {a: '1', b: '2'});
+assert.deepEqual(qs.parse('a=1&b=2&c=3', null, null, {maxKeys: 0}),
+    {a: '1', b: '2', c: '3'});
+
+// custom decoder goes through the JS implementation
+var calls = 0;
+var upper = qs.parse('a=b', null, null, {
+  decodeURIComponent: function(str) {
+    calls++;
+    return str.toUpperCase();
+  }
+});
+assert.deepEqual(upper, {A: 'B'}, "custom decoder was not used");
+assert.strictEqual(calls, 2);
+
+// unescape
+assert.strictEqual(qs.unescape('a+b%20c'), 'a+b c');
+assert.strictEqual(qs.unescape('a+b%zz', true), 'a b%zz');
+assert.strictEqual(qs.unescape('a+b%E2%82%AC', true), 'a+b€');
+
+// an overridden unescape is still used by parse
+var unescape = qs.unescape;
+qs.unescape = function(str) {
+  return 'x' + str;
+};
+assert.deepEqual(qs.parse('a=b'), {xa: 'xb'}, "overridden unescape failed");
+qs.unescape = unescape;
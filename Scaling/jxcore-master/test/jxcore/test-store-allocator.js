@@ -0,0 +1,32 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the slab allocator counters behind the store values
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var store = jxcore.store;
+
+var before = store.allocatorUsage();
+store.set("alloc:a", "12345");
+store.set("alloc:b", new Array(10000).join("x"));
+
+var after = store.allocatorUsage();
+assert.strictEqual(after.allocs, before.allocs + 2, "Two blocks expected");
+assert.ok(after.reserved > 0, "A slab should be reserved");
+assert.ok(after.used >= after.requested, "Blocks can't be smaller than values");
+assert.ok(after.fragmentation >= 0 && after.fragmentation < 1,
+    "fragmentation should be a ratio");
+
+// same size class, the block should be reused
+store.set("alloc:a", "54321");
+var reused = store.allocatorUsage();
+assert.strictEqual(reused.reuses, after.reuses + 1, "Block should be reused");
+assert.strictEqual(reused.allocs, after.allocs, "No new block expected");
+
+store.remove("alloc:a");
+store.get("alloc:b");
+var removed = store.allocatorUsage();
+assert.strictEqual(removed.frees, after.frees + 2, "Two blocks were freed");
+assert.strictEqual(removed.used, before.used);
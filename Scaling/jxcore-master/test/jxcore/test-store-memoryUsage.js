@@ -0,0 +1,52 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing byte counters and key prefix sampling of the store
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var store = jxcore.store;
+var shared = jxcore.store.shared;
+
+var prefix = "mu" + process.threadId + ":";
+
+var before = store.memoryUsage();
+store.set(prefix + "a", "12345");
+store.set(prefix + "b", "12345");
+
+var after = store.memoryUsage();
+assert.strictEqual(after.keys, before.keys + 2, "Key count should grow by 2");
+assert.strictEqual(after.keyBytes - before.keyBytes, (prefix + "a").length * 2,
+    "keyBytes should grow by the length of the keys");
+assert.strictEqual(after.valueBytes - before.valueBytes, 12,
+    "valueBytes should grow by 12");
+assert.ok(after.nodeBytes > 0, "nodeBytes should be positive");
+assert.strictEqual(after.prefixes, undefined, "Sampling is not enabled");
+
+// overwriting a key should not leak the previous value from counters
+store.set(prefix + "a", "1");
+assert.strictEqual(store.memoryUsage().valueBytes, after.valueBytes - 4);
+
+store.remove(prefix + "a");
+store.get(prefix + "b");
+assert.strictEqual(store.memoryUsage().keys, before.keys);
+assert.strictEqual(store.memoryUsage().valueBytes, before.valueBytes);
+
+store.setKeySampling(1);
+store.set(prefix + "c", "x");
+var sampled = store.memoryUsage();
+assert.strictEqual(sampled.sampleRate, 1);
+assert.strictEqual(sampled.prefixes[prefix].samples, 1);
+store.setKeySampling(0);
+assert.strictEqual(store.memoryUsage().prefixes, undefined);
+store.remove(prefix + "c");
+
+var sbefore = shared.memoryUsage();
+shared.set(prefix + "shared", "123");
+var safter = shared.memoryUsage();
+assert.ok(safter.keys >= sbefore.keys + 1, "Shared key count should grow");
+shared.remove(prefix + "shared");
+
+if (process.threadId !== -1)
+  process.release();
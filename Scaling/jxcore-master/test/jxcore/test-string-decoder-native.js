@@ -0,0 +1,53 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the native StringDecoder. Mixed width text written in
+ random chunks has to give the same string as decoding the whole Buffer, the
+ incomplete character is returned from end().
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var StringDecoder = require('string_decoder').StringDecoder;
+
+var text = '';
+var chars = ['a', 'ç', '€', '日', '😀', ' ', 'Б'];
+for (var i = 0; i < 3000; i++)
+  text += chars[(i * 7 + (i >> 3)) % chars.length];
+
+['utf8', 'ucs2', 'utf16le', 'base64'].forEach(function(encoding) {
+  var buffer = new Buffer(text, encoding === 'base64' ? 'utf8' : encoding);
+  var expected = buffer.toString(encoding);
+
+  for (var seed = 1; seed < 20; seed++) {
+    var decoder = new StringDecoder(encoding);
+    var result = '', pos = 0, size = seed;
+    while (pos < buffer.length) {
+      size = (size * 31 + 7) % 13;
+      result += decoder.write(buffer.slice(pos, pos + size));
+      pos += size;
+    }
+    result += decoder.end();
+    assert.strictEqual(result, expected, "Wrong result for " + encoding +
+                       " (" + seed + ").");
+  }
+});
+
+// the partial character is returned as is
+var decoder = new StringDecoder('utf8');
+assert.strictEqual(decoder.write(new Buffer([0x61, 0xE2, 0x82])), 'a',
+                   "Partial character was returned.");
+var rest = decoder.end();
+assert.ok(rest.length > 0 && rest.indexOf('a') === -1,
+          "Partial character was lost.");
+assert.strictEqual(decoder.write(new Buffer('b')), 'b',
+                   "State was not reset by end.");
+
+decoder = new StringDecoder('base64');
+assert.strictEqual(decoder.write(new Buffer('ab')), '', "Base64 wrote early.");
+assert.strictEqual(decoder.end(new Buffer('c')), 'YWJj', "Wrong base64.");
+
+// the other encodings are not buffered
+decoder = new StringDecoder('hex');
+assert.strictEqual(decoder.write(new Buffer([1, 255])), '01ff', "Wrong hex.");
+assert.strictEqual(decoder.end(), '', "Hex end returned data.");
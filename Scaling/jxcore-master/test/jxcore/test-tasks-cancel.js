@@ -0,0 +1,90 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the cancellation of the queued / running tasks and the
+ partial results sent by tasks.sendProgress(). A task that returns a result
+ after it was cancelled delivers the result
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var tasks = jxcore.tasks;
+
+tasks.setThreadCount(2);
+
+var queuedDone = false, runningDone = false, completedDone = false;
+var chunks = 0;
+
+var check = function () {
+  if (queuedDone && runningDone && completedDone) setTimeout(process.exit, 10);
+};
+
+process.on('exit', function () {
+  assert.ok(queuedDone, "The queued task did not finish.");
+  assert.ok(runningDone, "The running task did not finish.");
+  assert.ok(completedDone, "The completed task did not finish.");
+});
+
+assert.strictEqual(tasks.isCancelled(), false);
+
+var worker = function (max) {
+  var end = Date.now() + max;
+  var n = 0;
+  while (Date.now() < end) {
+    if (jxcore.tasks.isCancelled())
+      return;
+    jxcore.tasks.sendProgress(n++);
+    var wait = Date.now() + 20;
+    while (Date.now() < wait) {}
+  }
+  return "timeout";
+};
+
+// runs right away, cancelled after the first partial result
+var running = tasks.scheduleTask({
+  onProgress: function (n) {
+    assert.strictEqual(n, chunks, "partial results are out of order");
+    chunks++;
+    if (chunks === 1) assert.ok(running.cancel());
+  }
+}, worker, 5000, function (err, ret) {
+  assert.ok(err, "The task should be cancelled");
+  assert.strictEqual(err.code, 'ECANCELED');
+  assert.ok(chunks >= 1, "At least one partial result expected");
+  runningDone = true;
+  check();
+});
+
+// cancelled while running but ignores it, its result wins
+var completed = tasks.scheduleTask({
+  onProgress: function () {
+    completed.cancel();
+  }
+}, function () {
+  jxcore.tasks.sendProgress(0);
+  var end = Date.now() + 200;
+  while (Date.now() < end) {}
+  return "result";
+}, null, function (err, ret) {
+  assert.ifError(err);
+  assert.strictEqual(ret, "result", "The result of the task was lost");
+  completedDone = true;
+  check();
+});
+
+// both threads are busy, the next task can be cancelled on the queue
+tasks.addTask(function () {
+  var end = Date.now() + 300;
+  while (Date.now() < end) {}
+});
+
+var queued = tasks.scheduleTask({}, function () {
+  throw new Error("cancelled task shouldn't run");
+}, null, function (err) {
+  assert.ok(err, "The task should be cancelled");
+  assert.strictEqual(err.code, 'ECANCELED');
+  assert.strictEqual(queued.cancel(), false, "Already cancelled");
+  queuedDone = true;
+  check();
+});
+assert.ok(queued.cancel());
@@ -0,0 +1,82 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing task priorities and deadlines of tasks.scheduleTask().
+ Both threads are kept busy first, so the queued tasks have to wait. The high
+ priority task, queued after the others, has to run before them
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var tasks = jxcore.tasks;
+
+tasks.setThreadCount(2);
+
+var busy = function (ms) {
+  var end = Date.now() + ms;
+  while (Date.now() < end) {}
+};
+
+var order = [];
+var expired = false;
+var finished = false;
+
+process.on('exit', function () {
+  assert.ok(finished, "The test did not finish.");
+});
+
+assert.throws(function () {
+  tasks.scheduleTask({ priority: 'urgent' }, busy, 1);
+}, RangeError);
+
+assert.throws(function () {
+  tasks.scheduleTask({ deadline: -1 }, busy, 1);
+}, RangeError);
+
+tasks.addTask(busy, 500);
+tasks.addTask(busy, 500);
+
+tasks.scheduleTask({ deadline: 50 }, busy, 1, function (err) {
+  assert.ok(err, "The task should expire");
+  assert.strictEqual(err.code, 'ETASKEXPIRED');
+  expired = true;
+});
+
+var normals = 10;
+var total = normals + 2;
+
+var push = function (name, priority) {
+  tasks.scheduleTask({ priority: priority }, function (name) {
+    var end = Date.now() + 20;
+    while (Date.now() < end) {}
+    return name;
+  }, name, function (err, ret) {
+    assert.ifError(err);
+    order.push(ret);
+    if (order.length === total) done();
+  });
+};
+
+push('low', 'low');
+for (var i = 0; i < normals; i++)
+  push('normal' + i, 'normal');
+// queued behind all of them while both threads are busy
+push('high', 0);
+
+var done = function () {
+  assert.ok(expired, "The expired task should be reported first");
+  // the other thread may only complete the normal task it has taken together
+  // with the high priority one
+  assert.ok(order.indexOf('high') <= 1,
+      "high priority task didn't overtake the queued ones: " + order);
+  assert.ok(order.indexOf('low') >= total - 2,
+      "low priority task ran before the others: " + order);
+
+  var stats = tasks.getQueueStats();
+  assert.ok(stats.high.dispatched >= 1);
+  assert.ok(stats.normal.expired >= 1);
+  assert.ok(stats.low.waitMax > 0);
+
+  finished = true;
+  setTimeout(process.exit, 10);
+};
@@ -0,0 +1,67 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the natively tokenized urls. The parts are created when
+ they are read, they stay enumerable and the href doesn't follow the changes
+ made after the parse. The urls the tokenizer leaves to the JS parser have to
+ give the same result.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var url = require('url');
+var util = require('util');
+
+var keys = ['protocol', 'slashes', 'auth', 'host', 'port', 'hostname',
+            'hash', 'search', 'query', 'pathname', 'path', 'href'];
+
+var parsed = url.parse('HTTP://user:pw@WWW.Example.com:8080?a=1#top', true);
+assert.deepEqual(Object.keys(parsed).sort(), keys.slice().sort(),
+                 "Parts are not enumerable.");
+assert.strictEqual(parsed.hostname, 'www.example.com', "Wrong hostname.");
+assert.strictEqual(parsed.host, 'www.example.com:8080', "Wrong host.");
+assert.strictEqual(parsed.pathname, '/', "Wrong pathname.");
+assert.deepEqual(parsed.query, { a: '1' }, "Wrong query.");
+assert.strictEqual(parsed.href, 'http://user:pw@www.example.com:8080/?a=1#top',
+                   "Wrong href.");
+
+// href is fixed at the first change
+parsed = url.parse('http://example.com/a/b?c');
+parsed.pathname = '/d';
+assert.strictEqual(parsed.pathname, '/d', "Setter failed.");
+assert.strictEqual(parsed.path, '/a/b?c', "Path followed the change.");
+assert.strictEqual(parsed.href, 'http://example.com/a/b?c',
+                   "Href followed the change.");
+
+// a part read before the change doesn't lose its setter
+parsed = url.parse('http://example.com/a/b?c');
+assert.strictEqual(parsed.pathname, '/a/b', "Wrong pathname.");
+parsed.pathname = '/d';
+assert.strictEqual(parsed.pathname, '/d', "Setter failed.");
+assert.strictEqual(parsed.href, 'http://example.com/a/b?c',
+                   "Href followed the change of a part read before.");
+
+// inspect shows the values, not the accessors
+var str = util.inspect(url.parse('http://example.com/x'));
+assert.ok(str.indexOf('Getter') === -1, "Inspect shows the accessors.");
+assert.ok(str.indexOf("'/x'") !== -1, "Inspect doesn't show the pathname.");
+
+// JSON and the copies see every part
+var copy = JSON.parse(JSON.stringify(url.parse('//host/p?q', false, true)));
+assert.strictEqual(copy.host, 'host', "JSON is missing the host.");
+assert.strictEqual(copy.query, 'q', "JSON is missing the query.");
+
+// urls the JS parser handles (escaping, IPv6, punycode, decoded auth)
+[
+  ['http://[::1]:80/x', 'http://[::1]:80/x'],
+  ['http://ex ample.com/a b', 'http://ex/%20ample.com/a%20b'],
+  ['http://a%40b@host/', 'http://a%40b@host/'],
+  ['http://bücher.de/', 'http://xn--bcher-kva.de/'],
+  ['javascript:alert(1)', 'javascript:alert(1)']
+].forEach(function(test) {
+  assert.strictEqual(url.parse(test[0]).href, test[1], "Wrong href for " +
+                     test[0]);
+});
+
+assert.strictEqual(url.resolve('http://example.com/a/b', '../c'),
+                   'http://example.com/c', "Resolve failed.");
@@ -0,0 +1,237 @@
+// Copyright & License details are available under JXCORE_LICENSE file
+
+/*
+ This unit is testing the native WebSocket frame codec. A local echo server
+ takes the upgraded connection, the client sends masked, fragmented and
+ compressed messages with a ping between the fragments and reads the echoed
+ frames back. The protocol errors are reported with their close codes.
+ */
+
+var jx = require('jxtools');
+var assert = jx.assert;
+var http = require("http");
+var net = require("net");
+var zlib = require("zlib");
+var crypto = require("crypto");
+var ws = process.binding('websocket_wrap');
+
+var finished = false;
+var port = 8128;
+var GUID = '258EAFA5-E914-47DA-95CA-C5AB0DC85B11';
+
+// [opcode, data] pairs of the frames in the chunk
+var execute = function (codec, chunk) {
+  var out = codec.execute(chunk, 0, chunk.length);
+  var frames = [];
+  for (var i = 0; i < out.length; i += 3) {
+    var payload = out[i + 1];
+    if (out[i] === ws.WS_ERROR)
+      throw new Error(payload + ' ' + out[i + 2]);
+    if (typeof payload === 'number')
+      payload = chunk.slice(payload, out[i + 2]);
+    frames.push([out[i], payload]);
+  }
+  return frames;
+};
+
+var mask = function () {
+  return crypto.randomBytes(4);
+};
+
+
+// ########   protocol errors
+
+var errorOf = function (isServer, frame) {
+  var out = new ws.FrameCodec(isServer).execute(frame, 0, frame.length);
+  assert.strictEqual(out[out.length - 3], ws.WS_ERROR, "Frame was accepted.");
+  return out[out.length - 2];
+};
+
+var client = new ws.FrameCodec(false);
+assert.strictEqual(errorOf(true, client.encode(ws.WS_OPCODE_TEXT, "a")), 1002,
+    "Server accepted an unmasked frame.");
+assert.strictEqual(
+    errorOf(true, client.encode(ws.WS_OPCODE_TEXT, new Buffer([0xc0, 0xaf]),
+        true, mask())), 1007, "Invalid UTF-8 was accepted.");
+assert.strictEqual(
+    errorOf(true, client.encode(ws.WS_OPCODE_PING, new Buffer(126), true,
+        mask())), 1002, "Long control frame was accepted.");
+assert.strictEqual(
+    errorOf(true, client.encode(ws.WS_OPCODE_CONTINUATION, "a", true,
+        mask())), 1002, "Continuation without a message was accepted.");
+var big = client.encode(ws.WS_OPCODE_BINARY, new Buffer(1025), true, mask());
+var out = new ws.FrameCodec(true, 1024).execute(big, 0, big.length);
+assert.strictEqual(out[1], 1009, "Too big message was accepted.");
+
+// the header length forms
+[0, 125, 126, 65535, 65536].forEach(function (length) {
+  var header = client.header(ws.WS_OPCODE_BINARY, length, true);
+  var frame = Buffer.concat([header, new Buffer(length)]);
+  var frames = execute(new ws.FrameCodec(false), frame);
+  assert.strictEqual(frames.length, 1, "Wrong frame count for " + length);
+  assert.strictEqual(frames[0][1].length, length, "Wrong payload length.");
+});
+
+// a split ping followed by another one in the same chunk, the first payload
+// must not be overwritten
+var pings = new ws.FrameCodec(false);
+assert.strictEqual(execute(pings, new Buffer([0x89, 4, 65, 65])).length, 0,
+    "Incomplete ping was reported.");
+var frames = execute(pings, new Buffer([65, 65, 0x89, 6, 66, 66, 66]));
+assert.strictEqual(frames.length, 1, "Wrong frame count.");
+assert.strictEqual(frames[0][1].toString(), "AAAA", "Ping payload was reused.");
+frames = execute(pings, new Buffer([66, 66, 66]));
+assert.strictEqual(frames[0][1].toString(), "BBBBBB", "Wrong ping payload.");
+
+
+// ########   server
+
+var srv = http.createServer(function (req, res) {
+  res.end();
+});
+
+srv.on('upgrade', function (req, socket, head) {
+  var accept = crypto.createHash('sha1')
+      .update(req.headers['sec-websocket-key'] + GUID).digest('base64');
+  socket.write('HTTP/1.1 101 Switching Protocols\r\n' +
+      'Upgrade: websocket\r\nConnection: Upgrade\r\n' +
+      'Sec-WebSocket-Accept: ' + accept + '\r\n\r\n');
+
+  var codec = new ws.FrameCodec(true);
+  var send = function (opcode, data) {
+    // the large payloads are written after their header without a copy
+    if (data.length > 1024) {
+      socket.write(codec.header(opcode, data.length, true));
+      socket.write(data);
+    } else {
+      socket.write(codec.encode(opcode, data, true));
+    }
+  };
+
+  var onData = function (chunk) {
+    execute(codec, chunk).forEach(function (frame) {
+      var opcode = frame[0];
+      if (opcode === ws.WS_OPCODE_PING)
+        return send(ws.WS_OPCODE_PONG, frame[1]);
+      if (opcode === ws.WS_OPCODE_CLOSE) {
+        send(ws.WS_OPCODE_CLOSE, frame[1]);
+        return socket.end();
+      }
+      if (opcode & ws.WS_COMPRESSED) {
+        return zlib.inflateRaw(frame[1], function (err, data) {
+          assert.ifError(err);
+          send(opcode & ~ws.WS_COMPRESSED, data);
+        });
+      }
+      send(opcode, frame[1]);
+    });
+  };
+
+  if (head.length) onData(head);
+  socket.on('data', onData);
+});
+
+srv.on('error', function (e) {
+  jx.throwMT("Server error: \n" + e);
+});
+
+srv.on("listening", function () {
+  connect();
+});
+srv.listen(port, "localhost");
+
+
+// ########   client
+
+var binary = crypto.randomBytes(70000);
+var received = [];
+
+var connect = function () {
+  var key = crypto.randomBytes(16).toString('base64');
+  var socket = net.connect(port, "localhost");
+  var codec = new ws.FrameCodec(false);
+  var handshake = '';
+  var closing = false;
+
+  socket.write('GET / HTTP/1.1\r\nHost: localhost\r\n' +
+      'Upgrade: websocket\r\nConnection: Upgrade\r\n' +
+      'Sec-WebSocket-Key: ' + key + '\r\n' +
+      'Sec-WebSocket-Version: 13\r\n\r\n');
+
+  socket.on('data', function (chunk) {
+    if (handshake !== null) {
+      handshake += chunk.toString('binary');
+      var end = handshake.indexOf('\r\n\r\n');
+      if (end === -1) return;
+      assert.ok(/^HTTP\/1.1 101/.test(handshake), "Upgrade failed.");
+      chunk = new Buffer(handshake.substr(end + 4), 'binary');
+      handshake = null;
+      sendMessages(socket, codec);
+    }
+    execute(codec, chunk).forEach(function (frame) {
+      received.push(frame);
+    });
+    // the compressed message is echoed once it's inflated
+    if (received.length === 5 && !closing) {
+      closing = true;
+      var close = new Buffer(2);
+      close.writeUInt16BE(1000, 0);
+      socket.write(codec.encode(ws.WS_OPCODE_CLOSE, close, true, mask()));
+    }
+  });
+
+  socket.on('end', function () {
+    check();
+    srv.close();
+  });
+};
+
+var sendMessages = function (socket, codec) {
+  var write = function (opcode, data, fin) {
+    socket.write(codec.encode(opcode, data, fin, mask()));
+  };
+
+  write(ws.WS_OPCODE_TEXT, 'hello çé€😀', true);
+  write(ws.WS_OPCODE_BINARY, binary, true);
+
+  // a fragmented message, the ping between the fragments
+  write(ws.WS_OPCODE_TEXT, 'frag', false);
+  write(ws.WS_OPCODE_PING, 'ping', true);
+  write(ws.WS_OPCODE_CONTINUATION, 'ment', false);
+  // the frame arrives byte by byte
+  var last = codec.encode(ws.WS_OPCODE_CONTINUATION, 'ed €', true, mask());
+  for (var i = 0; i < last.length; i++)
+    socket.write(last.slice(i, i + 1));
+
+  // a single final deflate block, the one-shot inflate takes it as it is
+  zlib.deflateRaw(new Buffer('compressed message'), function (err, data) {
+    assert.ifError(err);
+    write(ws.WS_OPCODE_TEXT | ws.WS_COMPRESSED, data, true);
+  });
+};
+
+var check = function () {
+  var text = function (i) {
+    return received[i][1].toString();
+  };
+  assert.strictEqual(received.length, 6, "Wrong number of echoed frames.");
+  assert.strictEqual(received[0][0], ws.WS_OPCODE_TEXT, "Wrong opcode.");
+  assert.strictEqual(text(0), 'hello çé€😀', "Wrong text message.");
+  assert.strictEqual(received[1][0], ws.WS_OPCODE_BINARY, "Wrong opcode.");
+  assert.ok(received[1][1].toString('hex') === binary.toString('hex'),
+      "Wrong binary message.");
+  assert.strictEqual(received[2][0], ws.WS_OPCODE_PONG,
+      "Ping wasn't answered.");
+  assert.strictEqual(text(2), 'ping', "Wrong pong payload.");
+  assert.strictEqual(text(3), 'fragmented €', "Wrong reassembled message.");
+  assert.strictEqual(text(4), 'compressed message', "Wrong inflated message.");
+  assert.strictEqual(received[5][0], ws.WS_OPCODE_CLOSE,
+      "Close wasn't echoed.");
+  assert.strictEqual(received[5][1].readUInt16BE(0), 1000, "Wrong close code.");
+  finished = true;
+};
+
+
+process.on("exit", function (code) {
+  assert.ok(finished, "Test unit did not finish.");
+});
@@ -0,0 +1,153 @@
+/* Copyright & License details are available under JXCORE_LICENSE file */
+
+/*
+ * Prints the performance counters of a running jx process (Linux builds
+ * configured --with-perfctr). The counter segment is read as it is, the
+ * process isn't interrupted.
+ *
+ *   jxcounters <pid> [-t]
+ *
+ * Prints "name value" lines, the sums of all the threads. -t prints the
+ * counters of every thread as well ("thread.<slot>.name value", slot 0 is
+ * for the threads without a jxcore threadId).
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "node_linux_perfctr_layout.h"
+
+static int open_segment(int pid) {
+  char path[320];
+  char link[256];
+  struct dirent *ent;
+  DIR *dir;
+  ssize_t n;
+  int fd = -1;
+
+  /* the memfd, /proc/<pid>/fd/<n> -> "/memfd:jxcore-counters (deleted)" */
+  snprintf(path, sizeof(path), "/proc/%d/fd", pid);
+  dir = opendir(path);
+  if (dir != NULL) {
+    while (fd == -1 && (ent = readdir(dir)) != NULL) {
+      if (ent->d_name[0] == '.') continue;
+      snprintf(path, sizeof(path), "/proc/%d/fd/%s", pid, ent->d_name);
+      n = readlink(path, link, sizeof(link) - 1);
+      if (n <= 0) continue;
+      link[n] = '\0';
+      if (strncmp(link, "/memfd:" JX_COUNTERS_NAME " ",
+                  sizeof("/memfd:" JX_COUNTERS_NAME)) == 0)
+        fd = open(path, O_RDONLY);
+    }
+    closedir(dir);
+  }
+
+  if (fd == -1) {
+    snprintf(path, sizeof(path), "/dev/shm/%s.%d", JX_COUNTERS_NAME, pid);
+    fd = open(path, O_RDONLY);
+  }
+  return fd;
+}
+
+int main(int argc, char **argv) {
+  const jx_counters_header *header;
+  const char *names;
+  const char *segment;
+  uint64_t *totals;
+  struct stat st;
+  int per_thread = 0;
+  int pid = 0;
+  int fd, i;
+  uint32_t slot, c;
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-t") == 0)
+      per_thread = 1;
+    else
+      pid = atoi(argv[i]);
+  }
+  if (pid <= 0) {
+    fprintf(stderr, "usage: %s <pid> [-t]\n", argv[0]);
+    return 2;
+  }
+
+  fd = open_segment(pid);
+  if (fd == -1) {
+    fprintf(stderr, "no counters for process %d: %s\n", pid, strerror(errno));
+    return 1;
+  }
+
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(*header)) {
+    fprintf(stderr, "counters of process %d aren't ready\n", pid);
+    return 1;
+  }
+
+  segment = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED) {
+    fprintf(stderr, "mmap: %s\n", strerror(errno));
+    return 1;
+  }
+
+  header = (const jx_counters_header *)segment;
+  if (header->magic != JX_COUNTERS_MAGIC) {
+    fprintf(stderr, "counters of process %d aren't ready\n", pid);
+    return 1;
+  }
+  __sync_synchronize();
+
+  if (header->version != JX_COUNTERS_VERSION ||
+      header->counter_count * (uint64_t)JX_COUNTERS_NAME_SIZE +
+              sizeof(*header) > header->header_size ||
+      header->counter_count * sizeof(uint64_t) > header->slot_size ||
+      header->header_size +
+              (uint64_t)header->slot_size * header->slot_count >
+          (uint64_t)st.st_size) {
+    fprintf(stderr, "unknown counter layout (version %u)\n",
+            header->version);
+    return 1;
+  }
+
+  names = segment + sizeof(*header);
+  totals = calloc(header->counter_count, sizeof(uint64_t));
+  if (totals == NULL) return 1;
+
+  /* the values are plain uint64_t, each slot is written by its thread */
+  for (slot = 0; slot < header->slot_count; slot++) {
+    const volatile uint64_t *values =
+        (const volatile uint64_t *)(segment + header->header_size +
+                                    (size_t)slot * header->slot_size);
+    for (c = 0; c < header->counter_count; c++) {
+      uint64_t value = values[c];
+      totals[c] += value;
+      if (per_thread && value != 0)
+        printf("thread.%u.%.*s %llu\n", slot, JX_COUNTERS_NAME_SIZE,
+               names + c * JX_COUNTERS_NAME_SIZE, (unsigned long long)value);
+    }
+  }
+
+  for (c = 0; c < header->counter_count; c++)
+    printf("%.*s %llu\n", JX_COUNTERS_NAME_SIZE,
+           names + c * JX_COUNTERS_NAME_SIZE, (unsigned long long)totals[c]);
+
+  /* the gauges are the differences of their counters */
+  if (header->counter_count > JX_COUNTER_TASKS_DEQUEUED) {
+    printf("server_conns %lld\n",
+           (long long)(totals[JX_COUNTER_SERVER_CONNS_OPENED] -
+                       totals[JX_COUNTER_SERVER_CONNS_CLOSED]));
+    printf("task_queue_depth %lld\n",
+           (long long)(totals[JX_COUNTER_TASKS_QUEUED] -
+                       totals[JX_COUNTER_TASKS_DEQUEUED]));
+  }
+  printf("start_time_ms %llu\n", (unsigned long long)header->start_time);
+
+  free(totals);
+  return 0;
+}